@@ -0,0 +1,102 @@
+#pragma once
+#include "InputEvent.hpp"
+#include "MappedFile.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+
+// Append-only session capture: a 64-byte header followed by fixed 32-byte records,
+// little-endian, one record per raw input event.
+namespace CaptureFormat {
+    constexpr char MAGIC[8] = {'M', 'B', 'C', 'A', 'P', 'T', 'R', '\0'};
+    constexpr std::uint32_t VERSION = 1;
+
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t recordSize;
+        std::uint64_t recordCount;      // Kept current on every append
+        std::int64_t createdUnixNs;     // Wall clock at creation, for bookkeeping only
+        std::uint8_t reserved[32];
+    };
+
+    struct Record {
+        std::int64_t timestampNs;
+        float x;
+        float y;
+        std::int32_t dx;
+        std::int32_t dy;
+        std::uint16_t deviceId;
+        std::uint8_t type;
+        std::uint8_t button;
+        std::uint8_t reserved[4];
+    };
+
+    static_assert(sizeof(Header) == 64, "capture header layout changed");
+    static_assert(sizeof(Record) == 32, "capture record layout changed");
+
+    Record toRecord(const InputEvent& event);
+    InputEvent toEvent(const Record& record);
+
+    // True if the file at path starts with the capture magic
+    bool isCaptureFile(const std::string& path);
+}
+
+// Writes records straight into a memory-mapped file that is pre-extended in large
+// steps, so appending from the capture thread is a store, not a write() call. A
+// helper thread allocates the blocks of the next step ahead of time, so growing
+// on the capture thread only moves the end of the file and remaps.
+class CaptureWriter {
+public:
+    explicit CaptureWriter(const std::string& path);
+    ~CaptureWriter();
+
+    CaptureWriter(const CaptureWriter&) = delete;
+    CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+    void append(const InputEvent& event);
+    // Trims the pre-extended tail; called by the destructor if needed
+    void close();
+
+    std::uint64_t getRecordCount() const { return recordCount; }
+
+private:
+    MappedFile file;
+    std::uint64_t recordCount{0};
+    std::uint64_t recordCapacity{0};
+    bool closed{false};
+
+    // Preallocation, off the capture thread
+    std::thread preallocator;
+    std::mutex preallocateMutex;
+    std::condition_variable preallocateWake;
+    std::uint64_t preallocateTo{0};     // Guarded by preallocateMutex
+    bool stopping{false};               // Guarded by preallocateMutex
+
+    CaptureFormat::Header* header() { return reinterpret_cast<CaptureFormat::Header*>(file.data()); }
+    CaptureFormat::Record* records() {
+        return reinterpret_cast<CaptureFormat::Record*>(file.data() + sizeof(CaptureFormat::Header));
+    }
+    void grow();
+    void requestPreallocation(std::uint64_t size);
+    void preallocateLoop();
+};
+
+// Maps a capture read-only and exposes its records without copying
+class CaptureReader {
+public:
+    explicit CaptureReader(const std::string& path);
+
+    std::span<const CaptureFormat::Record> getRecords() const { return records; }
+    const CaptureFormat::Header& getHeader() const {
+        return *reinterpret_cast<const CaptureFormat::Header*>(file.data());
+    }
+
+private:
+    MappedFile file;
+    std::span<const CaptureFormat::Record> records;
+};
@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#ifdef MOUSEBENCH_CLOCK_TSC
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#error "MOUSEBENCH_CLOCK_TSC requires an x86 target"
+#endif
+#endif
+
+// Monotonic nanosecond clock shared by input sources and frame timing. The
+// backend is chosen at compile time:
+//   default              QueryPerformanceCounter on Windows, CLOCK_MONOTONIC_RAW elsewhere
+//   MOUSEBENCH_CLOCK_TSC rdtsc scaled by a startup calibration against the OS clock,
+//                        falling back to the OS clock when the TSC isn't invariant
+// Reading the clock is stateless: callers keep their own previous timestamps.
+namespace Clock {
+    namespace Detail {
+        inline std::int64_t systemNowNs() {
+#ifdef _WIN32
+            static const std::int64_t frequency = [] {
+                LARGE_INTEGER value;
+                QueryPerformanceFrequency(&value);
+                return static_cast<std::int64_t>(value.QuadPart);
+            }();
+            LARGE_INTEGER counter;
+            QueryPerformanceCounter(&counter);
+            const std::int64_t seconds = counter.QuadPart / frequency;
+            const std::int64_t remainder = counter.QuadPart % frequency;
+            return seconds * 1000000000LL + remainder * 1000000000LL / frequency;
+#else
+            timespec now;
+            clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+            return static_cast<std::int64_t>(now.tv_sec) * 1000000000LL + now.tv_nsec;
+#endif
+        }
+
+#ifdef MOUSEBENCH_CLOCK_TSC
+        struct TscCalibration {
+            bool invariant{false};
+            std::uint64_t baseTicks{0};
+            std::int64_t baseNs{0};
+            double nsPerTick{0.0};
+        };
+
+        // Measured once, on first use
+        const TscCalibration& tscCalibration();
+#endif
+    }
+
+    inline std::int64_t nowNs() {
+#ifdef MOUSEBENCH_CLOCK_TSC
+        const auto& calibration = Detail::tscCalibration();
+        if (calibration.invariant) {
+            const std::uint64_t ticks = __rdtsc() - calibration.baseTicks;
+            return calibration.baseNs + static_cast<std::int64_t>(static_cast<double>(ticks) * calibration.nsPerTick);
+        }
+#endif
+        return Detail::systemNowNs();
+    }
+
+    inline double now() {
+        return static_cast<double>(nowNs()) * 1e-9;
+    }
+
+    // Human-readable backend for reports and diagnostics
+    const char* backendName();
+}
@@ -1,5 +1,6 @@
 #pragma once
-#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
 
 namespace Config {
     // Window settings
@@ -9,21 +10,84 @@ namespace Config {
 
     // Test settings
     constexpr size_t MAX_MEASUREMENTS = 1000;
-    constexpr size_t DISPLAY_POINTS = 100;
     constexpr size_t NUM_CLICK_TARGETS = 5;
     constexpr float TARGET_SIZE = 50.f;
 
-    // Colors
-    const sf::Color LATENCY_COLOR = sf::Color::Red;
-    const sf::Color POLLING_COLOR = sf::Color::Green;
-    const sf::Color MOVEMENT_COLOR = sf::Color::Blue;
-    const sf::Color TEXT_COLOR = sf::Color::White;
-    const sf::Color BACKGROUND_COLOR = sf::Color(30, 30, 30);
+    // Histogram settings (values recorded in microseconds)
+    constexpr std::int64_t HISTOGRAM_LOWEST_US = 1;
+    constexpr std::int64_t HISTOGRAM_HIGHEST_US = 10'000'000;
+    constexpr int HISTOGRAM_SIGNIFICANT_DIGITS = 3;
+
+    // Input capture settings
+    constexpr size_t INPUT_RING_CAPACITY = 1 << 16;
+    constexpr size_t INPUT_DRAIN_BATCH = 256;
+    constexpr std::int64_t SOURCE_MAX_SPIN_NS = 200'000;   // Paced sources share cores with the drain loop
+
+    // Capture file settings
+    constexpr std::uint64_t CAPTURE_GROW_BYTES = 64ull << 20;
+
+    // Export settings
+    constexpr size_t EXPORT_BLOCK_EVENTS = 8192;            // Events handed to the writer at once
+    constexpr size_t EXPORT_BLOCKS = 16;                    // Preallocated blocks, a power of two
+
+    // Live metrics publication
+    constexpr double PUBLISH_RATE = 100.0;                  // Hz; snapshots the frontend publishes to shared memory
+
+    // Pipeline self-instrumentation
+    constexpr size_t TRACE_BUFFER_SPANS = 1 << 14;          // Per thread, between collections; a power of two
+    constexpr size_t TRACE_RETAINED_SPANS = 1 << 19;        // Kept for a trace file, about 20 MB
+    constexpr std::int64_t TRACE_HIGHEST_NS = 10'000'000'000;
+
+    // Polling analysis settings
+    constexpr size_t POLLING_ANALYSIS_WINDOW = 1 << 17;     // Intervals, about 16 s at 8 kHz
+    constexpr double POLLING_BIN_US = 0.5;
+    constexpr double POLLING_MAX_INTERVAL_US = 16384.0;     // Slowest period considered (61 Hz)
+    constexpr int POLLING_IDLE_SLOTS = 16;                  // Longer gaps are the mouse at rest, not missed reports
+    constexpr double POLLING_ANALYSIS_RATE = 4.0;           // Re-analyses of the window per second, at most
+
+    // Motion analysis settings
+    constexpr size_t MOTION_BATCH = 256;                    // New samples analysed together; below MAX_MEASUREMENTS
+    constexpr int MOTION_FILTER_HALF_WIDTH = 5;             // Savitzky-Golay window of 2n+1 reports
+    constexpr double MOTION_GAP_MS = 20.0;                  // Longer pauses end a stroke
+    constexpr double MOTION_SPEED_BAND = 10.0;              // counts/ms per speed band
+    constexpr size_t MOTION_SPEED_BANDS = 64;
+
+    // Button timing settings
+    constexpr int MOUSE_BUTTONS = 5;
+    constexpr double BUTTON_DEBOUNCE_MS = 5.0;              // Release and re-press within this is contact bounce
+    constexpr double BUTTON_DOUBLE_CLICK_FAULT_MS = 30.0;   // Release-to-press gaps no deliberate double-click gets below
+    constexpr double BUTTON_MAX_PRESS_MS = 10'000.0;        // Longer holds are drags, not clicks
+    constexpr size_t RECENT_PRESSES = 64;                   // Raw presses kept for hit-testing
+
+    // Rollup history settings: raw reports, then buckets of each tier's width. The
+    // last tier merges pairs and doubles its width when full, so it never drops data.
+    constexpr size_t ROLLUP_RAW_SAMPLES = 1 << 16;                  // About 8 s at 8 kHz
+    constexpr std::int64_t ROLLUP_TIER_NS[] = {10'000'000, 1'000'000'000, 60'000'000'000};
+    constexpr size_t ROLLUP_TIER_BUCKETS[] = {1 << 14, 1 << 14, 1 << 11};  // 164 s, 4.5 h, 34 h before widening
+    constexpr size_t ROLLUP_BUCKETS_PER_COLUMN = 8;                 // Most entries a graph column is drawn from
+
+    // Offline analysis settings
+    constexpr size_t ANALYSIS_CHUNK_RECORDS = 1 << 20;
+
+    // Session comparison settings
+    constexpr size_t COMPARE_RESAMPLES = 2000;              // Bootstrap resamples per metric
+    constexpr size_t COMPARE_CHUNK_RESAMPLES = 50;          // Resamples per pool task
+    constexpr double COMPARE_CONFIDENCE = 0.95;
+    constexpr std::uint64_t COMPARE_SEED = 0x4D42'4341'4D50'0001;  // Fixed, so reruns agree
 
     // Graph settings
     constexpr float GRAPH_WIDTH = WINDOW_WIDTH / 2.5f;
     constexpr float GRAPH_HEIGHT = WINDOW_HEIGHT / 3.0f;
     constexpr float GRAPH_MARGIN = 50.f;
+    constexpr size_t DISPLAY_POINTS = static_cast<size_t>(GRAPH_WIDTH);  // One min/max column per pixel
+    constexpr size_t GRAPH_HISTORY_SAMPLES = 1 << 20;                   // Samples a graph spans at most
+    constexpr std::int64_t HISTORY_MIN_SPAN_NS = 1'000'000;             // Deepest zoom of the session history
+    constexpr std::int64_t HISTORY_WORST_SPAN_NS = 20'000'000;          // Context shown around the worst interval
+
+    // Frame pacing (rates in Hz; a frame rate of 0 renders unpaced)
+    constexpr double TARGET_FRAME_RATE = 240.0;
+    constexpr double STATS_TEXT_RATE = 10.0;
+    constexpr double GRAPH_UPDATE_RATE = 60.0;
 
     // Text settings
     constexpr unsigned int MENU_TEXT_SIZE = 24;
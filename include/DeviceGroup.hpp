@@ -0,0 +1,119 @@
+#pragma once
+#include "InputCapture.hpp"
+#include "Metrics.hpp"
+#include "PipelineTrace.hpp"
+#include "SampleExporter.hpp"
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+// One mouse: its own source, capture thread, ring and collector. Nothing here
+// is shared with other devices, so an event only ever touches its own device.
+struct CaptureDevice {
+    CaptureDevice(std::string name, std::unique_ptr<InputSource> source)
+        : name(std::move(name)), capture(std::move(source)) {}
+
+    std::string name;
+    InputCapture capture;
+    // The whole session, for the combined view, reports, publishing and comparisons
+    MetricsCollector metrics;
+
+    // Fed instead of metrics while the group's focus is on their test. Each is
+    // built the first time its test is focused, then kept with its samples.
+    std::unique_ptr<LatencyTestPipeline> latencyTest;
+    std::unique_ptr<PollingTestPipeline> pollingTest;
+    std::unique_ptr<MovementTestPipeline> movementTest;
+};
+
+// Which of each device's collectors the consumer feeds. A single-metric test
+// only pays for its own metric.
+enum class MetricFocus {
+    All,
+    Latency,
+    Polling,
+    Movement
+};
+
+// Calls visit with the device's collector for focus, which must have been
+// built (DeviceGroup does so for its own focus). The pipelines are different
+// types, so visit is generic; this one branch replaces any per-event dispatch.
+template<typename Device, typename Visit>
+decltype(auto) visitMetrics(Device& device, MetricFocus focus, Visit&& visit) {
+    if (focus == MetricFocus::Latency) return visit(*device.latencyTest);
+    if (focus == MetricFocus::Polling) return visit(*device.pollingTest);
+    if (focus == MetricFocus::Movement) return visit(*device.movementTest);
+    return visit(device.metrics);
+}
+
+// Events ingested but not yet on screen, for the frame stages of a PipelineTrace
+struct TraceBacklog {
+    std::int64_t originNs{std::numeric_limits<std::int64_t>::max()};
+    std::int64_t ingestedNs{0};     // When the oldest of them was
+    std::uint32_t events{0};
+};
+
+// Captures several mice concurrently. Each device runs its own capture thread
+// into its own SPSC ring; the consumer drains every ring into that device's
+// collector, so the per-event path takes no locks and devices never contend.
+class DeviceGroup {
+public:
+    // Devices are indexed in the order they are added
+    CaptureDevice& add(std::string name, std::unique_ptr<InputSource> source);
+
+    // Every mouse the platform can capture separately, each tagged with its
+    // index as deviceId. Windows raw input is registered once per process, so
+    // there it is a single combined device.
+    void addLiveDevices();
+
+    void start();
+    void stop();
+
+    // Drained events are also streamed here, tagged with the device index; not owned
+    void setExporter(SampleExporter* sampleExporter) { exporter = sampleExporter; }
+    SampleExporter* getExporter() const { return exporter; }
+    // Capture threads and drain() record their stages here; not owned, set before start()
+    void setTrace(PipelineTrace* pipelineTrace) {
+        trace = pipelineTrace;
+        consumerTrace = nullptr;
+    }
+
+    // Consumer thread only. drain() and update() work on the focused collectors;
+    // the others keep their samples until clear() empties them all.
+    void setFocus(MetricFocus metricFocus);
+    MetricFocus getFocus() const { return focus; }
+    // Returns the number of events drained
+    size_t drain();
+    // Also closes the finished clicks of devices reporting in real time
+    void update();
+    // Closes every open click, once the sources have stopped and been drained
+    void flush();
+    void clear();
+
+    // For consumers that pop the rings themselves: records the Dequeue and
+    // Metrics stages of a batch the device's collector has just ingested
+    void traceIngested(size_t index, std::span<const InputEvent> events, std::int64_t handledNs);
+    // Events ingested since the last call, for the frame that is about to show them
+    TraceBacklog takeTraceBacklog();
+
+    bool anyRunning() const;
+    // Every source waits for the consumer instead of dropping (replays, unpaced synthetic input)
+    bool allLossless() const;
+    std::uint64_t getDroppedEvents() const;
+
+    bool empty() const { return devices.empty(); }
+    size_t size() const { return devices.size(); }
+    CaptureDevice& operator[](size_t index) { return *devices[index]; }
+    const CaptureDevice& operator[](size_t index) const { return *devices[index]; }
+
+private:
+    // Stable addresses: capture threads hold pointers into their device
+    std::vector<std::unique_ptr<CaptureDevice>> devices;
+    SampleExporter* exporter{nullptr};
+    PipelineTrace* trace{nullptr};
+    TraceBuffer* consumerTrace{nullptr};
+    TraceBacklog backlog;
+    MetricFocus focus{MetricFocus::All};
+};
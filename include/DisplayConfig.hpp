@@ -0,0 +1,13 @@
+#pragma once
+#include "Config.hpp"
+#include <SFML/Graphics.hpp>
+
+// Settings that need SFML types; everything display-free lives in Config.hpp
+namespace Config {
+    // Colors
+    const sf::Color LATENCY_COLOR = sf::Color::Red;
+    const sf::Color POLLING_COLOR = sf::Color::Green;
+    const sf::Color MOVEMENT_COLOR = sf::Color::Blue;
+    const sf::Color TEXT_COLOR = sf::Color::White;
+    const sf::Color BACKGROUND_COLOR = sf::Color(30, 30, 30);
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include "InputSource.hpp"
+
+#ifdef __linux__
+#include <array>
+#include <string>
+#include <vector>
+#include <linux/input.h>
+
+// Reads struct input_event records from an evdev node or any file descriptor
+// (pipe, recorded dump). Reports are framed on SYN_REPORT and stamped with the
+// kernel's per-report time, so intervals carry no user-space scheduling noise.
+class EvdevInputSource : public InputSource {
+public:
+    explicit EvdevInputSource(std::string devicePath, std::uint16_t deviceId = 0);
+    // Does not take ownership of fd
+    explicit EvdevInputSource(int fd, std::uint16_t deviceId = 0);
+    ~EvdevInputSource() override;
+
+    bool open() override;
+    void close() override;
+    std::size_t read(InputEvent* out, std::size_t maxCount, int timeoutMs) override;
+    bool exhausted() const override { return endOfStream; }
+
+    // /dev/input/event* nodes that report relative X/Y motion and a left button
+    static std::vector<std::string> findMouseDevices();
+
+private:
+    static constexpr std::size_t READ_RECORDS = 64;
+    static constexpr std::size_t MAX_PENDING_BUTTONS = 8;
+
+    std::string devicePath;
+    int fd{-1};
+    bool ownsFd{false};
+    bool endOfStream{false};
+    std::uint16_t deviceId;
+
+    std::array<unsigned char, READ_RECORDS * sizeof(input_event)> buffer{};
+    std::size_t buffered{0};
+
+    // Current SYN_REPORT frame
+    std::int32_t frameDx{0};
+    std::int32_t frameDy{0};
+    std::array<InputEvent, MAX_PENDING_BUTTONS> pendingButtons{};
+    std::size_t pendingCount{0};
+    bool dropping{false};
+
+    // Integrated pointer position, clamped to the window
+    float x;
+    float y;
+
+    std::size_t decode(const input_event& raw, InputEvent* out);
+    std::size_t flushFrame(std::int64_t timestamp, InputEvent* out);
+};
+#endif
@@ -0,0 +1,49 @@
+#pragma once
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Bounded text buffer formatted with std::to_chars, for building display strings
+// without touching the heap. Output past the capacity is dropped.
+template<size_t Capacity>
+class FixedText {
+public:
+    FixedText& append(std::string_view text) {
+        const size_t n = std::min(text.size(), Capacity - length);
+        std::copy_n(text.data(), n, buffer + length);
+        length += n;
+        buffer[length] = '\0';
+        return *this;
+    }
+
+    FixedText& append(double value, int precision) {
+        return finish(std::to_chars(buffer + length, buffer + Capacity, value, std::chars_format::fixed, precision));
+    }
+
+    FixedText& append(std::int64_t value) {
+        return finish(std::to_chars(buffer + length, buffer + Capacity, value));
+    }
+
+    void clear() {
+        length = 0;
+        buffer[0] = '\0';
+    }
+
+    std::string_view view() const { return {buffer, length}; }
+    const char* c_str() const { return buffer; }
+    size_t size() const { return length; }
+
+    bool operator==(const FixedText& other) const { return view() == other.view(); }
+
+private:
+    char buffer[Capacity + 1]{};
+    size_t length{0};
+
+    FixedText& finish(std::to_chars_result result) {
+        if (result.ec == std::errc{}) length = static_cast<size_t>(result.ptr - buffer);
+        buffer[length] = '\0';
+        return *this;
+    }
+};
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+
+// Waits for a Clock deadline without burning a core: it sleeps until shortly
+// before the deadline, then spins the rest of the way. The spin window tracks how
+// late the OS actually wakes us, so it stays as short as the platform allows,
+// up to maxSpinWindowNs.
+class SpinWaiter {
+public:
+    static constexpr std::int64_t DEFAULT_MAX_SPIN_WINDOW_NS = 2'000'000;
+
+    explicit SpinWaiter(std::int64_t maxSpinWindowNs = DEFAULT_MAX_SPIN_WINDOW_NS);
+
+    // Blocks until deadlineNs and returns the time it woke in Clock ns
+    std::int64_t waitUntil(std::int64_t deadlineNs);
+
+    std::int64_t getSpinWindowNs() const { return spinWindowNs; }
+
+private:
+    std::int64_t maxSpinWindowNs;
+    std::int64_t spinWindowNs;
+};
+
+// Paces a render loop to a target rate with a SpinWaiter. A target of 0 leaves
+// the loop unpaced (e.g. when vsync paces it).
+class FrameScheduler {
+public:
+    explicit FrameScheduler(double targetRate);
+
+    void setTargetRate(double rate);
+    double getTargetRate() const { return targetRate; }
+
+    // Blocks until the next frame is due and returns its start time in Clock ns
+    std::int64_t waitForNextFrame();
+
+    std::int64_t getSpinWindowNs() const { return waiter.getSpinWindowNs(); }
+
+private:
+    double targetRate{0.0};
+    std::int64_t periodNs{0};
+    std::int64_t nextFrameNs{0};
+    SpinWaiter waiter;
+};
+
+// Fires at most rate times per second on the caller's clock, for work that can
+// run slower than the frame rate (text, graphs)
+class Cadence {
+public:
+    explicit Cadence(double rate)
+        : periodNs(rate > 0.0 ? static_cast<std::int64_t>(1e9 / rate) : 0) {}
+
+    bool due(std::int64_t nowNs) {
+        if (nowNs - lastNs < periodNs) return false;
+        lastNs = nowNs;
+        return true;
+    }
+
+private:
+    std::int64_t periodNs;
+    std::int64_t lastNs{INT64_MIN / 2};
+};
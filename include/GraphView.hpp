@@ -0,0 +1,40 @@
+#pragma once
+#include "MinMaxEnvelope.hpp"
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Retained-mode graph of a MinMaxEnvelope. Each column draws the range between
+// its min and max over a dimmer fill down to the baseline, so isolated spikes stay
+// visible however long the history. Vertices live in a persistent buffer that is
+// only rewritten when the envelope or the scale changed, so the cost per frame is
+// bounded by the column count, not by the number of samples.
+class GraphView : public sf::Drawable, public sf::Transformable {
+public:
+    // A fixedMax of 0 scales the graph to the largest value shown
+    GraphView(const sf::Vector2f& size, const sf::Color& color, float fixedMax = 0.f);
+
+    void update(const MinMaxEnvelope& envelope);
+    // Columns spread over the full width, as rendered from a RollupHistory;
+    // columns with min > max hold no samples and are left blank
+    void update(std::span<const MinMaxEnvelope::Column> columns);
+
+private:
+    sf::Vector2f size;
+    sf::Color color;
+    sf::Color fillColor;
+    float fixedMax;
+
+    std::vector<sf::Vertex> vertices;
+    sf::VertexBuffer buffer;
+    bool useBuffer;
+    size_t vertexCount{0};
+
+    std::uint64_t drawnVersion{UINT64_MAX};
+    const MinMaxEnvelope* drawnEnvelope{nullptr};
+
+    template<typename Columns>
+    void rebuild(const Columns& columns, size_t count, size_t capacity);
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+};
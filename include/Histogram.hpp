@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+struct PercentileSummary {
+    std::int64_t p50{0};
+    std::int64_t p90{0};
+    std::int64_t p99{0};
+    std::int64_t p999{0};
+    std::int64_t max{0};
+};
+
+// Log-bucketed histogram in the style of HdrHistogram. Values are integers in a
+// caller-chosen unit (the collector uses microseconds). Storage is allocated once
+// in the constructor; record() is O(1) and never allocates. Every recorded value
+// is reproduced to within the requested number of significant decimal digits.
+class Histogram {
+public:
+    Histogram(std::int64_t lowestDiscernibleValue, std::int64_t highestTrackableValue, int significantDigits);
+
+    void record(std::int64_t value) { recordCount(value, 1); }
+    void recordCount(std::int64_t value, std::uint64_t count);
+
+    // Merge another histogram (e.g. from another thread or session) into this one
+    void add(const Histogram& other);
+    void clear();
+
+    std::uint64_t getTotalCount() const { return totalCount; }
+    std::int64_t getMin() const;
+    std::int64_t getMax() const;
+    double getMean() const;
+
+    std::int64_t valueAtPercentile(double percentile) const;
+    // One pass over the buckets; percentiles must be ascending
+    void valuesAtPercentiles(const double* percentiles, std::int64_t* values, size_t count) const;
+    PercentileSummary summarize() const;
+
+    // Populated buckets in ascending order: each bucket's value as percentiles
+    // report it, and its count
+    void getDistribution(std::vector<std::int64_t>& values, std::vector<std::uint64_t>& bucketCounts) const;
+
+    // Percentile distribution table (value, percentile, total count), one row per
+    // populated bucket; values are multiplied by unitScale
+    void writePercentileDistribution(std::ostream& out, double unitScale = 1.0) const;
+
+    std::int64_t getLowestDiscernibleValue() const { return lowestDiscernibleValue; }
+    std::int64_t getHighestTrackableValue() const { return highestTrackableValue; }
+    int getSignificantDigits() const { return significantDigits; }
+
+private:
+    std::int64_t lowestDiscernibleValue;
+    std::int64_t highestTrackableValue;
+    int significantDigits;
+
+    int unitMagnitude;
+    int subBucketHalfCountMagnitude;
+    std::int32_t subBucketCount;
+    std::int32_t subBucketHalfCount;
+    std::int64_t subBucketMask;
+    std::int32_t bucketCount;
+
+    std::vector<std::uint64_t> counts;
+    std::uint64_t totalCount{0};
+    std::int64_t minValue;
+    std::int64_t maxValue{0};
+
+    size_t countsIndexFor(std::int64_t value) const;
+    std::int64_t valueFromIndex(size_t index) const;
+    std::int64_t highestEquivalentValue(std::int64_t value) const;
+    std::int64_t lowestEquivalentValue(std::int64_t value) const;
+    bool sameLayout(const Histogram& other) const;
+};
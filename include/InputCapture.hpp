@@ -0,0 +1,54 @@
+#pragma once
+#include "InputEvent.hpp"
+#include "InputSource.hpp"
+#include "CaptureFile.hpp"
+#include "PipelineTrace.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+// Owns the high-priority capture thread. Every report from the input source is
+// timestamped on arrival and pushed into the ring; the render thread drains it once per frame.
+class InputCapture {
+public:
+    // Uses the platform's default live source
+    InputCapture();
+    explicit InputCapture(std::unique_ptr<InputSource> source);
+    ~InputCapture();
+
+    InputCapture(const InputCapture&) = delete;
+    InputCapture& operator=(const InputCapture&) = delete;
+
+    // Persists every captured event from the capture thread; set before start()
+    void setRecorder(std::unique_ptr<CaptureWriter> writer);
+    // Records each read as a Report to Read span tagged with device; not owned, set before start()
+    void setTrace(PipelineTrace* pipelineTrace, std::uint8_t device);
+
+    void start();
+    void stop();
+    // Asks the thread to finish without waiting for it; stop() still joins
+    void requestStop() { running.store(false, std::memory_order_release); }
+
+    bool isRunning() const { return running.load(std::memory_order_acquire); }
+    bool lossless() const { return source && source->lossless(); }
+    InputRing& getRing() { return ring; }
+    std::uint64_t getDroppedEvents() const { return droppedEvents.load(std::memory_order_relaxed); }
+    bool recordingFailed() const { return recorderFailed.load(std::memory_order_relaxed); }
+    bool sharesClock() const { return source && source->sharesClock(); }
+
+private:
+    std::unique_ptr<InputSource> source;
+    std::unique_ptr<CaptureWriter> recorder;
+    PipelineTrace* trace{nullptr};
+    std::uint8_t traceDevice{0};
+    InputRing ring;
+    std::thread thread;
+    std::atomic<bool> running{false};
+    std::atomic<std::uint64_t> droppedEvents{0};
+    std::atomic<bool> recorderFailed{false};
+
+    void captureLoop();
+    void publish(const InputEvent& event);
+    void record(const InputEvent& event);
+};
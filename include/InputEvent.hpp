@@ -0,0 +1,25 @@
+#pragma once
+#include "Config.hpp"
+#include "SpscRing.hpp"
+#include <cstdint>
+
+enum class InputEventType : std::uint8_t {
+    Move,
+    ButtonPress,
+    ButtonRelease
+};
+
+// One timestamped mouse report as seen by the capture thread.
+struct InputEvent {
+    std::int64_t timestampNs;   // Capture clock, nanoseconds
+    float x;                    // Pointer position in window pixels
+    float y;
+    std::int32_t dx;            // Raw relative motion in device counts
+    std::int32_t dy;
+    std::uint16_t deviceId;
+    InputEventType type;
+    std::uint8_t button;
+    std::int64_t receivedNs;    // Clock time the capture thread read it; 0 when unknown (captures)
+};
+
+using InputRing = SpscRing<InputEvent, Config::INPUT_RING_CAPACITY>;
@@ -0,0 +1,32 @@
+#pragma once
+#include "InputEvent.hpp"
+#include <cstddef>
+#include <memory>
+
+// A backend that produces timestamped mouse reports for the capture thread.
+// open(), read() and close() are always called from the capture thread.
+class InputSource {
+public:
+    virtual ~InputSource() = default;
+
+    virtual bool open() = 0;
+    virtual void close() = 0;
+
+    // Waits up to timeoutMs for input and decodes at most maxCount events into out.
+    // maxCount must be at least Config::INPUT_DRAIN_BATCH.
+    virtual std::size_t read(InputEvent* out, std::size_t maxCount, int timeoutMs) = 0;
+
+    // True once a finite source (file, pipe) has no more data.
+    virtual bool exhausted() const { return false; }
+
+    // Lossless sources (replays) make the capture thread wait for ring space
+    // instead of dropping events when the consumer falls behind.
+    virtual bool lossless() const { return false; }
+
+    // True when reports are stamped with Clock::nowNs(), so they can be set
+    // against the capture thread's receipt time.
+    virtual bool sharesClock() const { return false; }
+};
+
+// The platform's preferred live source, or nullptr if no mouse is available.
+std::unique_ptr<InputSource> createDefaultInputSource();
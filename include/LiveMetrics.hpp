@@ -0,0 +1,186 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <type_traits>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+// Live statistics published to a named shared-memory segment for dashboards and
+// test harnesses on the same machine. The segment is a header followed by one
+// Snapshot behind a seqlock: the single writer bumps the sequence to odd, stores
+// the snapshot and bumps it to even, so it never waits for readers; readers copy
+// the snapshot and retry if the sequence moved or was odd. Every field is 8 bytes
+// wide and copied as relaxed atomic words, so torn reads are detected rather
+// than racy. Layout is native-endian and fixed per VERSION.
+namespace LiveMetricsFormat {
+    constexpr char MAGIC[8] = {'M', 'B', 'L', 'I', 'V', 'E', '\0', '\0'};
+    constexpr std::uint32_t VERSION = 1;
+    constexpr size_t MAX_DEVICES = 16;
+    constexpr size_t NAME_BYTES = 32;
+    constexpr const char* DEFAULT_NAME = "mousebench";
+
+    // Microseconds, as in PercentileSummary
+    struct Percentiles {
+        std::int64_t p50;
+        std::int64_t p90;
+        std::int64_t p99;
+        std::int64_t p999;
+        std::int64_t max;
+    };
+
+    struct Device {
+        char name[NAME_BYTES];      // Truncated, always NUL-terminated
+
+        // Counters since the session started
+        std::uint64_t intervals;
+        std::uint64_t latencySamples;
+        std::uint64_t clicks;
+        std::uint64_t chatter;
+        std::uint64_t doubleClicks;
+        std::uint64_t droppedEvents;    // Lost to a full capture ring
+
+        // Recent window
+        double latencyCurrentMs;
+        double latencyAverageMs;
+        double latencyMinMs;
+        double latencyMaxMs;
+        double latencyStdDevMs;
+        double pollingCurrentHz;
+        double pollingAverageHz;
+        double pollingStdDevHz;
+        double speedCurrent;            // counts/ms
+        double speedAverage;
+
+        // Polling analysis over the long interval window
+        double nominalHz;
+        double fittedHz;
+        double missedFraction;
+        double duplicateFraction;
+        double jitterUs;
+
+        // Whole session
+        Percentiles latencyUs;
+        Percentiles intervalUs;
+        Percentiles pressDurationUs;
+        double worstIntervalUs;
+        double worstLatencyUs;
+    };
+
+    struct Snapshot {
+        std::int64_t publishedUnixNs;   // Wall clock, comparable across processes
+        std::uint64_t publishCount;
+        std::uint64_t deviceCount;
+        Device devices[MAX_DEVICES];
+    };
+
+    struct Segment {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t snapshotBytes;
+        std::uint64_t sequence;         // Odd while the writer is storing; use std::atomic_ref
+        std::uint64_t words[sizeof(Snapshot) / sizeof(std::uint64_t)];
+    };
+
+    static_assert(std::is_trivially_copyable_v<Snapshot>, "snapshots are copied as words");
+    static_assert(sizeof(Device) % sizeof(std::uint64_t) == 0, "device records are whole words");
+    static_assert(sizeof(Snapshot) % sizeof(std::uint64_t) == 0, "snapshots are whole words");
+    static_assert(sizeof(Segment) == 24 + sizeof(Snapshot), "segment layout changed");
+
+    // Writer side: wait-free, one writer per segment. Only the first `bytes` of
+    // the snapshot are stored; the rest keep their previous contents.
+    inline void store(Segment& segment, const Snapshot& snapshot, size_t bytes = sizeof(Snapshot)) {
+        std::atomic_ref<std::uint64_t> sequence(segment.sequence);
+        const std::uint64_t start = sequence.load(std::memory_order_relaxed);
+        sequence.store(start + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        const auto* source = reinterpret_cast<const unsigned char*>(&snapshot);
+        const size_t words = (bytes + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+        for (size_t i = 0; i < words; ++i) {
+            std::uint64_t word;
+            std::memcpy(&word, source + i * sizeof(word), sizeof(word));
+            std::atomic_ref<std::uint64_t>(segment.words[i]).store(word, std::memory_order_relaxed);
+        }
+
+        sequence.store(start + 2, std::memory_order_release);
+    }
+
+    // Reader side: false if every attempt overlapped a store. The segment is
+    // only read, even though atomic_ref needs it non-const.
+    inline bool load(Segment& segment, Snapshot& snapshot, int attempts, std::uint64_t* retries = nullptr) {
+        std::atomic_ref<std::uint64_t> sequence(segment.sequence);
+        auto* target = reinterpret_cast<unsigned char*>(&snapshot);
+        for (int attempt = 0; attempt < attempts; ++attempt) {
+            const std::uint64_t before = sequence.load(std::memory_order_acquire);
+            if (before % 2 == 0) {
+                for (size_t i = 0; i < std::size(segment.words); ++i) {
+                    const std::uint64_t word =
+                        std::atomic_ref<std::uint64_t>(segment.words[i]).load(std::memory_order_relaxed);
+                    std::memcpy(target + i * sizeof(word), &word, sizeof(word));
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequence.load(std::memory_order_relaxed) == before) return true;
+            }
+            if (retries) ++*retries;
+        }
+        return false;
+    }
+}
+
+// A named shared-memory mapping: POSIX shm_open, or a pagefile-backed file
+// mapping on Windows. The constructor throws std::runtime_error on failure.
+class SharedSegment {
+public:
+    enum class Mode {
+        Read,
+        Create      // Replaces a segment of the same name; removed again on destruction (POSIX)
+    };
+
+    SharedSegment(const std::string& name, Mode mode, size_t size);
+    ~SharedSegment();
+
+    SharedSegment(const SharedSegment&) = delete;
+    SharedSegment& operator=(const SharedSegment&) = delete;
+
+    void* data() const { return base; }
+    size_t size() const { return length; }
+
+private:
+    std::string name;
+    Mode mode;
+    void* base{nullptr};
+    size_t length{0};
+
+#ifdef _WIN32
+    HANDLE mapping{nullptr};
+#endif
+};
+
+// Polls a published segment; safe to call at kHz rates from any process
+class MetricsReader {
+public:
+    // Throws std::runtime_error if no tool is publishing under that name or the
+    // layout differs from this build's
+    explicit MetricsReader(const std::string& name = LiveMetricsFormat::DEFAULT_NAME);
+
+    // The latest snapshot; false if the writer kept it busy for every retry
+    bool read(LiveMetricsFormat::Snapshot& snapshot);
+
+    std::uint64_t getReads() const { return reads; }
+    std::uint64_t getRetries() const { return retries; }
+
+private:
+    SharedSegment segment;
+    LiveMetricsFormat::Segment* layout;
+    std::uint64_t reads{0};
+    std::uint64_t retries{0};
+};
+
+// Prometheus text exposition (format 0.0.4) of a snapshot
+std::string formatPrometheus(const LiveMetricsFormat::Snapshot& snapshot);
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+// A whole file mapped into memory. Writable mappings can be grown in place
+// (the base address may move); the constructor throws std::runtime_error on failure.
+class MappedFile {
+public:
+    enum class Mode {
+        Read,
+        Create
+    };
+
+    // Create truncates/creates the file and sizes it to initialSize bytes
+    MappedFile(const std::string& path, Mode mode, std::uint64_t initialSize = 0);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Grows or shrinks the file and its mapping; on Linux the mapping is remapped, not rebuilt
+    void resize(std::uint64_t newSize);
+    // Allocates disk blocks for [offset, offset + bytes) without changing the size or the
+    // mapping, so a later resize() into it allocates nothing. Safe to call from another
+    // thread than resize(); returns false where the filesystem cannot.
+    bool preallocate(std::uint64_t offset, std::uint64_t bytes);
+    // Unmaps and trims the file to finalSize bytes
+    void close(std::uint64_t finalSize);
+
+    unsigned char* data() { return base; }
+    const unsigned char* data() const { return base; }
+    std::uint64_t size() const { return length; }
+
+private:
+    std::string path;
+    Mode mode;
+    unsigned char* base{nullptr};
+    std::uint64_t length{0};
+
+#ifdef _WIN32
+    HANDLE file{INVALID_HANDLE_VALUE};
+    HANDLE mapping{nullptr};
+#else
+    int fd{-1};
+#endif
+
+    void map();
+    void unmap();
+};
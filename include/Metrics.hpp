@@ -1,66 +1,311 @@
 #pragma once
-#include <SFML/Graphics.hpp>
-#include <deque>
+#include "InputEvent.hpp"
+#include "SampleDeriver.hpp"
+#include "RollingStats.hpp"
+#include "Histogram.hpp"
+#include "Config.hpp"
+#include "SoaRing.hpp"
+#include "MinMaxEnvelope.hpp"
+#include "RollupHistory.hpp"
+#include "PollingAnalyzer.hpp"
+#include "MotionAnalyzer.hpp"
+#include <cstdint>
+#include <span>
+#include <type_traits>
 
-struct LatencyData {
-    double timestamp;
-    double latency;
-};
+// Column layouts of the sample windows
+namespace LatencyColumn {
+    enum : size_t { Timestamp, Latency };
+}
 
-struct PollingData {
-    double timestamp;
-    double interval;
-    sf::Vector2f position;
-};
+namespace PollingColumn {
+    enum : size_t { Timestamp, Interval, Rate, X, Y };
+}
 
-struct MovementData {
-    double timestamp;
-    sf::Vector2f position;
-    float velocity;
-};
+namespace MovementColumn {
+    enum : size_t { Timestamp, X, Y, Velocity, DeltaX, DeltaY };
+}
+
+namespace PressColumn {
+    enum : size_t { Timestamp, Received, X, Y, Button };
+}
+
+using LatencySamples = SoaRing<double, float>;
+using PollingSamples = SoaRing<double, float, float, float, float>;
+using MovementSamples = SoaRing<double, float, float, float, float, float>;
+using PressSamples = SoaRing<double, std::int64_t, float, float, std::uint8_t>;
 
-class MetricsCollector {
+// Stages of a MetricPipeline. Each keeps one metric's state and takes the
+// derived samples it needs through hooks: onLatency, onInterval, onMovement,
+// onPress (every click, duration unfiltered), onButtonFault and onEvent (raw
+// events). update() refreshes window statistics and percentiles.
+
+// Click latency window, its statistics and its session distribution
+class LatencyStage {
 public:
-    void addLatencyMeasurement(double timestamp, double latency);
-    void addPollingMeasurement(double timestamp, double interval, const sf::Vector2f& position);
-    void addMovementMeasurement(double timestamp, const sf::Vector2f& position, float velocity);
-    
-    void clear();
+    void onLatency(double timestamp, double latency);
     void update();
+    void clear();
 
-    // Getters
     double getCurrentLatency() const { return currentLatency; }
     double getAverageLatency() const { return averageLatency; }
     double getMinLatency() const { return minLatency; }
     double getMaxLatency() const { return maxLatency; }
-    
-    double getCurrentPollingRate() const { return currentPollingRate; }
-    double getAveragePollingRate() const { return averagePollingRate; }
-    
-    float getCurrentMovementSpeed() const { return currentMovementSpeed; }
-    float getAverageMovementSpeed() const { return averageMovementSpeed; }
+    double getLatencyStdDev() const { return latencyStdDev; }
+
+    // Session-wide, in microseconds
+    const Histogram& getLatencyHistogram() const { return latencyHistogram; }
+    const PercentileSummary& getLatencyPercentiles() const { return latencyPercentiles; }
+    const RollupHistory& getLatencyHistory() const { return latencyHistory; }
 
-    const std::deque<LatencyData>& getLatencyData() const { return latencyMeasurements; }
-    const std::deque<PollingData>& getPollingData() const { return pollingMeasurements; }
-    const std::deque<MovementData>& getMovementData() const { return movementMeasurements; }
+    const LatencySamples& getLatencySamples() const { return latencySamples; }
+    const MinMaxEnvelope& getLatencyEnvelope() const { return latencyEnvelope; }
 
 private:
-    std::deque<LatencyData> latencyMeasurements;
-    std::deque<PollingData> pollingMeasurements;
-    std::deque<MovementData> movementMeasurements;
+    LatencySamples latencySamples{Config::MAX_MEASUREMENTS};
+    RollingStats latencyStats{Config::MAX_MEASUREMENTS};
+    MinMaxEnvelope latencyEnvelope{Config::DISPLAY_POINTS, Config::GRAPH_HISTORY_SAMPLES};
+    RollupHistory latencyHistory;
+    Histogram latencyHistogram{Config::HISTOGRAM_LOWEST_US, Config::HISTOGRAM_HIGHEST_US, Config::HISTOGRAM_SIGNIFICANT_DIGITS};
+    PercentileSummary latencyPercentiles;
+    std::uint64_t latencyPercentilesCount{0};
 
     double currentLatency{0.0};
     double averageLatency{0.0};
-    double minLatency{999999.0};
+    double minLatency{0.0};
     double maxLatency{0.0};
-    
+    double latencyStdDev{0.0};
+};
+
+// Polling rate over the recent window: the cheap part of the polling test
+class PollingStage {
+public:
+    void onInterval(double timestamp, double interval, float x, float y);
+    void update();
+    void clear();
+
+    double getCurrentPollingRate() const { return currentPollingRate; }
+    double getAveragePollingRate() const { return averagePollingRate; }
+    double getPollingRateStdDev() const { return pollingRateStdDev; }
+
+    const PollingSamples& getPollingSamples() const { return pollingSamples; }
+    const MinMaxEnvelope& getPollingRateEnvelope() const { return pollingRateEnvelope; }
+
+private:
+    PollingSamples pollingSamples{Config::MAX_MEASUREMENTS};
+    RollingStats pollingRateStats{Config::MAX_MEASUREMENTS};
+    MinMaxEnvelope pollingRateEnvelope{Config::DISPLAY_POINTS, Config::GRAPH_HISTORY_SAMPLES};
+
     double currentPollingRate{0.0};
     double averagePollingRate{0.0};
-    
-    float currentMovementSpeed{0.0};
-    float averageMovementSpeed{0.0};
+    double pollingRateStdDev{0.0};
+};
+
+// Whole-session report intervals: histogram, rollup history and the period estimate
+class IntervalHistogramStage {
+public:
+    void onInterval(double timestamp, double interval, float x, float y);
+    void update();
+    void onEndOfStream();
+    void clear();
+
+    // Microseconds
+    const Histogram& getIntervalHistogram() const { return intervalHistogram; }
+    const PercentileSummary& getIntervalPercentiles() const { return intervalPercentiles; }
+    const RollupHistory& getIntervalHistory() const { return intervalHistory; }
+
+    // Period, missed/duplicate reports and jitter over a long interval window; refreshed
+    // at most POLLING_ANALYSIS_RATE times a second, and at the end of the stream
+    const PollingEstimate& getPollingEstimate() const { return pollingAnalyzer.getEstimate(); }
+
+private:
+    Histogram intervalHistogram{Config::HISTOGRAM_LOWEST_US, Config::HISTOGRAM_HIGHEST_US, Config::HISTOGRAM_SIGNIFICANT_DIGITS};
+    RollupHistory intervalHistory;
+    PollingAnalyzer pollingAnalyzer;
+    PercentileSummary intervalPercentiles;
+    std::uint64_t intervalPercentilesCount{0};
+    std::uint64_t pollingAnalyzedCount{0};
+    std::int64_t nextPollingAnalysisNs{0};
+
+    void analyzePolling();
+};
+
+// Movement speed window and the motion analysis over it
+class MovementStage {
+public:
+    void onMovement(double timestamp, float x, float y, float velocity, std::int32_t dx, std::int32_t dy);
+    void update();
+    void clear();
 
-    void updateLatencyStats();
-    void updatePollingStats();
-    void updateMovementStats();
+    float getCurrentMovementSpeed() const { return currentMovementSpeed; }
+    float getAverageMovementSpeed() const { return averageMovementSpeed; }
+
+    // Filtered speed and acceleration, path quality and tracking limits
+    const MotionSummary& getMotionSummary() const { return motionAnalyzer.getSummary(); }
+    const MotionAnalyzer& getMotionAnalyzer() const { return motionAnalyzer; }
+
+    const MovementSamples& getMovementSamples() const { return movementSamples; }
+    const MinMaxEnvelope& getMovementEnvelope() const { return movementEnvelope; }
+
+private:
+    MovementSamples movementSamples{Config::MAX_MEASUREMENTS};
+    RollingStats movementStats{Config::MAX_MEASUREMENTS};
+    MinMaxEnvelope movementEnvelope{Config::DISPLAY_POINTS, Config::GRAPH_HISTORY_SAMPLES};
+    MotionAnalyzer motionAnalyzer;
+    size_t pendingMotionSamples{0};     // Newest movement samples not yet analysed
+
+    float currentMovementSpeed{0.0f};
+    float averageMovementSpeed{0.0f};
+
+    void analyzeMotion();
+};
+
+// Clicks, switch faults, press durations and the latest raw presses
+class ButtonStage {
+public:
+    void onEvent(const InputEvent& event);
+    void onPress(double timestamp, std::uint8_t button, double duration);
+    void onButtonFault(double timestamp, std::uint8_t button, ButtonFault fault);
+    void update();
+    void clear();
+
+    // Click count, contact bounce and double-click faults
+    const ButtonCounts& getButtonCounts() const { return buttonCounts; }
+    double getCurrentPressDuration() const { return currentPressDuration; }
+
+    // Session-wide, in microseconds
+    const Histogram& getPressDurationHistogram() const { return pressDurationHistogram; }
+    const PercentileSummary& getPressDurationPercentiles() const { return pressDurationPercentiles; }
+
+    // The latest raw presses, newest last; getPressCount() counts every one
+    // ever ingested so callers can tell which are new
+    const PressSamples& getRecentPresses() const { return recentPresses; }
+    std::uint64_t getPressCount() const { return pressCount; }
+
+private:
+    PressSamples recentPresses{Config::RECENT_PRESSES};
+    std::uint64_t pressCount{0};
+    Histogram pressDurationHistogram{Config::HISTOGRAM_LOWEST_US, Config::HISTOGRAM_HIGHEST_US, Config::HISTOGRAM_SIGNIFICANT_DIGITS};
+    PercentileSummary pressDurationPercentiles;
+    std::uint64_t pressDurationPercentilesCount{0};
+    ButtonCounts buttonCounts;
+    double currentPressDuration{0.0};
+};
+
+template<typename Stage>
+concept LatencyStageOf = requires(Stage& stage) { stage.onLatency(0.0, 0.0); };
+template<typename Stage>
+concept IntervalStageOf = requires(Stage& stage) { stage.onInterval(0.0, 0.0, 0.0f, 0.0f); };
+template<typename Stage>
+concept MovementStageOf = requires(Stage& stage) { stage.onMovement(0.0, 0.0f, 0.0f, 0.0f, 0, 0); };
+template<typename Stage>
+concept PressStageOf = requires(Stage& stage) { stage.onPress(0.0, std::uint8_t{0}, 0.0); };
+template<typename Stage>
+concept ButtonFaultStageOf = requires(Stage& stage) { stage.onButtonFault(0.0, std::uint8_t{0}, ButtonFault::Chatter); };
+template<typename Stage>
+concept EventStageOf = requires(Stage& stage, const InputEvent& event) { stage.onEvent(event); };
+template<typename Stage>
+concept EndOfStreamStageOf = requires(Stage& stage) { stage.onEndOfStream(); };
+
+// Clock::nowNs() for drained batches, out of line to keep the platform clock out of this header
+std::int64_t drainHandlingNs();
+
+// A collector composed at compile time of only the stages it names. As a
+// SampleDeriver sink it declares only the measurements some stage takes, so
+// the deriver never derives the rest, and every hook is a direct call: a
+// pipeline of PollingStage alone costs an interval and a window push per
+// report. A stage's getters are the pipeline's.
+template<typename... Stages>
+class MetricPipeline : public Stages... {
+public:
+    template<typename Stage>
+    static constexpr bool HAS_STAGE = (std::is_same_v<Stage, Stages> || ...);
+
+    void addLatencyMeasurement(double timestamp, double latency) requires (LatencyStageOf<Stages> || ...) {
+        if (!SampleFilter::validLatency(latency)) return; // Filter unrealistic values
+        ([&] { if constexpr (LatencyStageOf<Stages>) Stages::onLatency(timestamp, latency); }(), ...);
+    }
+
+    void addPollingMeasurement(double timestamp, double interval, float x, float y)
+        requires (IntervalStageOf<Stages> || ...) {
+        if (!SampleFilter::validInterval(interval)) return;
+        ([&] { if constexpr (IntervalStageOf<Stages>) Stages::onInterval(timestamp, interval, x, y); }(), ...);
+    }
+
+    void addMovementMeasurement(double timestamp, float x, float y, float velocity, std::int32_t dx, std::int32_t dy)
+        requires (MovementStageOf<Stages> || ...) {
+        ([&] {
+            if constexpr (MovementStageOf<Stages>) Stages::onMovement(timestamp, x, y, velocity, dx, dy);
+        }(), ...);
+    }
+
+    void addPressMeasurement(double timestamp, std::uint8_t button, double duration)
+        requires (PressStageOf<Stages> || ...) {
+        ([&] { if constexpr (PressStageOf<Stages>) Stages::onPress(timestamp, button, duration); }(), ...);
+    }
+
+    void addButtonFault(double timestamp, std::uint8_t button, ButtonFault fault)
+        requires (ButtonFaultStageOf<Stages> || ...) {
+        ([&] { if constexpr (ButtonFaultStageOf<Stages>) Stages::onButtonFault(timestamp, button, fault); }(), ...);
+    }
+
+    // Input ingestion; latency is only measured for events handled with a handling time.
+    // drain() returns the number of events it took off the ring.
+    size_t drain(InputRing& ring) {
+        InputEvent batch[Config::INPUT_DRAIN_BATCH];
+        size_t count;
+        size_t drained = 0;
+        while ((count = ring.popBatch(batch, Config::INPUT_DRAIN_BATCH)) > 0) {
+            ingest(std::span<const InputEvent>(batch, count), drainHandlingNs());
+            drained += count;
+        }
+        return drained;
+    }
+
+    void ingest(const InputEvent& event, std::int64_t handledNs = 0) {
+        ([&] { if constexpr (EventStageOf<Stages>) Stages::onEvent(event); }(), ...);
+        deriver.process(event, *this, handledNs);
+    }
+
+    void ingest(std::span<const InputEvent> events, std::int64_t handledNs = 0) {
+        for (const InputEvent& event : events) ingest(event, handledNs);
+    }
+
+    // Closes clicks no later event will; see SampleDeriver::flush(). At the end of
+    // the stream, stages also finish the work update() throttles.
+    void flush(std::int64_t nowNs) {
+        deriver.flush(nowNs, *this);
+        if (nowNs != SampleDeriver::END_OF_STREAM) return;
+        ([&] { if constexpr (EndOfStreamStageOf<Stages>) Stages::onEndOfStream(); }(), ...);
+    }
+
+    // Before the consumer stops feeding this pipeline for a while: closes the
+    // clicks already released and forgets the stream, so the gap does not
+    // become one long interval once feeding resumes
+    void pause() {
+        deriver.flush(SampleDeriver::END_OF_STREAM, *this);
+        deriver.reset();
+    }
+
+    void clear() {
+        (Stages::clear(), ...);
+        deriver.reset();
+    }
+
+    void update() { (Stages::update(), ...); }
+
+private:
+    // Per-stream state for deriving intervals from event timestamps
+    SampleDeriver deriver;
 };
+
+// Everything, for the combined view, reports, publishing and comparisons
+using MetricsCollector = MetricPipeline<LatencyStage, PollingStage, IntervalHistogramStage, MovementStage, ButtonStage>;
+
+// The single-metric tests: latency needs the presses it is measured on, and
+// the polling test's history and estimate need the session intervals
+using LatencyTestPipeline = MetricPipeline<LatencyStage, ButtonStage>;
+using PollingTestPipeline = MetricPipeline<PollingStage, IntervalHistogramStage>;
+using MovementTestPipeline = MetricPipeline<MovementStage>;
+
+extern template class MetricPipeline<LatencyStage, PollingStage, IntervalHistogramStage, MovementStage, ButtonStage>;
@@ -0,0 +1,31 @@
+#pragma once
+#include "LiveMetrics.hpp"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+// Serves the published snapshot as Prometheus text on http://127.0.0.1:PORT/metrics.
+// The server thread only reads the shared segment, so scrapes never touch the
+// measuring threads. One request per connection; anything else gets a 404.
+class MetricsEndpoint {
+public:
+    // Throws std::runtime_error if the segment is missing or the port cannot be bound
+    MetricsEndpoint(const std::string& segmentName, std::uint16_t port);
+    ~MetricsEndpoint();
+
+    MetricsEndpoint(const MetricsEndpoint&) = delete;
+    MetricsEndpoint& operator=(const MetricsEndpoint&) = delete;
+
+    std::uint64_t getRequests() const { return requests.load(std::memory_order_relaxed); }
+
+private:
+    MetricsReader reader;               // Server thread only
+    std::intptr_t listener{-1};         // SOCKET on Windows, file descriptor elsewhere
+    std::atomic<bool> stopping{false};
+    std::atomic<std::uint64_t> requests{0};
+    std::thread server;
+
+    void serve();
+    void respond(std::intptr_t client);
+};
@@ -0,0 +1,25 @@
+#pragma once
+#include "DeviceGroup.hpp"
+#include "LiveMetrics.hpp"
+#include <string>
+
+// Publishes every device's current statistics to a shared-memory segment for
+// MetricsReader clients (see LiveMetrics.hpp). publish() is wait-free: it fills
+// a private snapshot and stores it behind the seqlock, whatever readers do.
+class MetricsPublisher {
+public:
+    // Creates (or replaces) the segment; throws std::runtime_error on failure
+    explicit MetricsPublisher(const std::string& name = LiveMetricsFormat::DEFAULT_NAME);
+
+    // Consumer thread only, after DeviceGroup::update() so the values are current.
+    // Devices past LiveMetricsFormat::MAX_DEVICES are not published.
+    void publish(const DeviceGroup& devices);
+
+    const std::string& getName() const { return name; }
+
+private:
+    std::string name;
+    SharedSegment segment;
+    LiveMetricsFormat::Segment* layout;
+    LiveMetricsFormat::Snapshot snapshot{};     // Staging copy, filled outside the seqlock
+};
@@ -0,0 +1,100 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Sample history decimated into a fixed number of min/max columns, so a graph can
+// show every spike of a long history at constant cost. Columns start one sample
+// wide; when they run out, neighbours are merged pairwise and the width doubles
+// for as long as the history stays within historySamples. From then on the oldest
+// column scrolls out. push() is O(1) except for the occasional O(columns) merge.
+class MinMaxEnvelope {
+public:
+    struct Column {
+        float min;
+        float max;
+    };
+
+    MinMaxEnvelope(size_t columnCount, size_t historySamples)
+        : columns(std::max<size_t>(columnCount, 2)),
+          maxSamplesPerColumn(std::max<size_t>(historySamples / columns.size(), 1)) {}
+
+    void push(float value) {
+        ++version;
+        if (count > 0 && filled < samplesPerColumn) {
+            Column& last = at(count - 1);
+            last.min = std::min(last.min, value);
+            last.max = std::max(last.max, value);
+            ++filled;
+            return;
+        }
+
+        if (count == columns.size()) {
+            if (2 * samplesPerColumn <= maxSamplesPerColumn) {
+                compact();
+                if (filled < samplesPerColumn) {
+                    push(value);
+                    return;
+                }
+            } else {
+                head = head + 1 == columns.size() ? 0 : head + 1;
+                --count;
+            }
+        }
+
+        at(count) = {value, value};
+        ++count;
+        filled = 1;
+    }
+
+    void clear() {
+        ++version;
+        head = count = filled = 0;
+        samplesPerColumn = 1;
+    }
+
+    // Oldest to newest; the newest column may be partially filled
+    const Column& operator[](size_t index) const {
+        return columns[(head + index) % columns.size()];
+    }
+
+    size_t size() const { return count; }
+    size_t capacity() const { return columns.size(); }
+    bool empty() const { return count == 0; }
+
+    // Changes on every push or clear, so renderers can skip unchanged frames
+    std::uint64_t getVersion() const { return version; }
+
+private:
+    std::vector<Column> columns;
+    size_t maxSamplesPerColumn;
+    size_t samplesPerColumn{1};
+    size_t head{0};
+    size_t count{0};
+    size_t filled{0};           // Samples in the newest column
+    std::uint64_t version{0};
+
+    Column& at(size_t index) {
+        return columns[(head + index) % columns.size()];
+    }
+
+    // Halves the column count by merging neighbours; only reached before the
+    // history first fills, so head is still 0
+    void compact() {
+        const size_t merged = (count + 1) / 2;
+        for (size_t i = 0; i < merged; ++i) {
+            Column column = columns[2 * i];
+            if (2 * i + 1 < count) {
+                column.min = std::min(column.min, columns[2 * i + 1].min);
+                column.max = std::max(column.max, columns[2 * i + 1].max);
+            }
+            columns[i] = column;
+        }
+
+        // An odd trailing column carries only the old width
+        filled = count % 2 == 1 ? samplesPerColumn : 2 * samplesPerColumn;
+        count = merged;
+        samplesPerColumn *= 2;
+    }
+};
@@ -0,0 +1,76 @@
+#pragma once
+#include "Config.hpp"
+#include <array>
+#include <cstdint>
+#include <span>
+
+// Reports and strokes grouped by filtered speed
+struct SpeedBand {
+    std::uint64_t samples{0};
+    std::uint64_t faults{0};        // Reports the sensor clearly mistracked
+    std::uint64_t strokes{0};       // Strokes whose peak speed falls in this band
+    double chordSum{0.0};           // Their total start-to-end length, counts
+};
+
+struct MotionSummary {
+    double speed{0.0};              // Latest filtered speed, counts/ms
+    double acceleration{0.0};       // Latest filtered acceleration along the motion, counts/ms^2
+    double peakSpeed{0.0};
+    double peakAcceleration{0.0};   // Largest magnitude
+
+    std::uint64_t strokes{0};
+    double straightness{0.0};       // Start-to-end length over path length, all strokes together
+    std::uint64_t axisStrokes{0};   // Strokes close to horizontal or vertical
+    std::uint64_t snappedStrokes{0};    // ...of which never left the axis by more than a count
+
+    double cpiDeviation{0.0};       // Largest relative change in counts per stroke against the slowest band
+    double malfunctionSpeed{0.0};   // Slowest band where mistracking becomes common; 0 if none yet
+    double maxTrackedSpeed{0.0};    // Fastest filtered speed of a correctly tracked report
+};
+
+// Sensor-quality analysis over the movement samples, fed in batches of new
+// samples only. Velocity and acceleration come from a Savitzky-Golay filter
+// (a local quadratic least-squares fit, here over the reports' actual
+// timestamps, so jittered intervals don't distort it), lagging the input by
+// half the window. Strokes end at pauses and reversals.
+//
+// CPI linearity assumes repeated swipes over one fixed physical distance at
+// varying speeds: every stroke should then produce the same counts, so counts
+// per stroke are compared across speed bands.
+class MotionAnalyzer {
+public:
+    void process(std::span<const double> timestamps, std::span<const float> dx, std::span<const float> dy);
+    void clear();
+
+    const MotionSummary& getSummary() const { return summary; }
+    const std::array<SpeedBand, Config::MOTION_SPEED_BANDS>& getBands() const { return bands; }
+
+private:
+    static constexpr int WINDOW = 2 * Config::MOTION_FILTER_HALF_WIDTH + 1;
+
+    // Last WINDOW reports: time (ms), integrated position and raw delta (counts)
+    std::array<double, WINDOW> times{};
+    std::array<double, WINDOW> positionX{};
+    std::array<double, WINDOW> positionY{};
+    std::array<float, WINDOW> deltaX{};
+    std::array<float, WINDOW> deltaY{};
+    size_t next{0};
+    size_t filled{0};           // Reports since the last pause, up to WINDOW
+    double lastTime{-1.0};
+
+    // Current stroke
+    double strokeX{0.0}, strokeY{0.0};
+    double strokeMinX{0.0}, strokeMaxX{0.0}, strokeMinY{0.0}, strokeMaxY{0.0};
+    double strokePath{0.0};
+    double strokePeakSpeed{0.0};
+    double pathSum{0.0};
+    double chordSum{0.0};
+
+    MotionSummary summary;
+    std::array<SpeedBand, Config::MOTION_SPEED_BANDS> bands{};
+
+    void add(double timeMs, float dx, float dy);
+    void filterCenter();
+    void endStroke();
+    void updateCpiAndMalfunction();
+};
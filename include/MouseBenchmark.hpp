@@ -1,22 +1,57 @@
 #pragma once
 
-#include "Config.hpp"
-#include "Utils.hpp"
+#include "DisplayConfig.hpp"
+#include "GraphView.hpp"
+#include "StatsOverlay.hpp"
+#include "FrameScheduler.hpp"
 #include "Metrics.hpp"
+#include "DeviceGroup.hpp"
+#include "MetricsPublisher.hpp"
+#include "PipelineTrace.hpp"
+#include "SessionStats.hpp"
+#include <cstdint>
 #include <memory>
+#include <ostream>
+#include <utility>
 
 class MouseBenchmark {
 public:
-    MouseBenchmark();
+    // Defaults to the platform's live input; pass a ReplayInputSource to replay a capture
+    explicit MouseBenchmark(std::unique_ptr<InputSource> source = createDefaultInputSource(),
+                            double targetFrameRate = Config::TARGET_FRAME_RATE);
+    // Several mice at once, each with its own capture thread, collector and overlay row
+    explicit MouseBenchmark(DeviceGroup devices, double targetFrameRate = Config::TARGET_FRAME_RATE);
     void run();
 
+    // Streams drained events; not owned, and must outlive run()
+    void setExporter(SampleExporter* exporter) { devices.setExporter(exporter); }
+    const DeviceGroup& getDevices() const { return devices; }
+
+    // Publishes live statistics at Config::PUBLISH_RATE; not owned, and must outlive run()
+    void setPublisher(MetricsPublisher* metricsPublisher) { publisher = metricsPublisher; }
+
+    // Frame intervals and per-frame work time in microseconds, for showing the
+    // tool's own overhead
+    const Histogram& getFrameTimeHistogram() const { return frameTimeHistogram; }
+    const Histogram& getFrameWorkHistogram() const { return frameWorkHistogram; }
+    void writeFrameStats(std::ostream& out) const;
+
+    // Reaction time from a target appearing to a press landing on it, per target and overall
+    const Histogram& getReactionHistogram() const { return reactionHistogram; }
+    void writeReactionStats(std::ostream& out) const;
+
+    // The tool's own delay from each report to the collector and to the screen;
+    // call retainSpans() on it before run() to write a trace afterwards
+    PipelineTrace& getTrace() { return trace; }
+
 private:
     enum class TestState {
         MENU,
         COMBINED_TEST,
         LATENCY_TEST,
         POLLING_RATE_TEST,
-        MOVEMENT_TEST
+        MOVEMENT_TEST,
+        PIPELINE_VIEW
     };
 
     // Core components
@@ -24,30 +59,75 @@ private:
     TestState currentState;
     bool vsyncEnabled;
     
-    // Utilities
-    Utils::HighResolutionTimer timer;
-    MetricsCollector metrics;
+    // Frame timing, sampled once per loop iteration
+    FrameScheduler scheduler;
+    double targetFrameRate;
+    std::int64_t lastFrameNs{0};
+    double frameSeconds{0.0};
+    Histogram frameTimeHistogram{Config::HISTOGRAM_LOWEST_US, Config::HISTOGRAM_HIGHEST_US, Config::HISTOGRAM_SIGNIFICANT_DIGITS};
+    Histogram frameWorkHistogram{Config::HISTOGRAM_LOWEST_US, Config::HISTOGRAM_HIGHEST_US, Config::HISTOGRAM_SIGNIFICANT_DIGITS};
+
+    // Slower cadences for work that doesn't need every frame
+    Cadence textCadence{Config::STATS_TEXT_RATE};
+    Cadence graphCadence{Config::GRAPH_UPDATE_RATE};
+    Cadence publishCadence{Config::PUBLISH_RATE};
+    MetricsPublisher* publisher{nullptr};
+    bool refreshText{true};
+
+    // Outlives the devices, whose capture threads record into it
+    PipelineTrace trace;
+    TraceBuffer* frameTrace{nullptr};
+
+    // Graphs and detailed statistics follow the selected device
+    DeviceGroup devices;
+    size_t selectedDevice{0};
+    std::vector<size_t> deviceLines;
     
     // UI Elements
     sf::Font font;
-    sf::Text menuText;
-    sf::Text statsText;
-    std::vector<sf::RectangleShape> clickTargets;
+    StatsOverlay menuOverlay;
+    StatsOverlay statsOverlay;
+    StatsOverlay pipelineOverlay;
+    struct ClickTarget {
+        sf::RectangleShape shape;
+        std::int64_t shownNs{0};    // Clock time of the first frame that showed it here; 0 until then
+        RunningMoments reaction;    // ms
+    };
+    std::vector<ClickTarget> clickTargets;
+    std::uint64_t handledPresses{0};    // Presses of the selected device already hit-tested
+    Histogram reactionHistogram{Config::HISTOGRAM_LOWEST_US, Config::HISTOGRAM_HIGHEST_US, Config::HISTOGRAM_SIGNIFICANT_DIGITS};
+    std::vector<sf::Vertex> trail;
+    GraphView latencyGraph;
+    GraphView pollingGraph;
+    GraphView movementGraph;
+
+    // Whole-session interval history, zoomable in the polling rate test
+    GraphView historyGraph;
+    std::vector<MinMaxEnvelope::Column> historyColumns;
+    bool historyFollows{true};      // Spans the whole session as it grows
+    std::int64_t historyFromNs{0};
+    std::int64_t historyToNs{0};
+    size_t historyLevel{0};
 
     // Initialization
     void initializeWindow();
     void initializeUI();
     void generateClickTargets();
+    void placeTarget(ClickTarget& target);
 
     // Main loop functions
     void handleEvents();
     void update();
     void render();
+    void hitTestPresses();
+    void updateHistoryGraph();
 
     // Event handlers
     void handleKeyPress(const sf::Event::KeyEvent& key);
-    void handleMouseClick(const sf::Event::MouseButtonEvent& mouse);
-    void handleMouseMove(const sf::Event::MouseMoveEvent& mouse);
+    void focusMetrics();
+    void zoomHistory(double factor);
+    void panHistory(double fraction);
+    void showWorstInterval();
 
     // Rendering functions
     void drawMenu();
@@ -55,11 +135,18 @@ private:
     void drawLatencyTest();
     void drawPollingRateTest();
     void drawMovementTest();
+    void drawPipelineView();
 
-    // UI helper functions
-    void updateStatsText(const std::string& title);
-    void drawMetricsGraph(const std::vector<float>& data, 
-                         const sf::Vector2f& position,
-                         float max,
-                         const sf::Color& color);
+    // UI helper functions; visit gets whichever pipeline the current test feeds
+    template<typename Visit>
+    decltype(auto) visitSelected(Visit&& visit) const {
+        return visitMetrics(devices[selectedDevice], devices.getFocus(), std::forward<Visit>(visit));
+    }
+    const RollupHistory* selectedIntervalHistory() const;
+    std::uint64_t selectedPressCount() const;
+    void selectNextDevice();
+    void resetStatistics();
+    int currentFps() const;
+    void updateStatsText(const char* title);
+    void updateFrameStats(StatsOverlay& overlay, size_t frameTimeLine, size_t frameWorkLine);
 };
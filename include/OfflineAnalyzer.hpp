@@ -0,0 +1,54 @@
+#pragma once
+#include "Config.hpp"
+#include "Histogram.hpp"
+#include "SessionStats.hpp"
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Everything a report needs about one capture (or the whole corpus), without the
+// histogram storage, so thousands of files can be summarised in bounded memory.
+struct AnalysisSummary {
+    std::string name;
+    std::string error;              // Empty on success
+    std::uint64_t eventCount{0};
+    double durationSeconds{0.0};
+
+    // Captures keep no receipt times, so click latency is a live-only measurement
+    RunningMoments pollingRate;     // Hz
+    RunningMoments interval;        // ms
+    RunningMoments speed;           // counts/ms
+    RunningMoments pressDuration;   // ms
+    ButtonCounts buttons;
+    PercentileSummary intervalPercentiles;  // us
+    PercentileSummary pressDurationPercentiles;     // us
+};
+
+struct AnalysisResult {
+    std::vector<AnalysisSummary> files;     // In input order
+    AnalysisSummary aggregate;
+};
+
+// Computes the collector's statistics over whole capture files in parallel. Files
+// are split into fixed-size record chunks that run as independent tasks on a
+// work-stealing pool; each chunk is seeded with the state left by the records
+// before it, so the merged result matches a sequential pass.
+class OfflineAnalyzer {
+public:
+    explicit OfflineAnalyzer(std::size_t threadCount = std::thread::hardware_concurrency(),
+                             std::size_t chunkRecords = Config::ANALYSIS_CHUNK_RECORDS);
+
+    // Expands directories (recursively) into the capture files they contain
+    static std::vector<std::string> collectCaptureFiles(const std::vector<std::string>& paths);
+
+    AnalysisResult analyze(const std::vector<std::string>& files) const;
+
+    // One capture's whole-session statistics, histograms included; throws
+    // std::runtime_error if it cannot be read
+    SessionStats analyzeFile(const std::string& path) const;
+
+private:
+    std::size_t threadCount;
+    std::size_t chunkRecords;
+};
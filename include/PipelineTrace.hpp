@@ -0,0 +1,108 @@
+#pragma once
+#include "Config.hpp"
+#include "Histogram.hpp"
+#include "SpscRing.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Stages an input passes through on its way to the screen, each named after
+// the tracepoint that ends it
+enum class TraceStage : std::uint8_t {
+    Read,       // Report timestamp to the capture thread reading it (sources on the capture clock only)
+    Dequeue,    // Receipt to the consumer popping it off the ring
+    Metrics,    // Popped to inserted into the collector
+    Frame,      // Inserted to drawn in the first frame after it
+    Present,    // Drawn to window.display() returning
+    Count
+};
+
+const char* traceStageName(TraceStage stage);
+
+// One stage of one batch of events. Latencies are the oldest event's, the one
+// that waited longest.
+struct TraceSpan {
+    static constexpr std::uint8_t NO_DEVICE = 0xFF;
+
+    std::int64_t originNs;      // Oldest event's report time, or its receipt when the source has its own clock
+    std::int64_t startNs;
+    std::int64_t endNs;
+    std::uint32_t events;
+    TraceStage stage;
+    std::uint8_t device;        // Device index; NO_DEVICE for frame stages
+};
+
+// A thread's own spans. Only that thread records and only the collecting
+// thread takes them out, so recording is wait-free.
+class TraceBuffer {
+public:
+    explicit TraceBuffer(std::string name) : name(std::move(name)) {}
+
+    void record(const TraceSpan& span) {
+        if (!spans.tryPush(span)) dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const std::string& getName() const { return name; }
+
+private:
+    friend class PipelineTrace;
+
+    std::string name;
+    std::thread::id owner{std::this_thread::get_id()};
+    SpscRing<TraceSpan, Config::TRACE_BUFFER_SPANS> spans;
+    std::atomic<std::uint64_t> dropped{0};
+};
+
+// Self-instrumentation: how long the tool itself takes from a report to the
+// collector and to the screen. Each thread records spans into its own buffer;
+// collect() moves them into per-stage histograms and, when asked to, keeps
+// them for a Chrome trace-event file (chrome://tracing, Perfetto).
+class PipelineTrace {
+public:
+    PipelineTrace();
+
+    // The calling thread's buffer, created on its first call. Takes a lock, so
+    // threads call it once and keep the reference; it lives as long as the trace.
+    TraceBuffer& threadBuffer(const std::string& name);
+
+    // Keeps up to maxSpans collected spans for writeChromeTrace; 0 keeps none
+    void retainSpans(size_t maxSpans);
+
+    // Collecting thread only
+    void collect();
+
+    // Nanoseconds, per batch
+    const Histogram& getStageHistogram(TraceStage stage) const { return stages[static_cast<size_t>(stage)]; }
+    const Histogram& getInputToMetricHistogram() const { return inputToMetric; }
+    const Histogram& getInputToPresentHistogram() const { return inputToPresent; }
+    std::uint64_t getCollectedSpans() const { return collectedSpans; }
+    std::uint64_t getDroppedSpans() const;
+
+    void writeSummary(std::ostream& out) const;
+    // Complete ("X") events on one track per thread, times in microseconds from the first span
+    void writeChromeTrace(std::ostream& out) const;
+
+private:
+    struct RetainedSpan {
+        TraceSpan span;
+        std::uint32_t thread;
+    };
+
+    mutable std::mutex buffersMutex;    // Guards the list, never the spans
+    std::vector<std::unique_ptr<TraceBuffer>> buffers;
+
+    std::array<Histogram, static_cast<size_t>(TraceStage::Count)> stages;
+    Histogram inputToMetric;
+    Histogram inputToPresent;
+    std::uint64_t collectedSpans{0};
+
+    size_t retainLimit{0};
+    std::vector<RetainedSpan> retained;
+    std::uint64_t unretainedSpans{0};
+};
@@ -0,0 +1,56 @@
+#pragma once
+#include "Config.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct PollingEstimate {
+    double nominalRateHz{0.0};      // Nearest standard USB rate, or the fitted rate if none is close
+    double rateHz{0.0};             // 1 / fitted period
+    double periodUs{0.0};
+    double periodicity{0.0};        // Mean cos(2 pi interval / period); 1 when every interval is whole periods
+    double missedFraction{0.0};     // Report slots without a report (includes slots with no motion)
+    double duplicateFraction{0.0};  // Reports less than half a period after the previous one
+    double jitterUs{0.0};           // RMS distance of intervals from a whole number of periods
+    size_t intervals{0};
+};
+
+// Estimates the report period from a long window of intervals instead of
+// per-interval 1/dt rates, which misread devices that batch reports or whose
+// OS coalesces moves. A fine interval histogram is kept up to date as the
+// window slides. analyze() scores candidate periods by the histogram's Fourier
+// coefficient at that period, takes the longest strong fundamental, then fits
+// the period over the raw window by rounding each interval to whole slots.
+class PollingAnalyzer {
+public:
+    explicit PollingAnalyzer(size_t windowSize = Config::POLLING_ANALYSIS_WINDOW);
+
+    void add(double intervalUs);
+    void clear();
+
+    // Re-runs over the whole window; cheap enough for every text refresh
+    const PollingEstimate& analyze();
+    const PollingEstimate& getEstimate() const { return estimate; }
+    size_t size() const { return count; }
+
+    // AVX2 kernels are used when the CPU has them; disabling falls back to the
+    // scalar ones (for benchmarking). Returns whether AVX2 is now in use.
+    static bool useVectorKernels(bool enable);
+    static const char* kernelName();
+
+private:
+    std::vector<float> window;          // Ring of intervals, microseconds
+    size_t head{0};
+    size_t count{0};
+
+    std::vector<std::uint32_t> bins;    // Config::POLLING_BIN_US wide
+    std::vector<float> binCenters;      // Non-empty bins, compacted for the scan
+    std::vector<float> binWeights;
+    std::vector<double> scores;         // Per candidate period
+
+    PollingEstimate estimate;
+
+    size_t binIndex(float intervalUs) const;
+    double scanPeriod(double& periodicity);
+    void fitPeriod(double periodUs);
+};
@@ -0,0 +1,21 @@
+#pragma once
+#include "InputSource.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+
+// Windows raw input delivered to a message-only window owned by the capture thread.
+class RawInputSource : public InputSource {
+public:
+    bool open() override;
+    void close() override;
+    std::size_t read(InputEvent* out, std::size_t maxCount, int timeoutMs) override;
+    bool sharesClock() const override { return true; }
+
+private:
+    HINSTANCE instance{nullptr};
+    HWND captureWindow{nullptr};
+
+    std::size_t decode(const MSG& msg, std::int64_t timestamp, InputEvent* out);
+};
+#endif
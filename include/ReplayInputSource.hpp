@@ -0,0 +1,46 @@
+#pragma once
+#include "CaptureFile.hpp"
+#include "FrameScheduler.hpp"
+#include "InputSource.hpp"
+#include <string>
+
+enum class ReplayPacing {
+    RealTime,           // As recorded
+    Scaled,             // speed times faster (or slower below 1.0)
+    AsFastAsPossible    // Unpaced; doubles as a pipeline throughput benchmark
+};
+
+// Parses "realtime", "max" or a speed factor such as "4" or "0.5"
+bool parseReplaySpeed(const std::string& text, ReplayPacing& pacing, double& speed);
+
+// Plays a capture file back through the normal capture path. Events keep their
+// recorded timestamps, and the source is lossless (the capture thread waits for
+// ring space instead of dropping), so every run feeds the collector the same
+// sequence and derives the same intervals and velocities. Click latency is
+// receipt to handling on this run's clock, so it varies from run to run.
+class ReplayInputSource : public InputSource {
+public:
+    // Throws std::runtime_error if the capture cannot be read
+    ReplayInputSource(const std::string& path, ReplayPacing pacing, double speed = 1.0);
+
+    bool open() override;
+    void close() override {}
+    std::size_t read(InputEvent* out, std::size_t maxCount, int timeoutMs) override;
+    bool exhausted() const override { return nextRecord >= reader.getRecords().size(); }
+    bool lossless() const override { return true; }
+
+    std::size_t getRecordCount() const { return reader.getRecords().size(); }
+    std::size_t getReplayedCount() const { return nextRecord; }
+
+private:
+    CaptureReader reader;
+    ReplayPacing pacing;
+    double speed;
+    SpinWaiter waiter;              // Paces real-time and scaled reads
+
+    std::size_t nextRecord{0};
+    std::int64_t firstTimestamp{0};
+    std::int64_t wallStartNs{0};    // Clock ns when playback started
+
+    std::int64_t dueNs(std::int64_t timestampNs) const;
+};
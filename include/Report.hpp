@@ -0,0 +1,31 @@
+#pragma once
+#include "DeviceGroup.hpp"
+#include "Metrics.hpp"
+#include "OfflineAnalyzer.hpp"
+#include "SessionComparison.hpp"
+#include "SyntheticInputSource.hpp"
+#include <ostream>
+
+enum class ReportFormat {
+    Text,
+    Json
+};
+
+// Full statistics of a collector: window stats plus session-wide percentiles.
+// With includeDistribution the text report also carries both histogram tables.
+void writeReport(std::ostream& out, const MetricsCollector& metrics, ReportFormat format,
+                 bool includeDistribution = false);
+
+// One report per device, headed by its name; a single device reads exactly as writeReport
+void writeDeviceReport(std::ostream& out, const DeviceGroup& devices, ReportFormat format,
+                       bool includeDistribution = false);
+
+// Per-file summaries followed by the corpus aggregate
+void writeAnalysisReport(std::ostream& out, const AnalysisResult& result, ReportFormat format);
+
+// Measured session statistics against what a synthetic source actually emitted
+void writeGroundTruthReport(std::ostream& out, const SyntheticGroundTruth& truth, const SessionStats& measured,
+                            std::uint64_t ringDrops, ReportFormat format);
+
+// Session B against session A, metric by metric
+void writeComparisonReport(std::ostream& out, const ComparisonResult& result, ReportFormat format);
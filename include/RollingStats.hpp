@@ -0,0 +1,116 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Statistics over a FIFO sliding window, maintained incrementally.
+// The caller owns the samples: push() each new value and pop() each value as it
+// leaves the window, oldest first. Every operation is amortised O(1).
+class RollingStats {
+public:
+    explicit RollingStats(size_t windowSize)
+        : minQueue(windowSize), maxQueue(windowSize) {}
+
+    void push(double value) {
+        ++n;
+        sum += value;
+
+        // Welford update
+        double delta = value - runningMean;
+        runningMean += delta / n;
+        m2 += delta * (value - runningMean);
+
+        minQueue.push(pushed, value, [](double kept, double incoming) { return kept <= incoming; });
+        maxQueue.push(pushed, value, [](double kept, double incoming) { return kept >= incoming; });
+        ++pushed;
+    }
+
+    void pop(double value) {
+        if (n == 0) return;
+        if (n == 1) {
+            clearMoments();
+        } else {
+            --n;
+            sum -= value;
+
+            // Inverse Welford update
+            double delta = value - runningMean;
+            runningMean -= delta / n;
+            m2 = std::max(0.0, m2 - delta * (value - runningMean));
+        }
+
+        minQueue.expire(popped);
+        maxQueue.expire(popped);
+        ++popped;
+    }
+
+    void clear() {
+        clearMoments();
+        minQueue.clear();
+        maxQueue.clear();
+        pushed = popped = 0;
+    }
+
+    size_t count() const { return n; }
+    double getSum() const { return sum; }
+    double mean() const { return runningMean; }
+    double variance() const { return n > 1 ? m2 / (n - 1) : 0.0; }
+    double stddev() const { return std::sqrt(variance()); }
+    double min() const { return minQueue.front(); }
+    double max() const { return maxQueue.front(); }
+
+private:
+    // Monotonic queue of (sequence, value) in a fixed ring; the front is the window extreme
+    class MonotonicQueue {
+    public:
+        explicit MonotonicQueue(size_t capacity) : entries(std::max<size_t>(capacity, 1) + 1) {}
+
+        template<typename KeepFn>
+        void push(std::uint64_t sequence, double value, KeepFn keep) {
+            while (head != tail && !keep(entries[prev(tail)].value, value)) {
+                tail = prev(tail);
+            }
+            entries[tail] = {sequence, value};
+            tail = next(tail);
+            if (tail == head) head = next(head);  // Window larger than declared; drop oldest
+        }
+
+        void expire(std::uint64_t sequence) {
+            if (head != tail && entries[head].sequence == sequence) {
+                head = next(head);
+            }
+        }
+
+        void clear() { head = tail = 0; }
+        double front() const { return head != tail ? entries[head].value : 0.0; }
+
+    private:
+        struct Entry {
+            std::uint64_t sequence;
+            double value;
+        };
+
+        std::vector<Entry> entries;
+        size_t head{0};
+        size_t tail{0};
+
+        size_t next(size_t i) const { return i + 1 == entries.size() ? 0 : i + 1; }
+        size_t prev(size_t i) const { return i == 0 ? entries.size() - 1 : i - 1; }
+    };
+
+    size_t n{0};
+    double sum{0.0};
+    double runningMean{0.0};
+    double m2{0.0};
+
+    std::uint64_t pushed{0};
+    std::uint64_t popped{0};
+    MonotonicQueue minQueue;
+    MonotonicQueue maxQueue;
+
+    void clearMoments() {
+        n = 0;
+        sum = runningMean = m2 = 0.0;
+    }
+};
@@ -0,0 +1,120 @@
+#pragma once
+#include "Config.hpp"
+#include "MinMaxEnvelope.hpp"
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <vector>
+
+// Count, range, mean and a coarse histogram of the samples in one time bucket
+struct RollupBucket {
+    // Bin i holds values in [2^(i-1), 2^i) us; bin 0 everything below 1 us and
+    // the last everything from 2^(BINS-2) us up
+    static constexpr size_t BINS = 16;
+
+    std::uint32_t count{0};
+    float min{0.f};
+    float max{0.f};
+    double sum{0.0};
+    std::array<std::uint32_t, BINS> bins{};
+
+    void add(float value);
+    void merge(const RollupBucket& other);
+    double mean() const { return count ? sum / count : 0.0; }
+
+    static size_t binOf(float value);
+};
+
+// A stretch of history returned by a query. Level 0 is a single raw sample
+// (startNs == endNs); levels 1 to TIERS are buckets of the matching tier.
+struct RollupSpan {
+    std::int64_t startNs{0};
+    std::int64_t endNs{0};
+    size_t level{0};
+    RollupBucket bucket;
+};
+
+// Bounded-memory history of one sample series for sessions of any length. Every
+// sample goes into a ring of raw values and into each tier of Config::ROLLUP_TIER_NS
+// buckets, so all resolutions are maintained incrementally. Finer levels keep the
+// recent past; the last tier starts at a minute per bucket and merges neighbours
+// and doubles its width whenever it fills, so it always spans the whole session.
+//
+// Each tier keeps a max tree over its buckets: the largest value anywhere is
+// found in O(log n), then followed down the finer tiers to the raw sample while
+// they still hold it. Rendering picks the finest level that can draw a range with
+// at most ROLLUP_BUCKETS_PER_COLUMN entries per column, so it costs the same at
+// every zoom.
+//
+// Values are expected in microseconds, which the bucket histograms assume.
+class RollupHistory {
+public:
+    static constexpr size_t TIERS = std::size(Config::ROLLUP_TIER_NS);
+
+    RollupHistory();
+
+    // Timestamps should not go backwards; older ones are filed at the newest time
+    void add(std::int64_t timeNs, float value);
+    void clear();
+
+    bool empty() const { return total.count == 0; }
+    std::int64_t getStartNs() const { return originNs; }
+    std::int64_t getEndNs() const { return lastNs; }
+    const RollupBucket& getTotal() const { return total; }
+
+    // Bucket width of a level; 0 for raw samples
+    std::int64_t getLevelWidthNs(size_t level) const;
+
+    // Min and max per column over [fromNs, toNs); columns without samples get
+    // min > max. Returns the level drawn from.
+    size_t render(std::int64_t fromNs, std::int64_t toNs, std::span<MinMaxEnvelope::Column> columns) const;
+
+    // The largest value of the session at the finest level still holding it
+    RollupSpan findWorst() const;
+
+    // The last tier, covering the whole session from getStartNs() onwards
+    std::span<const RollupBucket> getSessionBuckets() const;
+    std::int64_t getSessionBucketNs() const { return tiers.back().widthNs; }
+
+private:
+    static constexpr std::uint32_t NONE = UINT32_MAX;
+
+    struct Tier {
+        std::int64_t widthNs{0};
+        std::vector<RollupBucket> buckets;      // Ring indexed by bucket number modulo capacity
+        std::vector<std::uint32_t> maxTree;     // Slot of the largest bucket per subtree, leaves last
+        std::int64_t newest{-1};                // Bucket number holding lastNs
+        std::int64_t newestEndNs{0};            // End of the newest bucket
+        bool widens{false};                     // Coarsens instead of dropping old buckets
+
+        size_t capacity() const { return buckets.size(); }
+        size_t slot(std::int64_t number) const { return static_cast<size_t>(number) & (capacity() - 1); }
+        std::int64_t oldest() const;
+        const RollupBucket& at(std::int64_t number) const { return buckets[slot(number)]; }
+
+        std::uint32_t better(std::uint32_t a, std::uint32_t b) const;
+        void refresh(size_t index);
+        void rebuild();
+        std::uint32_t largest(std::int64_t first, std::int64_t last) const;
+    };
+
+    std::vector<std::int64_t> rawTimes;
+    std::vector<float> rawValues;
+    size_t rawHead{0};
+    size_t rawCount{0};
+
+    std::array<Tier, TIERS> tiers;
+    std::int64_t originNs{0};
+    std::int64_t lastNs{0};
+    RollupBucket total;
+
+    std::int64_t rawTime(size_t index) const { return rawTimes[(rawHead + index) & (rawTimes.size() - 1)]; }
+    float rawValue(size_t index) const { return rawValues[(rawHead + index) & (rawValues.size() - 1)]; }
+    size_t rawLowerBound(std::int64_t timeNs) const;
+
+    void addToTier(Tier& tier, std::int64_t timeNs, float value);
+    void advance(Tier& tier, std::int64_t number);
+    void coarsen(Tier& tier);
+    bool holds(size_t level, std::int64_t fromNs) const;
+};
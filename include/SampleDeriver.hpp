@@ -0,0 +1,210 @@
+#pragma once
+#include "Config.hpp"
+#include "InputEvent.hpp"
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+// Plausibility filters shared by every consumer of derived samples
+namespace SampleFilter {
+    inline bool validLatency(double latencyMs) { return latencyMs > 0 && latencyMs < 1000; }
+    inline bool validInterval(double intervalMs) { return intervalMs > 0; }
+    inline bool validPressDuration(double durationMs) { return durationMs > 0 && durationMs < Config::BUTTON_MAX_PRESS_MS; }
+}
+
+enum class ButtonFault : std::uint8_t {
+    Chatter,        // Contact bounce: a re-press within the debounce window, or a press shorter than it
+    DoubleClick     // A second click sooner after the release than any deliberate double-click
+};
+
+// Clicks and switch faults over all buttons
+struct ButtonCounts {
+    std::uint64_t clicks{0};
+    std::uint64_t chatter{0};
+    std::uint64_t doubleClicks{0};
+
+    void add(ButtonFault fault) { ++(fault == ButtonFault::Chatter ? chatter : doubleClicks); }
+    void merge(const ButtonCounts& other) {
+        clicks += other.clicks;
+        chatter += other.chatter;
+        doubleClicks += other.doubleClicks;
+    }
+};
+
+// What a SampleDeriver sink takes, each with MetricsCollector's signature
+template<typename Sink>
+concept PollingSink = requires(Sink& sink) { sink.addPollingMeasurement(0.0, 0.0, 0.0f, 0.0f); };
+template<typename Sink>
+concept MovementSink = requires(Sink& sink) { sink.addMovementMeasurement(0.0, 0.0f, 0.0f, 0.0f, 0, 0); };
+template<typename Sink>
+concept LatencySink = requires(Sink& sink) { sink.addLatencyMeasurement(0.0, 0.0); };
+template<typename Sink>
+concept PressSink = requires(Sink& sink) { sink.addPressMeasurement(0.0, std::uint8_t{0}, 0.0); };
+template<typename Sink>
+concept ButtonFaultSink = requires(Sink& sink) { sink.addButtonFault(0.0, std::uint8_t{0}, ButtonFault::Chatter); };
+
+// Turns the raw event stream into polling, movement, latency and button samples.
+// The live collector and the offline analyzer share it so both derive identical
+// numbers. A Sink provides any of addPollingMeasurement, addMovementMeasurement,
+// addLatencyMeasurement, addPressMeasurement and addButtonFault; what it lacks
+// is never derived, so a sink taking only intervals skips the button state
+// machine and the speed calculation entirely.
+//
+// Latency is from the capture thread reading a press to the consumer handling
+// it (handledNs), so it is only known live. A press that follows its release
+// within the debounce window is bounce and continues the same click, so a
+// click's duration is only final once that window has passed: the next event
+// closes it, or flush() when no event follows.
+class SampleDeriver {
+public:
+    // Passed to flush() once the stream has ended, to close every open click
+    static constexpr std::int64_t END_OF_STREAM = INT64_MAX;
+
+    template<typename Sink>
+    void process(const InputEvent& event, Sink& sink, std::int64_t handledNs = 0) {
+        constexpr bool moves = PollingSink<Sink> || MovementSink<Sink>;
+        if constexpr (DERIVES_CLICKS<Sink>) {
+            if (pendingReleases != 0) finishClicks(event.timestampNs, sink);
+        }
+
+        switch (event.type) {
+            case InputEventType::Move:
+                if constexpr (moves) processMove(event, sink);
+                break;
+            case InputEventType::ButtonPress:
+                if constexpr (DERIVES_CLICKS<Sink>) processButtonPress(event, sink, handledNs);
+                break;
+            case InputEventType::ButtonRelease:
+                if constexpr (DERIVES_CLICKS<Sink>) processButtonRelease(event);
+                break;
+        }
+    }
+
+    // Closes every click whose release was received on the capture thread at
+    // least the debounce window before nowNs (Clock ns), so the last click of a
+    // burst counts without waiting for another event
+    template<typename Sink>
+    void flush(std::int64_t nowNs, Sink& sink) {
+        if constexpr (DERIVES_CLICKS<Sink>) {
+            if (pendingReleases == 0) return;
+            for (std::uint8_t index = 0; index < Config::MOUSE_BUTTONS; ++index) {
+                if ((pendingReleases & (1u << index)) && nowNs - buttons[index].releaseReceivedNs >= DEBOUNCE_NS) {
+                    finishClick(index, sink);
+                }
+            }
+        }
+    }
+
+    // Restores the movement state left by events before a chunk boundary; button
+    // state comes from processing the preceding BUTTON_MAX_PRESS_MS of events
+    void seed(std::int64_t lastMoveTimeNs) { lastMoveTime = lastMoveTimeNs; }
+
+    void reset() { *this = SampleDeriver(); }
+
+private:
+    struct ButtonState {
+        std::int64_t pressNs{-1};       // Start of the current click
+        std::int64_t releaseNs{-1};     // Its release, while still inside the debounce window
+        std::int64_t releaseReceivedNs{0};  // When the capture thread read that release
+        std::int64_t lastClickEndNs{-1};    // Release of the previous finished click
+    };
+
+    std::int64_t lastMoveTime{-1};
+    ButtonState buttons[Config::MOUSE_BUTTONS];
+    unsigned pendingReleases{0};        // Bit per button with a release awaiting the debounce window
+
+    static constexpr std::int64_t UNSEEN_PRESS = std::numeric_limits<std::int64_t>::min();
+    static constexpr std::int64_t DEBOUNCE_NS = static_cast<std::int64_t>(Config::BUTTON_DEBOUNCE_MS * 1e6);
+    static constexpr std::int64_t DOUBLE_CLICK_FAULT_NS = static_cast<std::int64_t>(Config::BUTTON_DOUBLE_CLICK_FAULT_MS * 1e6);
+
+    template<typename Sink>
+    static constexpr bool DERIVES_CLICKS = LatencySink<Sink> || PressSink<Sink> || ButtonFaultSink<Sink>;
+
+    template<typename Sink>
+    void processMove(const InputEvent& event, Sink& sink) {
+        double timestamp = event.timestampNs * 1e-9;
+
+        if (lastMoveTime >= 0) {
+            double interval = (event.timestampNs - lastMoveTime) * 1e-6; // Convert to milliseconds
+            if constexpr (PollingSink<Sink>) sink.addPollingMeasurement(timestamp, interval, event.x, event.y);
+
+            if constexpr (MovementSink<Sink>) {
+                if (interval > 0) {
+                    // Raw device deltas, not window positions, so pointer ballistics and clamping don't skew speed
+                    float distance = std::hypot(static_cast<float>(event.dx), static_cast<float>(event.dy));
+                    float velocity = distance / static_cast<float>(interval);
+                    sink.addMovementMeasurement(timestamp, event.x, event.y, velocity, event.dx, event.dy);
+                }
+            }
+        }
+
+        lastMoveTime = event.timestampNs;
+    }
+
+    template<typename Sink>
+    void processButtonPress(const InputEvent& event, Sink& sink, std::int64_t handledNs) {
+        if (event.button >= Config::MOUSE_BUTTONS) return;
+        ButtonState& button = buttons[event.button];
+        const double timestamp = event.timestampNs * 1e-9;
+
+        // Releases past the debounce window were already closed on entry
+        if (button.releaseNs >= 0) {
+            // The switch bounced: the click carries on from its first press
+            if constexpr (ButtonFaultSink<Sink>) sink.addButtonFault(timestamp, event.button, ButtonFault::Chatter);
+            button.releaseNs = -1;
+            pendingReleases &= ~(1u << event.button);
+            return;
+        }
+        if constexpr (ButtonFaultSink<Sink>) {
+            if (button.lastClickEndNs >= 0 && event.timestampNs - button.lastClickEndNs < DOUBLE_CLICK_FAULT_NS) {
+                sink.addButtonFault(timestamp, event.button, ButtonFault::DoubleClick);
+            }
+        }
+        button.pressNs = event.timestampNs;
+
+        if constexpr (LatencySink<Sink>) {
+            if (handledNs > 0 && event.receivedNs > 0) {
+                sink.addLatencyMeasurement(timestamp, (handledNs - event.receivedNs) * 1e-6);
+            }
+        }
+    }
+
+    void processButtonRelease(const InputEvent& event) {
+        if (event.button >= Config::MOUSE_BUTTONS) return;
+        ButtonState& button = buttons[event.button];
+        // Pressed before capture (or a chunk's warm-up) started: a hold of unknown length,
+        // which still takes its bounces but never counts as a click
+        if (button.pressNs < 0) button.pressNs = UNSEEN_PRESS;
+        button.releaseNs = event.timestampNs;
+        button.releaseReceivedNs = event.receivedNs;
+        pendingReleases |= 1u << event.button;
+    }
+
+    // Closes every click whose release has outlived the debounce window by timeNs
+    template<typename Sink>
+    void finishClicks(std::int64_t timeNs, Sink& sink) {
+        for (std::uint8_t index = 0; index < Config::MOUSE_BUTTONS; ++index) {
+            if ((pendingReleases & (1u << index)) && timeNs - buttons[index].releaseNs >= DEBOUNCE_NS) {
+                finishClick(index, sink);
+            }
+        }
+    }
+
+    template<typename Sink>
+    void finishClick(std::uint8_t index, Sink& sink) {
+        ButtonState& button = buttons[index];
+        const double timestamp = button.releaseNs * 1e-9;
+        const double duration = button.pressNs == UNSEEN_PRESS ? std::numeric_limits<double>::infinity()
+                                                               : (button.releaseNs - button.pressNs) * 1e-6;
+        // A press too short to be a finger is a glitch on the contact, not a click; one
+        // held past the maximum is a drag, and neither counts nor ends a click
+        if (duration < Config::BUTTON_DEBOUNCE_MS) {
+            if constexpr (ButtonFaultSink<Sink>) sink.addButtonFault(timestamp, index, ButtonFault::Chatter);
+        } else if (duration < Config::BUTTON_MAX_PRESS_MS) {
+            if constexpr (PressSink<Sink>) sink.addPressMeasurement(timestamp, index, duration);
+        }
+        button.lastClickEndNs = duration < Config::BUTTON_MAX_PRESS_MS ? button.releaseNs : -1;
+        button.pressNs = button.releaseNs = -1;
+        pendingReleases &= ~(1u << index);
+    }
+};
@@ -0,0 +1,129 @@
+#pragma once
+#include "Config.hpp"
+#include "InputEvent.hpp"
+#include "SpscRing.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class ExportFormat {
+    Csv,        // One header line, then device,timestamp_ns,received_ns,type,button,x,y,dx,dy
+    JsonLines,  // One object per event with the same fields
+    Columnar    // Binary blocks of contiguous columns, see ColumnarFormat
+};
+
+bool parseExportFormat(const std::string& text, ExportFormat& format);
+
+// Columnar export: a 32-byte file header, then one block per hand-off. A block
+// is a 16-byte header followed by its columns, each eventCount values long and
+// in this order: timestamp_ns (i64), received_ns (i64), x, y (f32), dx, dy (i32),
+// type, button (u8), then zero padding to a multiple of 8 bytes. Little-endian.
+namespace ColumnarFormat {
+    constexpr char MAGIC[8] = {'M', 'B', 'C', 'O', 'L', 'S', '\0', '\0'};
+    constexpr char BLOCK_MAGIC[4] = {'B', 'L', 'K', '\0'};
+    constexpr std::uint32_t VERSION = 1;
+
+    struct FileHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t reserved;
+        std::int64_t createdUnixNs;
+        std::uint8_t padding[8];
+    };
+
+    struct BlockHeader {
+        char magic[4];
+        std::uint32_t eventCount;
+        std::uint32_t device;
+        std::uint32_t reserved;
+    };
+
+    static_assert(sizeof(FileHeader) == 32, "columnar header layout changed");
+    static_assert(sizeof(BlockHeader) == 16, "columnar block layout changed");
+}
+
+struct ExportStats {
+    std::uint64_t eventsExported{0};    // Accepted from the consumer
+    std::uint64_t eventsWritten{0};
+    std::uint64_t eventsDropped{0};     // No free block (writer behind) or the file failed
+    std::uint64_t blocksWritten{0};
+    std::uint64_t bytesWritten{0};
+    std::uint64_t queueHighWater{0};    // Most full blocks waiting for the writer at once
+    bool failed{false};
+};
+
+// Streams raw events to a file from a background writer thread. The consumer
+// copies drained events into a fixed pool of preallocated blocks and hands each
+// full block over a lock-free queue; the writer serialises it and returns it to
+// the pool. Nothing on the consumer side allocates, formats or touches the file.
+//
+// When every block is queued the writer is behind: by default the consumer
+// drops events (and counts them) rather than stall the measurements; with
+// waitWhenFull, as for offline input, it waits for a block instead.
+class SampleExporter {
+public:
+    // Throws std::runtime_error if the file cannot be created
+    SampleExporter(const std::string& path, ExportFormat format, bool waitWhenFull = false);
+    ~SampleExporter();
+
+    SampleExporter(const SampleExporter&) = delete;
+    SampleExporter& operator=(const SampleExporter&) = delete;
+
+    // Consumer thread only; device tags the rows and keeps devices in separate blocks
+    void append(size_t device, std::span<const InputEvent> events);
+
+    // Hands over partly filled blocks, waits for the writer and closes the file;
+    // called by the destructor if needed
+    void close();
+
+    ExportStats getStats() const;
+
+private:
+    struct Block {
+        std::unique_ptr<InputEvent[]> events{std::make_unique<InputEvent[]>(Config::EXPORT_BLOCK_EVENTS)};
+        size_t count{0};
+        size_t device{0};
+    };
+
+    ExportFormat format;
+    bool waitWhenFull;
+    std::ofstream out;
+
+    std::vector<std::unique_ptr<Block>> pool;
+    SpscRing<Block*, Config::EXPORT_BLOCKS> filled;     // Consumer to writer
+    SpscRing<Block*, Config::EXPORT_BLOCKS> emptied;    // Writer to consumer
+    std::vector<Block*> openBlocks;                     // Per device; consumer only
+
+    std::thread writer;
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::atomic<bool> stopping{false};
+    bool closed{false};
+
+    // Consumer side
+    std::atomic<std::uint64_t> eventsExported{0};
+    std::atomic<std::uint64_t> eventsDropped{0};
+    std::atomic<std::uint64_t> queueHighWater{0};
+
+    // Writer side
+    std::atomic<std::uint64_t> eventsWritten{0};
+    std::atomic<std::uint64_t> blocksWritten{0};
+    std::atomic<std::uint64_t> bytesWritten{0};
+    std::atomic<bool> failed{false};
+    std::vector<char> text;             // Serialisation buffer, reused for every block
+
+    Block* takeBlock();
+    void submit(Block* block);
+    void writerLoop();
+    void write(const Block& block);
+    size_t formatCsv(const Block& block);
+    size_t formatJsonLines(const Block& block);
+    size_t formatColumnar(const Block& block);
+};
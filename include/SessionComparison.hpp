@@ -0,0 +1,79 @@
+#pragma once
+#include "Config.hpp"
+#include "Histogram.hpp"
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+// One statistic of B against A, with a bootstrap confidence interval of the difference
+struct StatisticDelta {
+    const char* name;
+    double a{0.0};
+    double b{0.0};
+    double lower{0.0};          // Interval of b - a
+    double upper{0.0};
+
+    double delta() const { return b - a; }
+    // The interval excludes zero
+    bool significant() const { return lower > 0.0 || upper < 0.0; }
+};
+
+// One metric's distribution in session A (baseline) against session B (candidate)
+struct MetricComparison {
+    std::string name;
+    std::uint64_t countA{0};
+    std::uint64_t countB{0};
+    double meanA{0.0};
+    double meanB{0.0};
+    std::vector<StatisticDelta> statistics;     // Percentiles, then the standard deviation
+    double ksStatistic{0.0};    // Largest gap between the two cumulative distributions
+    double ksPValue{1.0};       // Asymptotic two-sample Kolmogorov-Smirnov; ties make it conservative
+    double cohensD{0.0};        // Mean difference over the pooled standard deviation
+    double cliffsDelta{0.0};    // P(b > a) - P(b < a) over all pairs
+};
+
+struct ComparisonResult {
+    std::string nameA;
+    std::string nameB;
+    std::size_t resamples{0};
+    double confidence{0.0};
+    std::vector<MetricComparison> metrics;      // Metrics without samples on both sides are left out
+};
+
+// The session histograms a comparison reads, in microseconds. MetricsCollector
+// and SessionStats both provide them.
+struct ComparedSession {
+    std::string name;
+    const Histogram& latency;
+    const Histogram& interval;
+    const Histogram& pressDuration;
+};
+
+template<typename Stats>
+ComparedSession comparedSession(std::string name, const Stats& stats) {
+    return {std::move(name), stats.getLatencyHistogram(), stats.getIntervalHistogram(),
+            stats.getPressDurationHistogram()};
+}
+
+// A/B comparison of two sessions: percentile and spread deltas with bootstrap
+// confidence intervals, a two-sample Kolmogorov-Smirnov test and effect sizes.
+// A bootstrap resample of n samples is a multinomial draw over the histogram's
+// populated buckets, so it costs the same for a thousand samples or a billion.
+// Resamples run in chunks on a work-stealing pool, each chunk with its own
+// generator seeded from its index, so results don't depend on the thread count.
+class SessionComparator {
+public:
+    explicit SessionComparator(std::size_t threadCount = std::thread::hardware_concurrency(),
+                               std::size_t resamples = Config::COMPARE_RESAMPLES,
+                               double confidence = Config::COMPARE_CONFIDENCE,
+                               std::uint64_t seed = Config::COMPARE_SEED);
+
+    ComparisonResult compare(const ComparedSession& a, const ComparedSession& b) const;
+
+private:
+    std::size_t threadCount;
+    std::size_t resamples;
+    double confidence;
+    std::uint64_t seed;
+};
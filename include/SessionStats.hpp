@@ -0,0 +1,64 @@
+#pragma once
+#include "Histogram.hpp"
+#include "SampleDeriver.hpp"
+#include <cstdint>
+
+// Count, mean, variance and extremes that can be merged across partial results
+// (Chan et al. pairwise update), so chunked analysis matches a sequential pass.
+struct RunningMoments {
+    std::uint64_t count{0};
+    double mean{0.0};
+    double m2{0.0};
+    double min{0.0};
+    double max{0.0};
+
+    void add(double value);
+    void merge(const RunningMoments& other);
+
+    double variance() const { return count > 1 ? m2 / static_cast<double>(count - 1) : 0.0; }
+    double stddev() const;
+};
+
+// Whole-session statistics over every derived sample, with no sliding window.
+// A SampleDeriver sink, so it sees exactly the samples the live collector would.
+class SessionStats {
+public:
+    SessionStats();
+
+    void addLatencyMeasurement(double timestamp, double latency);
+    void addPollingMeasurement(double timestamp, double interval, float x, float y);
+    void addMovementMeasurement(double timestamp, float x, float y, float velocity, std::int32_t dx, std::int32_t dy);
+    void addPressMeasurement(double timestamp, std::uint8_t button, double duration);
+    void addButtonFault(double timestamp, std::uint8_t button, ButtonFault fault);
+
+    void countEvent(std::int64_t timestampNs);
+    void merge(const SessionStats& other);
+
+    std::uint64_t getEventCount() const { return eventCount; }
+    double getDurationSeconds() const;
+
+    const RunningMoments& getLatency() const { return latency; }            // ms
+    const RunningMoments& getPollingRate() const { return pollingRate; }    // Hz
+    const RunningMoments& getInterval() const { return interval; }          // ms
+    const RunningMoments& getSpeed() const { return speed; }                // counts/ms
+    const RunningMoments& getPressDuration() const { return pressDuration; }    // ms
+    const ButtonCounts& getButtonCounts() const { return buttonCounts; }
+    const Histogram& getLatencyHistogram() const { return latencyHistogram; }    // us
+    const Histogram& getIntervalHistogram() const { return intervalHistogram; }  // us
+    const Histogram& getPressDurationHistogram() const { return pressDurationHistogram; }  // us
+
+private:
+    std::uint64_t eventCount{0};
+    std::int64_t firstTimestamp{0};
+    std::int64_t lastTimestamp{0};
+
+    RunningMoments latency;
+    RunningMoments pollingRate;
+    RunningMoments interval;
+    RunningMoments speed;
+    RunningMoments pressDuration;
+    ButtonCounts buttonCounts;
+    Histogram latencyHistogram;
+    Histogram intervalHistogram;
+    Histogram pressDurationHistogram;
+};
@@ -0,0 +1,66 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <utility>
+
+// Fixed-capacity ring of samples stored as one array per field (structure of arrays).
+// Each value is written twice, at slot and slot + capacity, so the live window of
+// any column is always a single contiguous span. Storage is allocated once.
+template<typename... Columns>
+class SoaRing {
+public:
+    template<size_t Column>
+    using ColumnType = std::tuple_element_t<Column, std::tuple<Columns...>>;
+
+    explicit SoaRing(size_t capacity)
+        : ringCapacity(capacity),
+          columns(std::make_unique<Columns[]>(2 * capacity)...) {}
+
+    // Appends one sample; once full, the oldest sample is overwritten
+    void push(Columns... values) {
+        size_t slot = head + count;
+        if (slot >= ringCapacity) slot -= ringCapacity;
+
+        if (count == ringCapacity) {
+            head = head + 1 == ringCapacity ? 0 : head + 1;
+        } else {
+            ++count;
+        }
+        write(slot, std::index_sequence_for<Columns...>{}, values...);
+    }
+
+    void clear() {
+        head = count = 0;
+    }
+
+    // Oldest to newest
+    template<size_t Column>
+    std::span<const ColumnType<Column>> view() const {
+        return {std::get<Column>(columns).get() + head, count};
+    }
+
+    template<size_t Column>
+    const ColumnType<Column>& front() const { return std::get<Column>(columns)[head]; }
+
+    template<size_t Column>
+    const ColumnType<Column>& back() const { return std::get<Column>(columns)[head + count - 1]; }
+
+    size_t size() const { return count; }
+    size_t capacity() const { return ringCapacity; }
+    bool empty() const { return count == 0; }
+    bool full() const { return count == ringCapacity; }
+
+private:
+    size_t ringCapacity;
+    size_t head{0};
+    size_t count{0};
+    std::tuple<std::unique_ptr<Columns[]>...> columns;
+
+    template<size_t... Index>
+    void write(size_t slot, std::index_sequence<Index...>, Columns... values) {
+        ((std::get<Index>(columns)[slot] = values,
+          std::get<Index>(columns)[slot + ringCapacity] = values), ...);
+    }
+};
@@ -0,0 +1,71 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+// Wait-free single-producer/single-consumer ring buffer.
+// The producer and consumer each keep a cached copy of the other side's index
+// so the shared cache lines are only touched when the cached view runs out.
+template<typename T, std::size_t Capacity>
+class SpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscRing capacity must be a power of two");
+
+public:
+    SpscRing() : slots(std::make_unique<T[]>(Capacity)) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer side. Returns false when the ring is full.
+    bool tryPush(const T& value) {
+        const std::size_t currentHead = head.load(std::memory_order_relaxed);
+        if (currentHead - cachedTail >= Capacity) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (currentHead - cachedTail >= Capacity) return false;
+        }
+
+        slots[currentHead & MASK] = value;
+        head.store(currentHead + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Copies up to maxCount items into out and returns how many were taken.
+    std::size_t popBatch(T* out, std::size_t maxCount) {
+        const std::size_t currentTail = tail.load(std::memory_order_relaxed);
+        std::size_t available = cachedHead - currentTail;
+        if (available == 0) {
+            cachedHead = head.load(std::memory_order_acquire);
+            available = cachedHead - currentTail;
+            if (available == 0) return 0;
+        }
+
+        const std::size_t count = std::min(available, maxCount);
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i] = slots[(currentTail + i) & MASK];
+        }
+        tail.store(currentTail + count, std::memory_order_release);
+        return count;
+    }
+
+    // Approximate when called concurrently with push/pop.
+    std::size_t size() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    static constexpr std::size_t capacity() { return Capacity; }
+
+private:
+    static constexpr std::size_t MASK = Capacity - 1;
+
+    // Producer-owned line
+    alignas(64) std::atomic<std::size_t> head{0};
+    std::size_t cachedTail{0};
+
+    // Consumer-owned line
+    alignas(64) std::atomic<std::size_t> tail{0};
+    std::size_t cachedHead{0};
+
+    alignas(64) std::unique_ptr<T[]> slots;
+};
@@ -0,0 +1,34 @@
+#pragma once
+#include "FixedText.hpp"
+#include <SFML/Graphics.hpp>
+#include <string_view>
+#include <vector>
+
+// Text block of "label value" lines. Labels are laid out once; each value keeps
+// the string it last displayed and only rebuilds its glyphs when the new text
+// differs, so a refresh where nothing changed costs a few comparisons.
+class StatsOverlay : public sf::Drawable, public sf::Transformable {
+public:
+    using Value = FixedText<96>;
+
+    void setStyle(const sf::Font& font, unsigned int characterSize, const sf::Color& color);
+
+    // Appends a line and returns its index; lines with no value are plain labels
+    size_t addLine(std::string_view label);
+
+    void setValue(size_t line, const Value& value);
+
+private:
+    struct Line {
+        sf::Text label;
+        sf::Text value;
+        Value shown;
+    };
+
+    const sf::Font* font{nullptr};
+    unsigned int characterSize{0};
+    sf::Color color;
+    std::vector<Line> lines;
+
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+};
@@ -0,0 +1,116 @@
+#pragma once
+#include "FrameScheduler.hpp"
+#include "InputSource.hpp"
+#include "SessionStats.hpp"
+#include <cstdint>
+#include <random>
+#include <string>
+
+enum class SyntheticJitter {
+    None,
+    Gaussian,   // Each interval scaled by 1 + amount * N(0, 1)
+    Bursty      // Reports coalesced into bursts of `amount` back-to-back reports
+};
+
+enum class SyntheticMotion {
+    Constant,   // Straight line at `speed` counts/ms
+    Circle,     // Circle of `radius` counts every `period` ms
+    Flick       // Raised-cosine flicks peaking at `speed`, lasting `flickMs`, every `period` ms
+};
+
+enum class SyntheticClicks {
+    None,
+    Periodic,   // One click every `clickPeriodMs`
+    Random      // Poisson arrivals averaging one per `clickPeriodMs`
+};
+
+struct SyntheticConfig {
+    double rateHz{1000.0};              // Nominal polling rate, up to 32 kHz
+    SyntheticJitter jitter{SyntheticJitter::None};
+    double jitterAmount{0.0};
+    double dropProbability{0.0};        // Reports lost before they reach the host
+
+    SyntheticMotion motion{SyntheticMotion::Constant};
+    double speed{10.0};                 // counts/ms
+    double radius{200.0};               // counts
+    double periodMs{500.0};
+    double flickMs{80.0};
+
+    SyntheticClicks clicks{SyntheticClicks::None};
+    double clickPeriodMs{250.0};
+    double holdMs{60.0};
+    double bounceProbability{0.0};      // Presses whose contact bounces once before closing
+
+    double durationSeconds{10.0};
+    bool realTime{true};                // Paced to the wall clock; otherwise as fast as possible
+    std::uint64_t seed{1};
+};
+
+// Parses comma-separated key=value settings, e.g.
+// "rate=8000,jitter=gauss:0.05,drop=0.001,motion=circle:200:500,clicks=periodic:250,bounce=0.1,duration=10,pace=max"
+bool parseSyntheticSpec(const std::string& text, SyntheticConfig& config);
+
+// What the generator actually emitted, measured from the motion model rather
+// than from the reports, so the collector's numbers can be checked against it
+struct SyntheticGroundTruth {
+    double nominalRateHz{0.0};
+    std::uint64_t reports{0};
+    std::uint64_t droppedReports{0};
+    std::uint64_t presses{0};
+    std::uint64_t bounces{0};
+    double durationSeconds{0.0};
+    RunningMoments interval;    // ms between emitted reports
+    RunningMoments speed;       // Unquantised path length / interval, counts/ms
+    RunningMoments pressDuration;   // ms from each click's first press to its release
+};
+
+// Deterministic generated mouse: reports from a continuous motion model,
+// quantised to integer counts, with configurable interval jitter, losses and
+// clicks. Feeds the normal capture path; unpaced runs are lossless.
+class SyntheticInputSource : public InputSource {
+public:
+    explicit SyntheticInputSource(const SyntheticConfig& config);
+
+    bool open() override;
+    void close() override {}
+    std::size_t read(InputEvent* out, std::size_t maxCount, int timeoutMs) override;
+    bool exhausted() const override { return nextEventNs > endNs; }
+    bool lossless() const override { return !config.realTime; }
+    bool sharesClock() const override { return config.realTime; }
+
+    // Only stable once the capture thread has stopped
+    const SyntheticGroundTruth& getGroundTruth() const { return truth; }
+
+private:
+    SyntheticConfig config;
+    SyntheticGroundTruth truth;
+    std::mt19937_64 rng;
+    SpinWaiter waiter;              // Paces real-time reads
+
+    std::int64_t originNs{0};       // Timestamp of t = 0
+    std::int64_t endNs{0};
+    std::int64_t nextEventNs{0};    // Earliest pending event
+
+    // Report schedule
+    std::uint64_t reportSlot{0};
+    std::int64_t nextReportNs{0};
+    std::int64_t lastScheduledNs{-1};   // Including dropped and still reports
+
+    // Click schedule
+    std::int64_t nextPressNs{-1};
+    std::int64_t nextReleaseNs{-1};
+    std::int64_t pressStartNs{-1};
+    bool bouncing{false};           // Between a bounced press and its re-press
+
+    // Emitted state
+    std::int64_t lastReportNs{-1};
+    double lastPathX{0.0}, lastPathY{0.0};
+    std::int64_t countsX{0}, countsY{0};
+    float cursorX{0.f}, cursorY{0.f};
+
+    void scheduleNextReport();
+    void scheduleNextPress(std::int64_t afterNs);
+    void updateNextEvent();
+    bool emitNext(InputEvent& out);
+    void positionAt(double timeMs, double& x, double& y) const;
+};
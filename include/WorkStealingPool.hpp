@@ -0,0 +1,57 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of workers, each with its own task deque. A worker takes its newest
+// task first (cache-warm, depth-first for nested work) and, when idle, steals the
+// oldest task from another worker. Tasks may submit further tasks.
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit WorkStealingPool(std::size_t threadCount = std::thread::hardware_concurrency());
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // From a worker the task goes to that worker's deque, otherwise round-robin
+    void submit(Task task);
+
+    // Blocks until every submitted task, including nested ones, has finished.
+    // Rethrows the first exception a task threw.
+    void wait();
+
+    std::size_t size() const { return workers.size(); }
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex stateMutex;
+    std::condition_variable workAvailable;
+    std::condition_variable allDone;
+    std::atomic<std::size_t> queued{0};
+    std::atomic<std::size_t> pending{0};
+    std::atomic<std::size_t> nextQueue{0};
+    bool stopping{false};
+    std::exception_ptr firstError;
+
+    void workerLoop(std::size_t index);
+    bool popLocal(std::size_t index, Task& task);
+    bool steal(std::size_t thief, Task& task);
+    void finishTask();
+};
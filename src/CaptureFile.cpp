@@ -0,0 +1,137 @@
+#include "CaptureFile.hpp"
+#include "Config.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace CaptureFormat {
+    Record toRecord(const InputEvent& event) {
+        Record record{};
+        record.timestampNs = event.timestampNs;
+        record.x = event.x;
+        record.y = event.y;
+        record.dx = event.dx;
+        record.dy = event.dy;
+        record.deviceId = event.deviceId;
+        record.type = static_cast<std::uint8_t>(event.type);
+        record.button = event.button;
+        return record;
+    }
+
+    InputEvent toEvent(const Record& record) {
+        InputEvent event{};
+        event.timestampNs = record.timestampNs;
+        event.x = record.x;
+        event.y = record.y;
+        event.dx = record.dx;
+        event.dy = record.dy;
+        event.deviceId = record.deviceId;
+        event.type = static_cast<InputEventType>(record.type);
+        event.button = record.button;
+        return event;
+    }
+
+    bool isCaptureFile(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        char magic[sizeof(MAGIC)] = {};
+        return in.read(magic, sizeof(magic)) && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+    }
+}
+
+CaptureWriter::CaptureWriter(const std::string& path)
+    : file(path, MappedFile::Mode::Create, sizeof(CaptureFormat::Header) + Config::CAPTURE_GROW_BYTES) {
+    recordCapacity = Config::CAPTURE_GROW_BYTES / sizeof(CaptureFormat::Record);
+
+    CaptureFormat::Header initial{};
+    std::memcpy(initial.magic, CaptureFormat::MAGIC, sizeof(initial.magic));
+    initial.version = CaptureFormat::VERSION;
+    initial.recordSize = sizeof(CaptureFormat::Record);
+    initial.createdUnixNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    std::memcpy(file.data(), &initial, sizeof(initial));
+
+    preallocator = std::thread(&CaptureWriter::preallocateLoop, this);
+    requestPreallocation(file.size() + Config::CAPTURE_GROW_BYTES);
+}
+
+CaptureWriter::~CaptureWriter() {
+    try {
+        close();
+    } catch (...) {
+        // Destructors must not throw; the file keeps its pre-extended tail
+    }
+}
+
+void CaptureWriter::append(const InputEvent& event) {
+    if (recordCount == recordCapacity) grow();
+
+    records()[recordCount] = CaptureFormat::toRecord(event);
+    ++recordCount;
+    header()->recordCount = recordCount;
+}
+
+void CaptureWriter::grow() {
+    const std::uint64_t newSize = file.size() + Config::CAPTURE_GROW_BYTES;
+    file.resize(newSize);
+    recordCapacity = (newSize - sizeof(CaptureFormat::Header)) / sizeof(CaptureFormat::Record);
+    requestPreallocation(newSize + Config::CAPTURE_GROW_BYTES);
+}
+
+void CaptureWriter::requestPreallocation(std::uint64_t size) {
+    {
+        std::lock_guard<std::mutex> lock(preallocateMutex);
+        preallocateTo = size;
+    }
+    preallocateWake.notify_one();
+}
+
+void CaptureWriter::preallocateLoop() {
+    // Best effort: where blocks cannot be allocated ahead, resize() leaves the extent sparse
+    std::uint64_t allocated = 0;
+    std::unique_lock<std::mutex> lock(preallocateMutex);
+    while (true) {
+        preallocateWake.wait(lock, [&] { return stopping || preallocateTo > allocated; });
+        if (stopping) return;
+        const std::uint64_t target = preallocateTo;
+        lock.unlock();
+        file.preallocate(allocated, target - allocated);
+        allocated = target;
+        lock.lock();
+    }
+}
+
+void CaptureWriter::close() {
+    if (closed) return;
+    closed = true;
+    {
+        std::lock_guard<std::mutex> lock(preallocateMutex);
+        stopping = true;
+    }
+    preallocateWake.notify_one();
+    if (preallocator.joinable()) preallocator.join();
+    file.close(sizeof(CaptureFormat::Header) + recordCount * sizeof(CaptureFormat::Record));
+}
+
+CaptureReader::CaptureReader(const std::string& path)
+    : file(path, MappedFile::Mode::Read) {
+    if (file.size() < sizeof(CaptureFormat::Header)) {
+        throw std::runtime_error("Not a capture file: " + path);
+    }
+
+    const auto& header = getHeader();
+    if (std::memcmp(header.magic, CaptureFormat::MAGIC, sizeof(header.magic)) != 0) {
+        throw std::runtime_error("Not a capture file: " + path);
+    }
+    if (header.version != CaptureFormat::VERSION || header.recordSize != sizeof(CaptureFormat::Record)) {
+        throw std::runtime_error("Unsupported capture version in " + path);
+    }
+
+    // A writer that crashed leaves a pre-extended tail; trust the header count
+    const std::uint64_t available = (file.size() - sizeof(CaptureFormat::Header)) / sizeof(CaptureFormat::Record);
+    const std::uint64_t count = std::min(header.recordCount, available);
+    records = std::span<const CaptureFormat::Record>(
+        reinterpret_cast<const CaptureFormat::Record*>(file.data() + sizeof(CaptureFormat::Header)),
+        static_cast<size_t>(count));
+}
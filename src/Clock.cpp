@@ -0,0 +1,79 @@
+#include "Clock.hpp"
+
+#ifdef MOUSEBENCH_CLOCK_TSC
+#include <chrono>
+#include <thread>
+#ifndef _MSC_VER
+#include <cpuid.h>
+#endif
+
+namespace {
+    constexpr auto CALIBRATION_PERIOD = std::chrono::milliseconds(50);
+
+    bool hasInvariantTsc() {
+        // CPUID.80000007H:EDX[8] - the TSC ticks at a constant rate in every P/C-state
+        unsigned int regs[4] = {};
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0x80000000);
+        if (static_cast<unsigned int>(info[0]) < 0x80000007u) return false;
+        __cpuid(info, 0x80000007);
+        regs[3] = static_cast<unsigned int>(info[3]);
+#else
+        if (__get_cpuid_max(0x80000000u, nullptr) < 0x80000007u) return false;
+        __get_cpuid(0x80000007u, &regs[0], &regs[1], &regs[2], &regs[3]);
+#endif
+        return (regs[3] & (1u << 8)) != 0;
+    }
+
+    // Brackets each rdtsc between two OS clock reads and keeps the midpoint of
+    // the tightest bracket, so a preemption during sampling doesn't skew the rate
+    void samplePair(std::uint64_t& ticks, std::int64_t& ns) {
+        std::int64_t bestWidth = INT64_MAX;
+        for (int attempt = 0; attempt < 16; ++attempt) {
+            const std::int64_t before = Clock::Detail::systemNowNs();
+            const std::uint64_t tsc = __rdtsc();
+            const std::int64_t after = Clock::Detail::systemNowNs();
+            if (after - before < bestWidth) {
+                bestWidth = after - before;
+                ticks = tsc;
+                ns = before + (after - before) / 2;
+            }
+        }
+    }
+
+    Clock::Detail::TscCalibration calibrate() {
+        Clock::Detail::TscCalibration calibration;
+        if (!hasInvariantTsc()) return calibration;
+
+        std::uint64_t startTicks, endTicks;
+        std::int64_t startNs, endNs;
+        samplePair(startTicks, startNs);
+        std::this_thread::sleep_for(CALIBRATION_PERIOD);
+        samplePair(endTicks, endNs);
+        if (endTicks <= startTicks || endNs <= startNs) return calibration;
+
+        calibration.invariant = true;
+        calibration.baseTicks = endTicks;
+        calibration.baseNs = endNs;
+        calibration.nsPerTick = static_cast<double>(endNs - startNs) / static_cast<double>(endTicks - startTicks);
+        return calibration;
+    }
+}
+
+const Clock::Detail::TscCalibration& Clock::Detail::tscCalibration() {
+    static const TscCalibration calibration = calibrate();
+    return calibration;
+}
+#endif
+
+const char* Clock::backendName() {
+#ifdef MOUSEBENCH_CLOCK_TSC
+    if (Detail::tscCalibration().invariant) return "invariant TSC";
+#endif
+#ifdef _WIN32
+    return "QueryPerformanceCounter";
+#else
+    return "CLOCK_MONOTONIC_RAW";
+#endif
+}
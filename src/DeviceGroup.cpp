@@ -0,0 +1,163 @@
+#include "DeviceGroup.hpp"
+#include "Clock.hpp"
+#ifdef __linux__
+#include "EvdevInputSource.hpp"
+#endif
+#include <algorithm>
+
+namespace {
+    // Most sessions never open every test, so a test's pipeline is only built when it is
+    void buildPipeline(CaptureDevice& device, MetricFocus focus) {
+        switch (focus) {
+            case MetricFocus::All:
+                break;
+            case MetricFocus::Latency:
+                if (!device.latencyTest) device.latencyTest = std::make_unique<LatencyTestPipeline>();
+                break;
+            case MetricFocus::Polling:
+                if (!device.pollingTest) device.pollingTest = std::make_unique<PollingTestPipeline>();
+                break;
+            case MetricFocus::Movement:
+                if (!device.movementTest) device.movementTest = std::make_unique<MovementTestPipeline>();
+                break;
+        }
+    }
+}
+
+CaptureDevice& DeviceGroup::add(std::string name, std::unique_ptr<InputSource> source) {
+    devices.push_back(std::make_unique<CaptureDevice>(std::move(name), std::move(source)));
+    buildPipeline(*devices.back(), focus);
+    return *devices.back();
+}
+
+void DeviceGroup::addLiveDevices() {
+#ifdef __linux__
+    for (const auto& path : EvdevInputSource::findMouseDevices()) {
+        const auto deviceId = static_cast<std::uint16_t>(devices.size());
+        add(path, std::make_unique<EvdevInputSource>(path, deviceId));
+    }
+#else
+    if (auto source = createDefaultInputSource()) add("Mouse", std::move(source));
+#endif
+}
+
+void DeviceGroup::start() {
+    for (size_t i = 0; i < devices.size(); ++i) {
+        if (trace) devices[i]->capture.setTrace(trace, static_cast<std::uint8_t>(i));
+        devices[i]->capture.start();
+    }
+}
+
+void DeviceGroup::stop() {
+    // Signal every thread before joining any, so devices stop together
+    for (auto& device : devices) device->capture.requestStop();
+    for (auto& device : devices) device->capture.stop();
+}
+
+void DeviceGroup::setFocus(MetricFocus metricFocus) {
+    if (metricFocus == focus) return;
+    for (auto& device : devices) {
+        visitMetrics(*device, focus, [](auto& metrics) { metrics.pause(); });
+        buildPipeline(*device, metricFocus);
+    }
+    focus = metricFocus;
+}
+
+size_t DeviceGroup::drain() {
+    size_t drained = 0;
+    if (!exporter && !trace) {
+        for (auto& device : devices) {
+            drained += visitMetrics(*device, focus, [&](auto& metrics) {
+                return metrics.drain(device->capture.getRing());
+            });
+        }
+        return drained;
+    }
+
+    InputEvent batch[Config::INPUT_DRAIN_BATCH];
+    for (size_t index = 0; index < devices.size(); ++index) {
+        CaptureDevice& device = *devices[index];
+        visitMetrics(device, focus, [&](auto& metrics) {
+            size_t count;
+            while ((count = device.capture.getRing().popBatch(batch, Config::INPUT_DRAIN_BATCH)) > 0) {
+                const std::span<const InputEvent> events(batch, count);
+                const std::int64_t handledNs = Clock::nowNs();
+                metrics.ingest(events, handledNs);
+                if (trace) traceIngested(index, events, handledNs);
+                if (exporter) exporter->append(index, events);
+                drained += count;
+            }
+        });
+    }
+    return drained;
+}
+
+void DeviceGroup::traceIngested(size_t index, std::span<const InputEvent> events, std::int64_t handledNs) {
+    if (!trace || events.empty()) return;
+    const std::int64_t ingestedNs = Clock::nowNs();
+    if (!consumerTrace) consumerTrace = &trace->threadBuffer("Consumer");
+
+    // Rings are FIFO, so the first event of the batch waited longest
+    const InputEvent& oldest = events.front();
+    const std::int64_t originNs = devices[index]->capture.sharesClock() ? oldest.timestampNs : oldest.receivedNs;
+    const auto count = static_cast<std::uint32_t>(events.size());
+    const auto device = static_cast<std::uint8_t>(index);
+    consumerTrace->record({originNs, oldest.receivedNs, handledNs, count, TraceStage::Dequeue, device});
+    consumerTrace->record({originNs, handledNs, ingestedNs, count, TraceStage::Metrics, device});
+
+    if (backlog.events == 0) backlog.ingestedNs = ingestedNs;
+    backlog.originNs = std::min(backlog.originNs, originNs);
+    backlog.events += count;
+}
+
+TraceBacklog DeviceGroup::takeTraceBacklog() {
+    const TraceBacklog taken = backlog;
+    backlog = TraceBacklog{};
+    return taken;
+}
+
+void DeviceGroup::update() {
+    const std::int64_t now = Clock::nowNs();
+    for (auto& device : devices) {
+        // A lossless source can run ahead of or behind the clock, so its clicks
+        // close on later events alone and replays stay deterministic
+        const bool realTime = device->capture.isRunning() && !device->capture.lossless();
+        visitMetrics(*device, focus, [&](auto& metrics) {
+            if (realTime) metrics.flush(now);
+            metrics.update();
+        });
+    }
+}
+
+void DeviceGroup::flush() {
+    for (auto& device : devices) {
+        visitMetrics(*device, focus, [](auto& metrics) { metrics.flush(SampleDeriver::END_OF_STREAM); });
+    }
+}
+
+void DeviceGroup::clear() {
+    for (auto& device : devices) {
+        device->metrics.clear();
+        if (device->latencyTest) device->latencyTest->clear();
+        if (device->pollingTest) device->pollingTest->clear();
+        if (device->movementTest) device->movementTest->clear();
+    }
+}
+
+bool DeviceGroup::anyRunning() const {
+    for (const auto& device : devices) {
+        if (device->capture.isRunning()) return true;
+    }
+    return false;
+}
+
+bool DeviceGroup::allLossless() const {
+    return std::all_of(devices.begin(), devices.end(),
+                       [](const auto& device) { return device->capture.lossless(); });
+}
+
+std::uint64_t DeviceGroup::getDroppedEvents() const {
+    std::uint64_t dropped = 0;
+    for (const auto& device : devices) dropped += device->capture.getDroppedEvents();
+    return dropped;
+}
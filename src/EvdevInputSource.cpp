@@ -0,0 +1,222 @@
+#include "EvdevInputSource.hpp"
+
+#ifdef __linux__
+#include "Config.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace {
+    constexpr std::size_t bitsToLongs(std::size_t bits) {
+        return (bits + 8 * sizeof(long) - 1) / (8 * sizeof(long));
+    }
+
+    bool testBit(const unsigned long* bits, unsigned bit) {
+        return (bits[bit / (8 * sizeof(long))] >> (bit % (8 * sizeof(long)))) & 1UL;
+    }
+
+    std::int64_t kernelTimestamp(const input_event& raw) {
+#ifdef input_event_sec
+        const std::int64_t seconds = raw.input_event_sec;
+        const std::int64_t micros = raw.input_event_usec;
+#else
+        const std::int64_t seconds = raw.time.tv_sec;
+        const std::int64_t micros = raw.time.tv_usec;
+#endif
+        return seconds * 1000000000LL + micros * 1000LL;
+    }
+
+    int buttonIndex(unsigned code) {
+        switch (code) {
+            case BTN_LEFT:   return 0;
+            case BTN_RIGHT:  return 1;
+            case BTN_MIDDLE: return 2;
+            case BTN_SIDE:   return 3;
+            case BTN_EXTRA:  return 4;
+            default:         return -1;
+        }
+    }
+
+    void useMonotonicClock(int fd) {
+        // Ask the kernel to stamp reports with CLOCK_MONOTONIC rather than wall
+        // time (evdev can't offer CLOCK_MONOTONIC_RAW). Intervals are only ever
+        // taken between events of the same stream. Fails harmlessly on pipes.
+        int clockId = CLOCK_MONOTONIC;
+        ioctl(fd, EVIOCSCLOCKID, &clockId);
+    }
+}
+
+std::unique_ptr<InputSource> createDefaultInputSource() {
+    const auto devices = EvdevInputSource::findMouseDevices();
+    if (devices.empty()) return nullptr;
+    return std::make_unique<EvdevInputSource>(devices.front());
+}
+
+EvdevInputSource::EvdevInputSource(std::string devicePath, std::uint16_t deviceId)
+    : devicePath(std::move(devicePath)), deviceId(deviceId),
+      x(Config::WINDOW_WIDTH / 2.f), y(Config::WINDOW_HEIGHT / 2.f) {}
+
+EvdevInputSource::EvdevInputSource(int fd, std::uint16_t deviceId)
+    : fd(fd), deviceId(deviceId),
+      x(Config::WINDOW_WIDTH / 2.f), y(Config::WINDOW_HEIGHT / 2.f) {}
+
+EvdevInputSource::~EvdevInputSource() {
+    close();
+}
+
+bool EvdevInputSource::open() {
+    if (fd < 0) {
+        fd = ::open(devicePath.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0) return false;
+        ownsFd = true;
+    }
+    useMonotonicClock(fd);
+    endOfStream = false;
+    return true;
+}
+
+void EvdevInputSource::close() {
+    if (ownsFd && fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    ownsFd = false;
+}
+
+std::size_t EvdevInputSource::read(InputEvent* out, std::size_t maxCount, int timeoutMs) {
+    if (fd < 0 || endOfStream) return 0;
+
+    pollfd request{fd, POLLIN, 0};
+    if (::poll(&request, 1, timeoutMs) <= 0) return 0;
+
+    // A frame flush can emit every pending button on top of the records read now
+    const std::size_t maxRecords = std::min(READ_RECORDS, maxCount - MAX_PENDING_BUTTONS);
+    const std::size_t wantBytes = maxRecords * sizeof(input_event) - buffered;
+
+    const ssize_t bytes = ::read(fd, buffer.data() + buffered, wantBytes);
+    if (bytes == 0) {
+        endOfStream = true;
+        return 0;
+    }
+    if (bytes < 0) {
+        if (errno != EAGAIN && errno != EINTR) endOfStream = true;  // e.g. ENODEV on unplug
+        return 0;
+    }
+    buffered += static_cast<std::size_t>(bytes);
+
+    const std::size_t records = buffered / sizeof(input_event);
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < records; ++i) {
+        input_event raw;
+        std::memcpy(&raw, buffer.data() + i * sizeof(input_event), sizeof(raw));
+        count += decode(raw, out + count);
+    }
+
+    const std::size_t consumed = records * sizeof(input_event);
+    std::memmove(buffer.data(), buffer.data() + consumed, buffered - consumed);
+    buffered -= consumed;
+    return count;
+}
+
+std::size_t EvdevInputSource::decode(const input_event& raw, InputEvent* out) {
+    switch (raw.type) {
+        case EV_REL:
+            if (dropping) break;
+            if (raw.code == REL_X) frameDx += raw.value;
+            else if (raw.code == REL_Y) frameDy += raw.value;
+            break;
+        case EV_KEY: {
+            const int button = buttonIndex(raw.code);
+            if (dropping || button < 0 || raw.value == 2 || pendingCount == MAX_PENDING_BUTTONS) break;
+
+            InputEvent& event = pendingButtons[pendingCount++];
+            event = InputEvent{};
+            event.type = raw.value ? InputEventType::ButtonPress : InputEventType::ButtonRelease;
+            event.button = static_cast<std::uint8_t>(button);
+            break;
+        }
+        case EV_SYN:
+            if (raw.code == SYN_DROPPED) {
+                // The kernel buffer overflowed; discard everything up to the next report
+                dropping = true;
+                frameDx = frameDy = 0;
+                pendingCount = 0;
+            } else if (raw.code == SYN_REPORT) {
+                if (dropping) {
+                    dropping = false;
+                    frameDx = frameDy = 0;
+                    pendingCount = 0;
+                    break;
+                }
+                return flushFrame(kernelTimestamp(raw), out);
+            }
+            break;
+        default:
+            break;
+    }
+    return 0;
+}
+
+std::size_t EvdevInputSource::flushFrame(std::int64_t timestamp, InputEvent* out) {
+    std::size_t count = 0;
+
+    if (frameDx != 0 || frameDy != 0) {
+        x = std::clamp(x + frameDx, 0.f, static_cast<float>(Config::WINDOW_WIDTH - 1));
+        y = std::clamp(y + frameDy, 0.f, static_cast<float>(Config::WINDOW_HEIGHT - 1));
+
+        InputEvent& event = out[count++];
+        event = InputEvent{};
+        event.timestampNs = timestamp;
+        event.x = x;
+        event.y = y;
+        event.dx = frameDx;
+        event.dy = frameDy;
+        event.deviceId = deviceId;
+        event.type = InputEventType::Move;
+    }
+
+    for (std::size_t i = 0; i < pendingCount; ++i) {
+        InputEvent& event = out[count++];
+        event = pendingButtons[i];
+        event.timestampNs = timestamp;
+        event.x = x;
+        event.y = y;
+        event.deviceId = deviceId;
+    }
+
+    frameDx = frameDy = 0;
+    pendingCount = 0;
+    return count;
+}
+
+std::vector<std::string> EvdevInputSource::findMouseDevices() {
+    std::vector<std::string> devices;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator("/dev/input", error)) {
+        const std::string name = entry.path().filename().string();
+        if (name.rfind("event", 0) != 0) continue;
+
+        const int probe = ::open(entry.path().c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        if (probe < 0) continue;
+
+        unsigned long relBits[bitsToLongs(REL_CNT)] = {};
+        unsigned long keyBits[bitsToLongs(KEY_CNT)] = {};
+        const bool isMouse =
+            ioctl(probe, EVIOCGBIT(EV_REL, sizeof(relBits)), relBits) >= 0 &&
+            ioctl(probe, EVIOCGBIT(EV_KEY, sizeof(keyBits)), keyBits) >= 0 &&
+            testBit(relBits, REL_X) && testBit(relBits, REL_Y) && testBit(keyBits, BTN_LEFT);
+        ::close(probe);
+
+        if (isMouse) devices.push_back(entry.path().string());
+    }
+    std::sort(devices.begin(), devices.end());
+    return devices;
+}
+
+#endif
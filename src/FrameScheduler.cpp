@@ -0,0 +1,63 @@
+#include "FrameScheduler.hpp"
+#include "Clock.hpp"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace {
+    constexpr std::int64_t MIN_SPIN_WINDOW_NS = 50'000;
+    constexpr std::int64_t INITIAL_SPIN_WINDOW_NS = 500'000;
+}
+
+SpinWaiter::SpinWaiter(std::int64_t maxSpinWindowNs)
+    : maxSpinWindowNs(std::max(maxSpinWindowNs, MIN_SPIN_WINDOW_NS)),
+      spinWindowNs(std::min(INITIAL_SPIN_WINDOW_NS, this->maxSpinWindowNs)) {}
+
+std::int64_t SpinWaiter::waitUntil(std::int64_t deadlineNs) {
+    std::int64_t now = Clock::nowNs();
+    if (deadlineNs - now > spinWindowNs) {
+        const std::int64_t wakeTarget = deadlineNs - spinWindowNs;
+        std::this_thread::sleep_for(std::chrono::nanoseconds(wakeTarget - now));
+        now = Clock::nowNs();
+
+        // Widen the window at once after a late wake-up, narrow it slowly otherwise
+        const std::int64_t oversleep = now - wakeTarget;
+        if (oversleep > spinWindowNs) {
+            spinWindowNs = oversleep;
+        } else {
+            spinWindowNs -= (spinWindowNs - std::max<std::int64_t>(oversleep, 0)) / 16;
+        }
+        spinWindowNs = std::clamp(spinWindowNs, MIN_SPIN_WINDOW_NS, maxSpinWindowNs);
+    }
+    while (now < deadlineNs) {
+        // Spin out the remainder
+        now = Clock::nowNs();
+    }
+    return now;
+}
+
+FrameScheduler::FrameScheduler(double targetRate) {
+    setTargetRate(targetRate);
+}
+
+void FrameScheduler::setTargetRate(double rate) {
+    targetRate = std::max(rate, 0.0);
+    periodNs = targetRate > 0.0 ? static_cast<std::int64_t>(1e9 / targetRate) : 0;
+    nextFrameNs = 0;
+}
+
+std::int64_t FrameScheduler::waitForNextFrame() {
+    const std::int64_t now = Clock::nowNs();
+    if (periodNs == 0) return now;
+
+    // First frame, or more than a frame behind: restart the schedule rather than
+    // rendering a burst of frames to catch up
+    if (nextFrameNs == 0 || now - nextFrameNs > periodNs) {
+        nextFrameNs = now + periodNs;
+        return now;
+    }
+
+    const std::int64_t due = nextFrameNs;
+    nextFrameNs = due + periodNs;
+    return waiter.waitUntil(due);
+}
@@ -0,0 +1,82 @@
+#include "GraphView.hpp"
+#include <algorithm>
+
+namespace {
+    constexpr size_t VERTICES_PER_COLUMN = 4;
+    constexpr sf::Uint8 FILL_ALPHA = 96;
+}
+
+GraphView::GraphView(const sf::Vector2f& size, const sf::Color& color, float fixedMax)
+    : size(size),
+      color(color),
+      fillColor(color.r, color.g, color.b, FILL_ALPHA),
+      fixedMax(fixedMax),
+      buffer(sf::Lines, sf::VertexBuffer::Stream),
+      useBuffer(sf::VertexBuffer::isAvailable()) {}
+
+void GraphView::update(const MinMaxEnvelope& envelope) {
+    if (&envelope == drawnEnvelope && envelope.getVersion() == drawnVersion) return;
+    drawnEnvelope = &envelope;
+    drawnVersion = envelope.getVersion();
+    rebuild(envelope, envelope.size(), envelope.capacity());
+}
+
+void GraphView::update(std::span<const MinMaxEnvelope::Column> columns) {
+    drawnEnvelope = nullptr;
+    rebuild(columns, columns.size(), columns.size());
+}
+
+template<typename Columns>
+void GraphView::rebuild(const Columns& columns, size_t count, size_t capacity) {
+    const size_t required = capacity * VERTICES_PER_COLUMN;
+    if (vertices.size() < required) {
+        vertices.resize(required);
+        if (useBuffer) useBuffer = buffer.create(required);
+    }
+
+    float max = fixedMax;
+    if (max <= 0.f) {
+        for (size_t i = 0; i < count; ++i) {
+            if (columns[i].min <= columns[i].max) max = std::max(max, columns[i].max);
+        }
+    }
+    if (max <= 0.f) max = 1.f;
+
+    // One column per pixel step; values beyond the scale are clipped to the frame
+    const float xStep = size.x / static_cast<float>(capacity);
+    auto toY = [&](float value) {
+        return size.y - std::clamp(value / max, 0.f, 1.f) * size.y;
+    };
+
+    size_t drawn = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const auto& column = columns[i];
+        if (column.min > column.max) continue;
+        const float x = (static_cast<float>(i) + 0.5f) * xStep;
+        const float minY = toY(column.min);
+        // Keep flat columns at least a pixel tall so they still draw
+        const float maxY = std::min(toY(column.max), minY - 1.f);
+
+        sf::Vertex* quad = &vertices[drawn++ * VERTICES_PER_COLUMN];
+        quad[0] = sf::Vertex(sf::Vector2f(x, size.y), fillColor);
+        quad[1] = sf::Vertex(sf::Vector2f(x, minY), fillColor);
+        quad[2] = sf::Vertex(sf::Vector2f(x, minY), color);
+        quad[3] = sf::Vertex(sf::Vector2f(x, maxY), color);
+    }
+    vertexCount = drawn * VERTICES_PER_COLUMN;
+
+    if (useBuffer && vertexCount > 0) {
+        buffer.update(vertices.data(), vertexCount, 0);
+    }
+}
+
+void GraphView::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    if (vertexCount == 0) return;
+
+    states.transform *= getTransform();
+    if (useBuffer) {
+        target.draw(buffer, 0, vertexCount, states);
+    } else {
+        target.draw(vertices.data(), vertexCount, sf::Lines, states);
+    }
+}
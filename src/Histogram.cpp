@@ -0,0 +1,203 @@
+#include "Histogram.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <stdexcept>
+
+Histogram::Histogram(std::int64_t lowestDiscernibleValue, std::int64_t highestTrackableValue, int significantDigits)
+    : lowestDiscernibleValue(lowestDiscernibleValue),
+      highestTrackableValue(highestTrackableValue),
+      significantDigits(significantDigits),
+      minValue(std::numeric_limits<std::int64_t>::max()) {
+    if (lowestDiscernibleValue < 1) {
+        throw std::invalid_argument("Histogram lowest discernible value must be >= 1");
+    }
+    if (highestTrackableValue < 2 * lowestDiscernibleValue) {
+        throw std::invalid_argument("Histogram highest trackable value must be >= 2 * lowest discernible value");
+    }
+    if (significantDigits < 1 || significantDigits > 5) {
+        throw std::invalid_argument("Histogram significant digits must be in [1, 5]");
+    }
+
+    // Enough linear sub-buckets to resolve 10^digits distinct values in the first bucket
+    std::int64_t largestSingleUnitResolution = 2;
+    for (int i = 0; i < significantDigits; ++i) largestSingleUnitResolution *= 10;
+
+    const int subBucketCountMagnitude = static_cast<int>(std::ceil(std::log2(static_cast<double>(largestSingleUnitResolution))));
+    subBucketHalfCountMagnitude = std::max(subBucketCountMagnitude, 1) - 1;
+    unitMagnitude = static_cast<int>(std::floor(std::log2(static_cast<double>(lowestDiscernibleValue))));
+    subBucketCount = 1 << (subBucketHalfCountMagnitude + 1);
+    subBucketHalfCount = subBucketCount / 2;
+    subBucketMask = static_cast<std::int64_t>(subBucketCount - 1) << unitMagnitude;
+
+    // Each bucket above the first doubles the covered range
+    std::int64_t smallestUntrackableValue = static_cast<std::int64_t>(subBucketCount) << unitMagnitude;
+    bucketCount = 1;
+    while (smallestUntrackableValue <= highestTrackableValue) {
+        if (smallestUntrackableValue > std::numeric_limits<std::int64_t>::max() / 2) {
+            ++bucketCount;
+            break;
+        }
+        smallestUntrackableValue <<= 1;
+        ++bucketCount;
+    }
+
+    counts.assign(static_cast<size_t>(bucketCount + 1) * subBucketHalfCount, 0);
+}
+
+size_t Histogram::countsIndexFor(std::int64_t value) const {
+    const auto bits = static_cast<std::uint64_t>(value | subBucketMask);
+    const int pow2Ceiling = 64 - std::countl_zero(bits);
+    const int bucketIndex = pow2Ceiling - unitMagnitude - (subBucketHalfCountMagnitude + 1);
+    const std::int64_t subBucketIndex = value >> (bucketIndex + unitMagnitude);
+    const std::int64_t bucketBase = static_cast<std::int64_t>(bucketIndex + 1) << subBucketHalfCountMagnitude;
+    return static_cast<size_t>(bucketBase + (subBucketIndex - subBucketHalfCount));
+}
+
+std::int64_t Histogram::valueFromIndex(size_t index) const {
+    int bucketIndex = static_cast<int>(index >> subBucketHalfCountMagnitude) - 1;
+    std::int64_t subBucketIndex = static_cast<std::int64_t>(index & (subBucketHalfCount - 1)) + subBucketHalfCount;
+    if (bucketIndex < 0) {
+        subBucketIndex -= subBucketHalfCount;
+        bucketIndex = 0;
+    }
+    return subBucketIndex << (bucketIndex + unitMagnitude);
+}
+
+std::int64_t Histogram::lowestEquivalentValue(std::int64_t value) const {
+    return valueFromIndex(countsIndexFor(value));
+}
+
+std::int64_t Histogram::highestEquivalentValue(std::int64_t value) const {
+    const size_t index = countsIndexFor(value);
+    if (index + 1 >= counts.size()) return highestTrackableValue;
+    return valueFromIndex(index + 1) - 1;
+}
+
+void Histogram::recordCount(std::int64_t value, std::uint64_t count) {
+    value = std::clamp<std::int64_t>(value, 0, highestTrackableValue);
+    counts[countsIndexFor(value)] += count;
+    totalCount += count;
+    minValue = std::min(minValue, value);
+    maxValue = std::max(maxValue, value);
+}
+
+bool Histogram::sameLayout(const Histogram& other) const {
+    return unitMagnitude == other.unitMagnitude &&
+           subBucketHalfCountMagnitude == other.subBucketHalfCountMagnitude &&
+           counts.size() == other.counts.size();
+}
+
+void Histogram::add(const Histogram& other) {
+    if (other.totalCount == 0) return;
+
+    if (sameLayout(other)) {
+        for (size_t i = 0; i < counts.size(); ++i) {
+            counts[i] += other.counts[i];
+        }
+        totalCount += other.totalCount;
+        minValue = std::min(minValue, other.minValue);
+        maxValue = std::max(maxValue, other.maxValue);
+        return;
+    }
+
+    // Different resolution: re-record each populated bucket at its representative value
+    for (size_t i = 0; i < other.counts.size(); ++i) {
+        if (other.counts[i] != 0) {
+            recordCount(other.valueFromIndex(i), other.counts[i]);
+        }
+    }
+}
+
+void Histogram::clear() {
+    std::fill(counts.begin(), counts.end(), 0);
+    totalCount = 0;
+    minValue = std::numeric_limits<std::int64_t>::max();
+    maxValue = 0;
+}
+
+std::int64_t Histogram::getMin() const {
+    return totalCount == 0 ? 0 : lowestEquivalentValue(minValue);
+}
+
+std::int64_t Histogram::getMax() const {
+    return totalCount == 0 ? 0 : highestEquivalentValue(maxValue);
+}
+
+double Histogram::getMean() const {
+    if (totalCount == 0) return 0.0;
+
+    double total = 0.0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        if (counts[i] == 0) continue;
+        const std::int64_t low = valueFromIndex(i);
+        const std::int64_t median = low + (highestEquivalentValue(low) - low) / 2;
+        total += static_cast<double>(median) * static_cast<double>(counts[i]);
+    }
+    return total / static_cast<double>(totalCount);
+}
+
+std::int64_t Histogram::valueAtPercentile(double percentile) const {
+    std::int64_t value = 0;
+    valuesAtPercentiles(&percentile, &value, 1);
+    return value;
+}
+
+void Histogram::valuesAtPercentiles(const double* percentiles, std::int64_t* values, size_t count) const {
+    if (totalCount == 0) {
+        std::fill(values, values + count, 0);
+        return;
+    }
+
+    size_t next = 0;
+    std::uint64_t cumulative = 0;
+    for (size_t i = 0; i < counts.size() && next < count; ++i) {
+        cumulative += counts[i];
+        while (next < count) {
+            const double clamped = std::clamp(percentiles[next], 0.0, 100.0);
+            const auto target = std::max<std::uint64_t>(1,
+                static_cast<std::uint64_t>(clamped / 100.0 * static_cast<double>(totalCount) + 0.5));
+            if (cumulative < target) break;
+            values[next++] = std::min(highestEquivalentValue(valueFromIndex(i)), getMax());
+        }
+    }
+    for (; next < count; ++next) {
+        values[next] = getMax();
+    }
+}
+
+PercentileSummary Histogram::summarize() const {
+    static constexpr double PERCENTILES[] = {50.0, 90.0, 99.0, 99.9};
+    std::int64_t values[4];
+    valuesAtPercentiles(PERCENTILES, values, 4);
+    return PercentileSummary{values[0], values[1], values[2], values[3], getMax()};
+}
+
+void Histogram::getDistribution(std::vector<std::int64_t>& values, std::vector<std::uint64_t>& bucketCounts) const {
+    values.clear();
+    bucketCounts.clear();
+    for (size_t i = 0; i < counts.size(); ++i) {
+        if (counts[i] == 0) continue;
+        values.push_back(std::min(highestEquivalentValue(valueFromIndex(i)), getMax()));
+        bucketCounts.push_back(counts[i]);
+    }
+}
+
+void Histogram::writePercentileDistribution(std::ostream& out, double unitScale) const {
+    out << std::setw(14) << "Value" << ' ' << std::setw(14) << "Percentile" << ' ' << std::setw(12) << "TotalCount\n";
+    if (totalCount == 0) return;
+
+    std::uint64_t cumulative = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        if (counts[i] == 0) continue;
+        cumulative += counts[i];
+        const double percentile = 100.0 * static_cast<double>(cumulative) / static_cast<double>(totalCount);
+        out << std::fixed << std::setprecision(3)
+            << std::setw(14) << static_cast<double>(highestEquivalentValue(valueFromIndex(i))) * unitScale << ' '
+            << std::setprecision(6) << std::setw(14) << percentile << ' '
+            << std::setw(11) << cumulative << '\n';
+    }
+    out << std::defaultfloat;
+}
@@ -0,0 +1,124 @@
+#include "InputCapture.hpp"
+#include "Clock.hpp"
+#include <chrono>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+    constexpr int WAIT_TIMEOUT_MS = 50;
+    constexpr auto LOSSLESS_BACKOFF = std::chrono::microseconds(50);
+
+    void raiseCaptureThreadPriority() {
+#ifdef _WIN32
+        SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
+#else
+        // Needs CAP_SYS_NICE; without it the thread keeps its normal priority
+        sched_param param{};
+        param.sched_priority = sched_get_priority_max(SCHED_FIFO);
+        pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+#endif
+    }
+}
+
+InputCapture::InputCapture() : InputCapture(createDefaultInputSource()) {}
+
+InputCapture::InputCapture(std::unique_ptr<InputSource> source) : source(std::move(source)) {}
+
+InputCapture::~InputCapture() {
+    stop();
+}
+
+void InputCapture::setRecorder(std::unique_ptr<CaptureWriter> writer) {
+    if (thread.joinable()) return;
+    recorder = std::move(writer);
+}
+
+void InputCapture::setTrace(PipelineTrace* pipelineTrace, std::uint8_t device) {
+    if (thread.joinable()) return;
+    trace = pipelineTrace;
+    traceDevice = device;
+}
+
+void InputCapture::start() {
+    if (!source || thread.joinable()) return;
+    running.store(true, std::memory_order_release);
+    thread = std::thread(&InputCapture::captureLoop, this);
+}
+
+void InputCapture::stop() {
+    running.store(false, std::memory_order_release);
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void InputCapture::publish(const InputEvent& event) {
+    if (ring.tryPush(event)) return;
+
+    if (source->lossless()) {
+        while (!ring.tryPush(event)) {
+            if (!running.load(std::memory_order_acquire)) return;
+            std::this_thread::sleep_for(LOSSLESS_BACKOFF);
+        }
+        return;
+    }
+    droppedEvents.fetch_add(1, std::memory_order_relaxed);
+}
+
+void InputCapture::record(const InputEvent& event) {
+    try {
+        recorder->append(event);
+    } catch (const std::exception&) {
+        // Out of disk or address space: stop recording but keep measuring
+        recorderFailed.store(true, std::memory_order_relaxed);
+        recorder.reset();
+    }
+}
+
+void InputCapture::captureLoop() {
+    // Replays carry their own timestamps; a real-time spinner would only starve the consumer
+    if (!source->lossless()) {
+        raiseCaptureThreadPriority();
+    }
+
+    if (!source->open()) {
+        running.store(false, std::memory_order_release);
+        return;
+    }
+
+    // Without a shared clock there is nothing to measure a read against
+    TraceBuffer* traceBuffer = trace && source->sharesClock()
+        ? &trace->threadBuffer("Capture " + std::to_string(traceDevice)) : nullptr;
+
+    InputEvent batch[Config::INPUT_DRAIN_BATCH];
+    while (running.load(std::memory_order_acquire) && !source->exhausted()) {
+        const std::size_t count = source->read(batch, Config::INPUT_DRAIN_BATCH, WAIT_TIMEOUT_MS);
+        // Evdev timestamps come from the kernel's clock, so receipt is stamped here on ours
+        const std::int64_t receivedNs = count > 0 ? Clock::nowNs() : 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            batch[i].receivedNs = receivedNs;
+            publish(batch[i]);
+            if (recorder) record(batch[i]);
+        }
+        if (traceBuffer && count > 0) {
+            traceBuffer->record({batch[0].timestampNs, batch[0].timestampNs, receivedNs,
+                                 static_cast<std::uint32_t>(count), TraceStage::Read, traceDevice});
+        }
+    }
+
+    source->close();
+    if (recorder) {
+        try {
+            recorder->close();
+        } catch (const std::exception&) {
+            recorderFailed.store(true, std::memory_order_relaxed);
+        }
+    }
+    running.store(false, std::memory_order_release);
+}
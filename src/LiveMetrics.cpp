@@ -0,0 +1,208 @@
+#include "LiveMetrics.hpp"
+#include <ios>
+#include <sstream>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr int READ_ATTEMPTS = 64;
+
+    [[noreturn]] void fail(const std::string& what, const std::string& name) {
+#ifdef _WIN32
+        throw std::runtime_error(what + " " + name + " (error " + std::to_string(GetLastError()) + ")");
+#else
+        throw std::runtime_error(what + " " + name + ": " + std::strerror(errno));
+#endif
+    }
+}
+
+#ifdef _WIN32
+
+SharedSegment::SharedSegment(const std::string& name, Mode mode, size_t size)
+    : name(name), mode(mode), length(size) {
+    const std::string objectName = "Local\\" + name;
+    if (mode == Mode::Create) {
+        mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                     static_cast<DWORD>(static_cast<std::uint64_t>(size) >> 32),
+                                     static_cast<DWORD>(size), objectName.c_str());
+    } else {
+        mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, objectName.c_str());
+    }
+    if (!mapping) fail("Failed to open shared memory", name);
+
+    base = MapViewOfFile(mapping, mode == Mode::Create ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size);
+    if (!base) {
+        CloseHandle(mapping);
+        fail("Failed to map shared memory", name);
+    }
+}
+
+SharedSegment::~SharedSegment() {
+    // The mapping object goes away with its last handle
+    if (base) UnmapViewOfFile(base);
+    if (mapping) CloseHandle(mapping);
+}
+
+#else
+
+SharedSegment::SharedSegment(const std::string& name, Mode mode, size_t size)
+    : name("/" + name), mode(mode), length(size) {
+    int fd;
+    if (mode == Mode::Create) {
+        // A fresh object: readers of a previous run keep their old mapping intact
+        shm_unlink(this->name.c_str());
+        fd = shm_open(this->name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd >= 0 && ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            const int error = errno;
+            ::close(fd);
+            shm_unlink(this->name.c_str());
+            errno = error;
+            fd = -1;
+        }
+    } else {
+        fd = shm_open(this->name.c_str(), O_RDONLY, 0);
+        struct stat info {};
+        if (fd >= 0 && (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < size)) {
+            ::close(fd);
+            throw std::runtime_error("Shared memory " + name + " is smaller than expected");
+        }
+    }
+    if (fd < 0) fail("Failed to open shared memory", name);
+
+    void* mapped = mmap(nullptr, size, mode == Mode::Create ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        if (mode == Mode::Create) shm_unlink(this->name.c_str());
+        fail("Failed to map shared memory", name);
+    }
+    base = mapped;
+}
+
+SharedSegment::~SharedSegment() {
+    if (base) munmap(base, length);
+    if (mode == Mode::Create) shm_unlink(name.c_str());
+}
+
+#endif
+
+MetricsReader::MetricsReader(const std::string& name)
+    : segment(name, SharedSegment::Mode::Read, sizeof(LiveMetricsFormat::Segment)),
+      layout(static_cast<LiveMetricsFormat::Segment*>(segment.data())) {
+    if (std::memcmp(layout->magic, LiveMetricsFormat::MAGIC, sizeof(layout->magic)) != 0 ||
+        layout->version != LiveMetricsFormat::VERSION ||
+        layout->snapshotBytes != sizeof(LiveMetricsFormat::Snapshot)) {
+        throw std::runtime_error("Shared memory " + name + " holds no compatible live metrics");
+    }
+}
+
+bool MetricsReader::read(LiveMetricsFormat::Snapshot& snapshot) {
+    ++reads;
+    return LiveMetricsFormat::load(*layout, snapshot, READ_ATTEMPTS, &retries);
+}
+
+namespace {
+    // Label values escape backslash, quote and newline
+    std::string labelValue(const char* text) {
+        std::string escaped;
+        for (const char* c = text; *c; ++c) {
+            if (*c == '\\' || *c == '"') escaped += '\\';
+            if (*c == '\n') escaped += "\\n";
+            else escaped += *c;
+        }
+        return escaped;
+    }
+
+    struct Exposition {
+        std::ostringstream out;
+        const LiveMetricsFormat::Snapshot& snapshot;
+
+        // One family: HELP and TYPE once, then a sample per device
+        template<typename Field>
+        void family(const char* name, const char* type, const char* help, Field field) {
+            out << "# HELP mousebench_" << name << ' ' << help << '\n'
+                << "# TYPE mousebench_" << name << ' ' << type << '\n';
+            for (size_t i = 0; i < snapshot.deviceCount; ++i) {
+                const LiveMetricsFormat::Device& device = snapshot.devices[i];
+                out << "mousebench_" << name << "{device=\"" << labelValue(device.name) << "\"} "
+                    << field(device) << '\n';
+            }
+        }
+
+        // Session percentiles as gauges labelled by quantile, in seconds
+        void quantiles(const char* name, const char* help,
+                       LiveMetricsFormat::Percentiles LiveMetricsFormat::Device::*member) {
+            out << "# HELP mousebench_" << name << ' ' << help << '\n'
+                << "# TYPE mousebench_" << name << " gauge\n";
+            for (size_t i = 0; i < snapshot.deviceCount; ++i) {
+                const LiveMetricsFormat::Device& device = snapshot.devices[i];
+                const LiveMetricsFormat::Percentiles& values = device.*member;
+                const std::string label = "mousebench_" + std::string(name) + "{device=\"" +
+                                          labelValue(device.name) + "\",quantile=\"";
+                out << label << "0.5\"} " << values.p50 * 1e-6 << '\n'
+                    << label << "0.9\"} " << values.p90 * 1e-6 << '\n'
+                    << label << "0.99\"} " << values.p99 * 1e-6 << '\n'
+                    << label << "0.999\"} " << values.p999 * 1e-6 << '\n'
+                    << label << "1\"} " << values.max * 1e-6 << '\n';
+            }
+        }
+    };
+}
+
+std::string formatPrometheus(const LiveMetricsFormat::Snapshot& snapshot) {
+    using Device = LiveMetricsFormat::Device;
+    Exposition e{std::ostringstream{}, snapshot};
+    e.out.precision(9);
+
+    e.out << "# HELP mousebench_published_timestamp_seconds Wall-clock time of the snapshot\n"
+          << "# TYPE mousebench_published_timestamp_seconds gauge\n"
+          << "mousebench_published_timestamp_seconds " << std::fixed << snapshot.publishedUnixNs * 1e-9
+          << std::defaultfloat << '\n';
+
+    e.family("intervals_total", "counter", "Report intervals measured",
+             [](const Device& d) { return d.intervals; });
+    e.family("latency_samples_total", "counter", "Clicks with a receipt-to-handling latency",
+             [](const Device& d) { return d.latencySamples; });
+    e.family("clicks_total", "counter", "Clicks, with chatter merged",
+             [](const Device& d) { return d.clicks; });
+    e.family("chatter_total", "counter", "Contact bounces merged into a click",
+             [](const Device& d) { return d.chatter; });
+    e.family("double_click_faults_total", "counter", "Clicks starting implausibly soon after a release",
+             [](const Device& d) { return d.doubleClicks; });
+    e.family("dropped_events_total", "counter", "Events lost to a full capture ring",
+             [](const Device& d) { return d.droppedEvents; });
+
+    e.family("polling_rate_hz", "gauge", "Polling rate averaged over the recent window",
+             [](const Device& d) { return d.pollingAverageHz; });
+    e.family("polling_rate_stddev_hz", "gauge", "Polling rate standard deviation over the recent window",
+             [](const Device& d) { return d.pollingStdDevHz; });
+    e.family("polling_nominal_hz", "gauge", "Nominal polling rate from the interval periodicity",
+             [](const Device& d) { return d.nominalHz; });
+    e.family("polling_fitted_hz", "gauge", "Polling rate fitted to whole report periods",
+             [](const Device& d) { return d.fittedHz; });
+    e.family("polling_missed_ratio", "gauge", "Share of report slots without a report",
+             [](const Device& d) { return d.missedFraction; });
+    e.family("polling_duplicate_ratio", "gauge", "Share of reports sharing a slot",
+             [](const Device& d) { return d.duplicateFraction; });
+    e.family("polling_jitter_seconds", "gauge", "Report timing jitter around the fitted period",
+             [](const Device& d) { return d.jitterUs * 1e-6; });
+    e.family("latency_seconds", "gauge", "Click latency averaged over the recent window",
+             [](const Device& d) { return d.latencyAverageMs * 1e-3; });
+    e.family("speed_counts_per_ms", "gauge", "Movement speed averaged over the recent window",
+             [](const Device& d) { return d.speedAverage; });
+    e.family("worst_interval_seconds", "gauge", "Longest report interval of the session",
+             [](const Device& d) { return d.worstIntervalUs * 1e-6; });
+    e.family("worst_latency_seconds", "gauge", "Largest click latency of the session",
+             [](const Device& d) { return d.worstLatencyUs * 1e-6; });
+
+    e.quantiles("interval_quantile_seconds", "Session report interval percentiles", &Device::intervalUs);
+    e.quantiles("latency_quantile_seconds", "Session click latency percentiles", &Device::latencyUs);
+    e.quantiles("press_duration_quantile_seconds", "Session press duration percentiles", &Device::pressDurationUs);
+    return e.out.str();
+}
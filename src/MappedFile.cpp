@@ -0,0 +1,174 @@
+#include "MappedFile.hpp"
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    [[noreturn]] void fail(const std::string& what, const std::string& path) {
+#ifdef _WIN32
+        throw std::runtime_error(what + " " + path + " (error " + std::to_string(GetLastError()) + ")");
+#else
+        throw std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+#endif
+    }
+}
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& path, Mode mode, std::uint64_t initialSize)
+    : path(path), mode(mode) {
+    const bool writable = mode == Mode::Create;
+    file = CreateFileA(path.c_str(), writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+                       FILE_SHARE_READ, nullptr, writable ? CREATE_ALWAYS : OPEN_EXISTING,
+                       FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) fail("Failed to open", path);
+
+    if (writable) {
+        resize(initialSize);
+    } else {
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize)) fail("Failed to stat", path);
+        length = static_cast<std::uint64_t>(fileSize.QuadPart);
+        map();
+    }
+}
+
+MappedFile::~MappedFile() {
+    unmap();
+    if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+}
+
+void MappedFile::map() {
+    if (length == 0) return;
+    const bool writable = mode == Mode::Create;
+    mapping = CreateFileMappingA(file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY,
+                                 static_cast<DWORD>(length >> 32), static_cast<DWORD>(length), nullptr);
+    if (!mapping) fail("Failed to map", path);
+    base = static_cast<unsigned char*>(MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0));
+    if (!base) fail("Failed to map", path);
+}
+
+void MappedFile::unmap() {
+    if (base) UnmapViewOfFile(base);
+    if (mapping) CloseHandle(mapping);
+    base = nullptr;
+    mapping = nullptr;
+}
+
+void MappedFile::resize(std::uint64_t newSize) {
+    unmap();
+    LARGE_INTEGER position;
+    position.QuadPart = static_cast<LONGLONG>(newSize);
+    if (!SetFilePointerEx(file, position, nullptr, FILE_BEGIN) || !SetEndOfFile(file)) {
+        fail("Failed to resize", path);
+    }
+    length = newSize;
+    map();
+}
+
+bool MappedFile::preallocate(std::uint64_t offset, std::uint64_t bytes) {
+    FILE_ALLOCATION_INFO allocation;
+    allocation.AllocationSize.QuadPart = static_cast<LONGLONG>(offset + bytes);
+    return SetFileInformationByHandle(file, FileAllocationInfo, &allocation, sizeof(allocation)) != 0;
+}
+
+void MappedFile::close(std::uint64_t finalSize) {
+    if (file == INVALID_HANDLE_VALUE) return;
+    if (mode == Mode::Create) {
+        if (base) FlushViewOfFile(base, 0);
+        unmap();
+        LARGE_INTEGER position;
+        position.QuadPart = static_cast<LONGLONG>(finalSize);
+        SetFilePointerEx(file, position, nullptr, FILE_BEGIN);
+        SetEndOfFile(file);
+    } else {
+        unmap();
+    }
+    CloseHandle(file);
+    file = INVALID_HANDLE_VALUE;
+    length = 0;
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path, Mode mode, std::uint64_t initialSize)
+    : path(path), mode(mode) {
+    if (mode == Mode::Create) {
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) fail("Failed to create", path);
+        resize(initialSize);
+    } else {
+        fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) fail("Failed to open", path);
+        struct stat info;
+        if (fstat(fd, &info) != 0) fail("Failed to stat", path);
+        length = static_cast<std::uint64_t>(info.st_size);
+        map();
+    }
+}
+
+MappedFile::~MappedFile() {
+    unmap();
+    if (fd >= 0) ::close(fd);
+}
+
+void MappedFile::map() {
+    if (length == 0) return;
+    const int protection = mode == Mode::Create ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    void* address = mmap(nullptr, length, protection, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED) fail("Failed to map", path);
+    base = static_cast<unsigned char*>(address);
+    madvise(base, length, MADV_SEQUENTIAL);
+}
+
+void MappedFile::unmap() {
+    if (base) munmap(base, length);
+    base = nullptr;
+}
+
+void MappedFile::resize(std::uint64_t newSize) {
+#ifdef __linux__
+    // Moves the existing pages instead of tearing down and faulting in the whole file again
+    if (base && newSize > 0) {
+        if (ftruncate(fd, static_cast<off_t>(newSize)) != 0) fail("Failed to resize", path);
+        void* address = mremap(base, length, newSize, MREMAP_MAYMOVE);
+        if (address == MAP_FAILED) fail("Failed to remap", path);
+        base = static_cast<unsigned char*>(address);
+        length = newSize;
+        return;
+    }
+#endif
+    unmap();
+    if (ftruncate(fd, static_cast<off_t>(newSize)) != 0) fail("Failed to resize", path);
+    length = newSize;
+    map();
+}
+
+bool MappedFile::preallocate([[maybe_unused]] std::uint64_t offset, [[maybe_unused]] std::uint64_t bytes) {
+#ifdef __linux__
+    // Keeps the size, so the extent stays outside the mapping until resize() reaches it
+    return fallocate(fd, FALLOC_FL_KEEP_SIZE, static_cast<off_t>(offset), static_cast<off_t>(bytes)) == 0;
+#else
+    return false;
+#endif
+}
+
+void MappedFile::close(std::uint64_t finalSize) {
+    if (fd < 0) return;
+    unmap();
+    if (mode == Mode::Create && ftruncate(fd, static_cast<off_t>(finalSize)) != 0) {
+        fail("Failed to truncate", path);
+    }
+    ::close(fd);
+    fd = -1;
+    length = 0;
+}
+
+#endif
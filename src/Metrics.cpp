@@ -1,93 +1,196 @@
 #include "Metrics.hpp"
+#include "Clock.hpp"
 #include "Config.hpp"
-#include <numeric>
 #include <algorithm>
+#include <cmath>
 
-void MetricsCollector::addLatencyMeasurement(double timestamp, double latency) {
-    if (latency <= 0 || latency >= 1000) return; // Filter unrealistic values
-    
-    LatencyData data{timestamp, latency};
-    latencyMeasurements.push_back(data);
-    
-    if (latencyMeasurements.size() > Config::MAX_MEASUREMENTS) {
-        latencyMeasurements.pop_front();
+template class MetricPipeline<LatencyStage, PollingStage, IntervalHistogramStage, MovementStage, ButtonStage>;
+
+std::int64_t drainHandlingNs() {
+    return Clock::nowNs();
+}
+
+void LatencyStage::onLatency(double timestamp, double latency) {
+    if (latencySamples.full()) {
+        latencyStats.pop(latencySamples.front<LatencyColumn::Latency>());
     }
-    
+
+    // Stats see the stored precision so evictions cancel exactly
+    float stored = static_cast<float>(latency);
+    latencySamples.push(timestamp, stored);
+    latencyStats.push(stored);
+    latencyEnvelope.push(stored);
+    latencyHistory.add(std::llround(timestamp * 1e9), static_cast<float>(latency * 1000.0));
+    latencyHistogram.record(std::llround(latency * 1000.0));
+
     currentLatency = latency;
-    minLatency = std::min(minLatency, latency);
-    maxLatency = std::max(maxLatency, latency);
-}
-
-void MetricsCollector::addPollingMeasurement(double timestamp, double interval, const sf::Vector2f& position) {
-    if (interval <= 0) return;
-    
-    PollingData data{timestamp, interval, position};
-    pollingMeasurements.push_back(data);
-    
-    if (pollingMeasurements.size() > Config::MAX_MEASUREMENTS) {
-        pollingMeasurements.pop_front();
+}
+
+void LatencyStage::update() {
+    if (latencyStats.count() == 0) return;
+
+    averageLatency = latencyStats.mean();
+    latencyStdDev = latencyStats.stddev();
+    minLatency = latencyStats.min();
+    maxLatency = latencyStats.max();
+
+    // Only re-walk the buckets when something new was recorded
+    if (latencyHistogram.getTotalCount() != latencyPercentilesCount) {
+        latencyPercentiles = latencyHistogram.summarize();
+        latencyPercentilesCount = latencyHistogram.getTotalCount();
     }
-    
+}
+
+void LatencyStage::clear() {
+    latencySamples.clear();
+    latencyStats.clear();
+    latencyEnvelope.clear();
+    latencyHistory.clear();
+    latencyHistogram.clear();
+    latencyPercentiles = PercentileSummary{};
+    latencyPercentilesCount = 0;
+
+    currentLatency = averageLatency = 0.0;
+    minLatency = maxLatency = 0.0;
+    latencyStdDev = 0.0;
+}
+
+void PollingStage::onInterval(double timestamp, double interval, float x, float y) {
+    if (pollingSamples.full()) {
+        pollingRateStats.pop(pollingSamples.front<PollingColumn::Rate>());
+    }
+
     currentPollingRate = 1000.0 / interval;
+    float rate = static_cast<float>(currentPollingRate);
+    pollingSamples.push(timestamp, static_cast<float>(interval), rate, x, y);
+    pollingRateStats.push(rate);
+    pollingRateEnvelope.push(rate);
 }
 
-void MetricsCollector::addMovementMeasurement(double timestamp, const sf::Vector2f& position, float velocity) {
-    MovementData data{timestamp, position, velocity};
-    movementMeasurements.push_back(data);
-    
-    if (movementMeasurements.size() > Config::MAX_MEASUREMENTS) {
-        movementMeasurements.pop_front();
+void PollingStage::update() {
+    if (pollingRateStats.count() == 0) return;
+
+    averagePollingRate = pollingRateStats.mean();
+    pollingRateStdDev = pollingRateStats.stddev();
+}
+
+void PollingStage::clear() {
+    pollingSamples.clear();
+    pollingRateStats.clear();
+    pollingRateEnvelope.clear();
+    currentPollingRate = averagePollingRate = pollingRateStdDev = 0.0;
+}
+
+void IntervalHistogramStage::onInterval(double timestamp, double interval, float, float) {
+    intervalHistory.add(std::llround(timestamp * 1e9), static_cast<float>(interval * 1000.0));
+    intervalHistogram.record(std::llround(interval * 1000.0));
+    pollingAnalyzer.add(interval * 1000.0);
+}
+
+void IntervalHistogramStage::update() {
+    if (intervalHistogram.getTotalCount() != intervalPercentilesCount) {
+        intervalPercentiles = intervalHistogram.summarize();
+        intervalPercentilesCount = intervalHistogram.getTotalCount();
+    }
+
+    // Each analysis re-reads the whole window, and update() can run after every drain
+    if (intervalHistogram.getTotalCount() != pollingAnalyzedCount) {
+        const std::int64_t now = Clock::nowNs();
+        if (now >= nextPollingAnalysisNs) {
+            analyzePolling();
+            nextPollingAnalysisNs = now + static_cast<std::int64_t>(1e9 / Config::POLLING_ANALYSIS_RATE);
+        }
     }
-    
+}
+
+void IntervalHistogramStage::onEndOfStream() {
+    if (intervalHistogram.getTotalCount() != pollingAnalyzedCount) analyzePolling();
+}
+
+void IntervalHistogramStage::analyzePolling() {
+    pollingAnalyzer.analyze();
+    pollingAnalyzedCount = intervalHistogram.getTotalCount();
+}
+
+void IntervalHistogramStage::clear() {
+    intervalHistory.clear();
+    intervalHistogram.clear();
+    intervalPercentiles = PercentileSummary{};
+    intervalPercentilesCount = 0;
+    pollingAnalyzer.clear();
+    pollingAnalyzedCount = 0;
+    nextPollingAnalysisNs = 0;
+}
+
+void MovementStage::onMovement(double timestamp, float x, float y, float velocity,
+                               std::int32_t dx, std::int32_t dy) {
+    if (movementSamples.full()) {
+        movementStats.pop(movementSamples.front<MovementColumn::Velocity>());
+    }
+
+    movementSamples.push(timestamp, x, y, velocity, static_cast<float>(dx), static_cast<float>(dy));
+    movementStats.push(velocity);
+    movementEnvelope.push(velocity);
+
     currentMovementSpeed = velocity;
+
+    // Analysed in batches, always before the window could overwrite unanalysed samples
+    if (++pendingMotionSamples >= Config::MOTION_BATCH) analyzeMotion();
 }
 
-void MetricsCollector::clear() {
-    latencyMeasurements.clear();
-    pollingMeasurements.clear();
-    movementMeasurements.clear();
-    
-    currentLatency = averageLatency = 0.0;
-    minLatency = 999999.0;
-    maxLatency = 0.0;
-    currentPollingRate = averagePollingRate = 0.0;
-    currentMovementSpeed = averageMovementSpeed = 0.0;
-}
-
-void MetricsCollector::update() {
-    updateLatencyStats();
-    updatePollingStats();
-    updateMovementStats();
-}
-
-void MetricsCollector::updateLatencyStats() {
-    if (latencyMeasurements.empty()) return;
-    
-    double sum = std::accumulate(latencyMeasurements.begin(), latencyMeasurements.end(), 0.0,
-        [](double acc, const LatencyData& data) { return acc + data.latency; });
-    averageLatency = sum / latencyMeasurements.size();
-}
-
-void MetricsCollector::updatePollingStats() {
-    if (pollingMeasurements.empty()) return;
-    
-    double sum = 0.0;
-    size_t validCount = 0;
-    
-    for (const auto& data : pollingMeasurements) {
-        if (data.interval > 0) {
-            sum += 1000.0 / data.interval;
-            validCount++;
-        }
+void MovementStage::analyzeMotion() {
+    const size_t count = std::min(pendingMotionSamples, movementSamples.size());
+    pendingMotionSamples = 0;
+    if (count == 0) return;
+    motionAnalyzer.process(movementSamples.view<MovementColumn::Timestamp>().last(count),
+                           movementSamples.view<MovementColumn::DeltaX>().last(count),
+                           movementSamples.view<MovementColumn::DeltaY>().last(count));
+}
+
+void MovementStage::update() {
+    if (movementStats.count() > 0) averageMovementSpeed = static_cast<float>(movementStats.mean());
+    analyzeMotion();
+}
+
+void MovementStage::clear() {
+    movementSamples.clear();
+    movementStats.clear();
+    movementEnvelope.clear();
+    motionAnalyzer.clear();
+    pendingMotionSamples = 0;
+    currentMovementSpeed = averageMovementSpeed = 0.0f;
+}
+
+void ButtonStage::onEvent(const InputEvent& event) {
+    if (event.type != InputEventType::ButtonPress) return;
+    recentPresses.push(event.timestampNs * 1e-9, event.receivedNs, event.x, event.y, event.button);
+    ++pressCount;
+}
+
+void ButtonStage::onPress(double, std::uint8_t, double duration) {
+    ++buttonCounts.clicks;
+    if (!SampleFilter::validPressDuration(duration)) return;
+    pressDurationHistogram.record(std::llround(duration * 1000.0));
+    currentPressDuration = duration;
+}
+
+void ButtonStage::onButtonFault(double, std::uint8_t, ButtonFault fault) {
+    buttonCounts.add(fault);
+}
+
+void ButtonStage::update() {
+    if (pressDurationHistogram.getTotalCount() != pressDurationPercentilesCount) {
+        pressDurationPercentiles = pressDurationHistogram.summarize();
+        pressDurationPercentilesCount = pressDurationHistogram.getTotalCount();
     }
-    
-    averagePollingRate = validCount > 0 ? sum / validCount : 0.0;
 }
 
-void MetricsCollector::updateMovementStats() {
-    if (movementMeasurements.empty()) return;
-    
-    float sum = std::accumulate(movementMeasurements.begin(), movementMeasurements.end(), 0.0f,
-        [](float acc, const MovementData& data) { return acc + data.velocity; });
-    averageMovementSpeed = sum / movementMeasurements.size();
+void ButtonStage::clear() {
+    recentPresses.clear();
+    pressCount = 0;
+    pressDurationHistogram.clear();
+    pressDurationPercentiles = PercentileSummary{};
+    pressDurationPercentilesCount = 0;
+    buttonCounts = ButtonCounts{};
+    currentPressDuration = 0.0;
 }
@@ -0,0 +1,136 @@
+#ifdef _WIN32
+// Before windows.h, which would otherwise pull in the old winsock.h
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#endif
+#include "MetricsEndpoint.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+using SOCKET = int;
+constexpr SOCKET INVALID_SOCKET = -1;
+#endif
+
+namespace {
+    constexpr int ACCEPT_WAIT_MS = 200;     // How quickly the server notices it should stop
+    constexpr int RECEIVE_WAIT_MS = 1000;
+    constexpr size_t MAX_REQUEST = 4096;
+#ifdef MSG_NOSIGNAL
+    constexpr int SEND_FLAGS = MSG_NOSIGNAL;   // A scraper hanging up must not kill the tool
+#else
+    constexpr int SEND_FLAGS = 0;
+#endif
+
+    void closeSocket(SOCKET socket) {
+#ifdef _WIN32
+        closesocket(socket);
+#else
+        ::close(socket);
+#endif
+    }
+
+    // Waits up to timeoutMs for the socket to become readable
+    bool readable(SOCKET socket, int timeoutMs) {
+        fd_set set;
+        FD_ZERO(&set);
+        FD_SET(socket, &set);
+        timeval timeout{timeoutMs / 1000, (timeoutMs % 1000) * 1000};
+        return select(static_cast<int>(socket) + 1, &set, nullptr, nullptr, &timeout) > 0;
+    }
+
+    void sendAll(SOCKET socket, std::string_view data) {
+        while (!data.empty()) {
+            const auto sent = send(socket, data.data(), static_cast<int>(data.size()), SEND_FLAGS);
+            if (sent <= 0) return;
+            data.remove_prefix(static_cast<size_t>(sent));
+        }
+    }
+}
+
+MetricsEndpoint::MetricsEndpoint(const std::string& segmentName, std::uint16_t port)
+    : reader(segmentName) {
+#ifdef _WIN32
+    WSADATA data;
+    if (WSAStartup(MAKEWORD(2, 2), &data) != 0) throw std::runtime_error("Failed to start Winsock");
+#endif
+
+    const SOCKET socket = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (socket == INVALID_SOCKET) throw std::runtime_error("Failed to create the metrics socket");
+    const int reuse = 1;
+    setsockopt(socket, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+    // Loopback only: the endpoint is for tools on the same bench
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(socket, 8) != 0) {
+        closeSocket(socket);
+        throw std::runtime_error("Failed to listen on 127.0.0.1:" + std::to_string(port));
+    }
+
+    listener = static_cast<std::intptr_t>(socket);
+    server = std::thread(&MetricsEndpoint::serve, this);
+}
+
+MetricsEndpoint::~MetricsEndpoint() {
+    stopping.store(true, std::memory_order_relaxed);
+    if (server.joinable()) server.join();
+    closeSocket(static_cast<SOCKET>(listener));
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+void MetricsEndpoint::serve() {
+    const auto socket = static_cast<SOCKET>(listener);
+    while (!stopping.load(std::memory_order_relaxed)) {
+        if (!readable(socket, ACCEPT_WAIT_MS)) continue;
+        const SOCKET client = accept(socket, nullptr, nullptr);
+        if (client == INVALID_SOCKET) continue;
+        respond(static_cast<std::intptr_t>(client));
+        closeSocket(client);
+    }
+}
+
+void MetricsEndpoint::respond(std::intptr_t clientHandle) {
+    const auto client = static_cast<SOCKET>(clientHandle);
+
+    // Only the request line matters; read until the headers end
+    std::string request;
+    char buffer[1024];
+    while (request.size() < MAX_REQUEST && request.find("\r\n\r\n") == std::string::npos) {
+        if (!readable(client, RECEIVE_WAIT_MS)) return;
+        const auto received = recv(client, buffer, sizeof(buffer), 0);
+        if (received <= 0) return;
+        request.append(buffer, static_cast<size_t>(received));
+    }
+    requests.fetch_add(1, std::memory_order_relaxed);
+
+    std::string body;
+    const char* status = "200 OK";
+    LiveMetricsFormat::Snapshot snapshot;
+    if (request.rfind("GET /metrics ", 0) != 0 && request.rfind("GET /metrics?", 0) != 0) {
+        status = "404 Not Found";
+        body = "Not found; metrics are at /metrics\n";
+    } else if (!reader.read(snapshot)) {
+        status = "503 Service Unavailable";
+        body = "Snapshot busy\n";
+    } else {
+        body = formatPrometheus(snapshot);
+    }
+
+    const std::string header = std::string("HTTP/1.1 ") + status +
+        "\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\nContent-Length: " +
+        std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n";
+    sendAll(client, header);
+    sendAll(client, body);
+}
@@ -0,0 +1,79 @@
+#include "MetricsPublisher.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+
+namespace {
+    LiveMetricsFormat::Percentiles toPercentiles(const PercentileSummary& summary) {
+        return {summary.p50, summary.p90, summary.p99, summary.p999, summary.max};
+    }
+
+    double worstValue(const RollupHistory& history) {
+        return history.empty() ? 0.0 : history.findWorst().bucket.max;
+    }
+}
+
+MetricsPublisher::MetricsPublisher(const std::string& name)
+    : name(name),
+      segment(name, SharedSegment::Mode::Create, sizeof(LiveMetricsFormat::Segment)),
+      layout(static_cast<LiveMetricsFormat::Segment*>(segment.data())) {
+    // Readers check the header, so it goes in before the first snapshot
+    LiveMetricsFormat::store(*layout, snapshot);
+    layout->version = LiveMetricsFormat::VERSION;
+    layout->snapshotBytes = sizeof(LiveMetricsFormat::Snapshot);
+    std::copy_n(LiveMetricsFormat::MAGIC, sizeof(layout->magic), layout->magic);
+}
+
+void MetricsPublisher::publish(const DeviceGroup& devices) {
+    const size_t count = std::min(devices.size(), LiveMetricsFormat::MAX_DEVICES);
+    snapshot.publishedUnixNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    ++snapshot.publishCount;
+    snapshot.deviceCount = count;
+
+    for (size_t i = 0; i < count; ++i) {
+        const CaptureDevice& source = devices[i];
+        const MetricsCollector& metrics = source.metrics;
+        LiveMetricsFormat::Device& device = snapshot.devices[i];
+
+        const size_t nameLength = std::min(source.name.size(), LiveMetricsFormat::NAME_BYTES - 1);
+        std::fill(std::copy_n(source.name.data(), nameLength, device.name),
+                  device.name + LiveMetricsFormat::NAME_BYTES, '\0');
+
+        const ButtonCounts& buttons = metrics.getButtonCounts();
+        device.intervals = metrics.getIntervalHistogram().getTotalCount();
+        device.latencySamples = metrics.getLatencyHistogram().getTotalCount();
+        device.clicks = buttons.clicks;
+        device.chatter = buttons.chatter;
+        device.doubleClicks = buttons.doubleClicks;
+        device.droppedEvents = source.capture.getDroppedEvents();
+
+        device.latencyCurrentMs = metrics.getCurrentLatency();
+        device.latencyAverageMs = metrics.getAverageLatency();
+        device.latencyMinMs = metrics.getMinLatency();
+        device.latencyMaxMs = metrics.getMaxLatency();
+        device.latencyStdDevMs = metrics.getLatencyStdDev();
+        device.pollingCurrentHz = metrics.getCurrentPollingRate();
+        device.pollingAverageHz = metrics.getAveragePollingRate();
+        device.pollingStdDevHz = metrics.getPollingRateStdDev();
+        device.speedCurrent = metrics.getCurrentMovementSpeed();
+        device.speedAverage = metrics.getAverageMovementSpeed();
+
+        const PollingEstimate& polling = metrics.getPollingEstimate();
+        device.nominalHz = polling.nominalRateHz;
+        device.fittedHz = polling.rateHz;
+        device.missedFraction = polling.missedFraction;
+        device.duplicateFraction = polling.duplicateFraction;
+        device.jitterUs = polling.jitterUs;
+
+        device.latencyUs = toPercentiles(metrics.getLatencyPercentiles());
+        device.intervalUs = toPercentiles(metrics.getIntervalPercentiles());
+        device.pressDurationUs = toPercentiles(metrics.getPressDurationPercentiles());
+        device.worstIntervalUs = worstValue(metrics.getIntervalHistory());
+        device.worstLatencyUs = worstValue(metrics.getLatencyHistory());
+    }
+
+    // Only the devices in use cross the seqlock
+    LiveMetricsFormat::store(*layout, snapshot, offsetof(LiveMetricsFormat::Snapshot, devices) +
+                                                count * sizeof(LiveMetricsFormat::Device));
+}
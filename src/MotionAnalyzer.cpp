@@ -0,0 +1,171 @@
+#include "MotionAnalyzer.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr double MIN_STROKE_COUNTS = 50.0;      // Shorter strokes are tremor, not movement
+    constexpr double MIN_AXIS_STROKE = 200.0;       // Snapping is only judged on longer strokes
+    constexpr double AXIS_ANGLE = 10.0 * 3.14159265358979 / 180.0;
+    constexpr double SNAP_TOLERANCE = 1.0;          // Counts off the axis a snapped stroke may wander
+
+    // A report mistracks when it reverses the filtered motion or carries less
+    // than a quarter (or more than four times) the counts the filter expects.
+    // Only judged where the filter expects enough counts for that to be clear.
+    constexpr double FAULT_RATIO = 0.25;
+    constexpr double FAULT_MIN_COUNTS = 4.0;
+    constexpr double FAULT_RATE_LIMIT = 0.01;
+    constexpr std::uint64_t MIN_BAND_SAMPLES = 200;
+    constexpr std::uint64_t MIN_BAND_STROKES = 3;
+
+    size_t bandIndex(double speed) {
+        const auto index = static_cast<size_t>(speed / Config::MOTION_SPEED_BAND);
+        return std::min(index, Config::MOTION_SPEED_BANDS - 1);
+    }
+}
+
+void MotionAnalyzer::process(std::span<const double> timestamps, std::span<const float> dx,
+                             std::span<const float> dy) {
+    for (size_t i = 0; i < timestamps.size(); ++i) add(timestamps[i] * 1e3, dx[i], dy[i]);
+    updateCpiAndMalfunction();
+}
+
+void MotionAnalyzer::clear() {
+    *this = MotionAnalyzer();
+}
+
+void MotionAnalyzer::add(double timeMs, float dx, float dy) {
+    // A pause ends the stroke and restarts the filter; a reversal only ends the stroke
+    if (lastTime >= 0.0 && timeMs - lastTime > Config::MOTION_GAP_MS) {
+        endStroke();
+        filled = 0;
+    } else if (static_cast<double>(dx) * strokeX + static_cast<double>(dy) * strokeY < 0.0) {
+        endStroke();
+    }
+    lastTime = timeMs;
+
+    strokeX += dx;
+    strokeY += dy;
+    strokeMinX = std::min(strokeMinX, strokeX);
+    strokeMaxX = std::max(strokeMaxX, strokeX);
+    strokeMinY = std::min(strokeMinY, strokeY);
+    strokeMaxY = std::max(strokeMaxY, strokeY);
+    strokePath += std::sqrt(static_cast<double>(dx) * dx + static_cast<double>(dy) * dy);
+
+    const size_t previous = (next + WINDOW - 1) % WINDOW;
+    times[next] = timeMs;
+    positionX[next] = (filled > 0 ? positionX[previous] : 0.0) + dx;
+    positionY[next] = (filled > 0 ? positionY[previous] : 0.0) + dy;
+    deltaX[next] = dx;
+    deltaY[next] = dy;
+    next = (next + 1) % WINDOW;
+    filled = std::min(filled + 1, static_cast<size_t>(WINDOW));
+
+    if (filled == WINDOW) filterCenter();
+}
+
+void MotionAnalyzer::filterCenter() {
+    // Quadratic x(t) = a + b t + c t^2 about the window's middle report;
+    // velocity is b and acceleration 2c
+    const size_t center = (next + Config::MOTION_FILTER_HALF_WIDTH) % WINDOW;
+    const double centerTime = times[center];
+
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0, s4 = 0;
+    double x0 = 0, x1 = 0, x2 = 0, y0 = 0, y1 = 0, y2 = 0;
+    for (size_t i = 0; i < WINDOW; ++i) {
+        const double t = times[i] - centerTime;
+        const double t2 = t * t;
+        const double x = positionX[i] - positionX[center];
+        const double y = positionY[i] - positionY[center];
+        s0 += 1.0; s1 += t; s2 += t2; s3 += t2 * t; s4 += t2 * t2;
+        x0 += x; x1 += x * t; x2 += x * t2;
+        y0 += y; y1 += y * t; y2 += y * t2;
+    }
+
+    // Cramer's rule on the 3x3 normal equations
+    const double det = s0 * (s2 * s4 - s3 * s3) - s1 * (s1 * s4 - s3 * s2) + s2 * (s1 * s3 - s2 * s2);
+    if (std::abs(det) < 1e-12) return;
+    auto slope = [&](double r0, double r1, double r2) {
+        return (s0 * (r1 * s4 - s3 * r2) - r0 * (s1 * s4 - s3 * s2) + s2 * (s1 * r2 - r1 * s2)) / det;
+    };
+    auto curvature = [&](double r0, double r1, double r2) {
+        return (s0 * (s2 * r2 - r1 * s3) - s1 * (s1 * r2 - r1 * s2) + r0 * (s1 * s3 - s2 * s2)) / det;
+    };
+
+    const double vx = slope(x0, x1, x2), vy = slope(y0, y1, y2);
+    const double ax = 2.0 * curvature(x0, x1, x2), ay = 2.0 * curvature(y0, y1, y2);
+    const double speed = std::hypot(vx, vy);
+    const double acceleration = speed > 0.0 ? (vx * ax + vy * ay) / speed : std::hypot(ax, ay);
+
+    summary.speed = speed;
+    summary.acceleration = acceleration;
+    summary.peakSpeed = std::max(summary.peakSpeed, speed);
+    summary.peakAcceleration = std::max(summary.peakAcceleration, std::abs(acceleration));
+    strokePeakSpeed = std::max(strokePeakSpeed, speed);
+
+    // Judge the middle report's raw counts against what the filter expects
+    const double interval = centerTime - times[(center + WINDOW - 1) % WINDOW];
+    const double expected = speed * interval;
+    if (expected < FAULT_MIN_COUNTS) return;
+
+    const double rawX = deltaX[center], rawY = deltaY[center];
+    const double raw = std::hypot(rawX, rawY);
+    const bool fault = rawX * vx + rawY * vy < 0.0 || raw < expected * FAULT_RATIO || raw > expected / FAULT_RATIO;
+
+    SpeedBand& band = bands[bandIndex(speed)];
+    ++band.samples;
+    if (fault) ++band.faults;
+    else summary.maxTrackedSpeed = std::max(summary.maxTrackedSpeed, speed);
+}
+
+void MotionAnalyzer::endStroke() {
+    const double chord = std::hypot(strokeX, strokeY);
+    if (strokePath >= MIN_STROKE_COUNTS) {
+        ++summary.strokes;
+        pathSum += strokePath;
+        chordSum += chord;
+        summary.straightness = chordSum / pathSum;
+
+        // Near-axis strokes that never leave the axis are what angle snapping produces;
+        // a hand drifts by more than a count over a long stroke
+        const double major = std::max(std::abs(strokeX), std::abs(strokeY));
+        const double minor = std::min(std::abs(strokeX), std::abs(strokeY));
+        if (chord >= MIN_AXIS_STROKE && std::atan2(minor, major) <= AXIS_ANGLE) {
+            ++summary.axisStrokes;
+            const double wander = std::abs(strokeX) >= std::abs(strokeY) ? strokeMaxY - strokeMinY
+                                                                         : strokeMaxX - strokeMinX;
+            if (wander <= SNAP_TOLERANCE) ++summary.snappedStrokes;
+        }
+
+        if (strokePeakSpeed > 0.0) {
+            SpeedBand& band = bands[bandIndex(strokePeakSpeed)];
+            ++band.strokes;
+            band.chordSum += chord;
+        }
+    }
+
+    strokeX = strokeY = 0.0;
+    strokeMinX = strokeMaxX = strokeMinY = strokeMaxY = 0.0;
+    strokePath = 0.0;
+    strokePeakSpeed = 0.0;
+}
+
+void MotionAnalyzer::updateCpiAndMalfunction() {
+    double reference = 0.0;
+    summary.cpiDeviation = 0.0;
+    for (const SpeedBand& band : bands) {
+        if (band.strokes < MIN_BAND_STROKES) continue;
+        const double counts = band.chordSum / static_cast<double>(band.strokes);
+        if (reference == 0.0) reference = counts;
+        else summary.cpiDeviation = std::max(summary.cpiDeviation, std::abs(counts / reference - 1.0));
+    }
+
+    summary.malfunctionSpeed = 0.0;
+    for (size_t i = 0; i < bands.size(); ++i) {
+        const SpeedBand& band = bands[i];
+        if (band.samples >= MIN_BAND_SAMPLES &&
+            static_cast<double>(band.faults) > FAULT_RATE_LIMIT * static_cast<double>(band.samples)) {
+            summary.malfunctionSpeed = static_cast<double>(i) * Config::MOTION_SPEED_BAND;
+            break;
+        }
+    }
+}
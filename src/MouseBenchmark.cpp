@@ -1,11 +1,132 @@
 #include "MouseBenchmark.hpp"
-#include <sstream>
+#include "Clock.hpp"
+#include <algorithm>
+#include <cmath>
 #include <iomanip>
+#include <initializer_list>
+#include <type_traits>
 
-MouseBenchmark::MouseBenchmark() : currentState(TestState::MENU), vsyncEnabled(false) {
+namespace {
+    using OverlayValue = StatsOverlay::Value;
+
+    // Overlay lines, in display order
+    enum MenuLine : size_t {
+        MenuTitle, MenuGap1, MenuLatency, MenuPolling, MenuMovement, MenuCombined, MenuPipeline, MenuVsync, MenuDevice,
+        MenuReset, MenuExit,
+        MenuGap2,
+        MenuPerformance, MenuFps, MenuFrameTime, MenuFrameWork, MenuLineCount
+    };
+
+    constexpr const char* MENU_LABELS[MenuLineCount] = {
+        "Advanced Mouse Benchmark Tool", "",
+        "1: Latency Test", "2: Polling Rate Test", "3: Movement Test", "4: Combined Test (All Metrics)",
+        "5: Pipeline Latency (Tool Overhead)",
+        "V: Toggle VSync (Currently: ", "Tab: Next Device (Currently: ", "R: Reset Statistics",
+        "ESC: Exit", "",
+        "Current Performance:", "FPS: ", "Frame Time P50/P99/Max: ", "Frame Work P50/P99/Max: "
+    };
+
+    enum StatsLine : size_t {
+        StatsTitle, StatsGap1,
+        LatencyHeader, LatencyCurrent, LatencyAverage, LatencyMin, LatencyMax, LatencyStdDev,
+        LatencyPercentiles, LatencySessionMax, ButtonClicks, PressDuration, ReactionTime, StatsGap2,
+        PollingHeader, PollingCurrent, PollingAverage, PollingStdDev, IntervalPercentiles, IntervalMax,
+        PollingNominal, PollingMissed, PollingJitter, IntervalHistory, StatsGap3,
+        MovementHeader, SpeedCurrent, SpeedAverage, SpeedFiltered, Straightness, AngleSnapping, CpiDeviation,
+        TrackingLimit, StatsGap4,
+        StatsFps, StatsFrameTime, StatsFrameWork, StatsGap5,
+        DevicesHeader, StatsLineCount
+    };
+
+    constexpr const char* STATS_LABELS[StatsLineCount] = {
+        "", "",
+        "Click Latency (Receipt to Handling):", "  Current: ", "  Average: ", "  Min: ", "  Max: ", "  Std Dev: ",
+        "  P50/P90/P99/P99.9: ", "  Session Max: ", "  Clicks (Chatter / Double-Click Faults): ",
+        "  Press Duration P50/P99: ", "  Reaction P50/P99 (Targets Hit): ", "",
+        "Polling Rate:", "  Current: ", "  Average: ", "  Std Dev: ", "  Interval P50/P90/P99/P99.9: ",
+        "  Interval Max: ", "  Nominal (Fitted): ", "  Missed / Duplicate: ", "  Jitter: ",
+        "  History (Arrows, W: Worst, Home): ", "",
+        "Movement:", "  Current Speed: ", "  Average Speed: ", "  Filtered Speed / Accel: ", "  Straightness: ",
+        "  Angle Snapping (Held / Near-Axis): ", "  CPI Deviation Across Speeds: ", "  Max Tracked / Mistracking: ", "",
+        "FPS: ", "Frame Time P50/P99/Max: ", "Frame Work P50/P99/Max: ", "",
+        "Devices (rate / latency / reports):"
+    };
+
+    enum PipelineLine : size_t {
+        PipelineTitle, PipelineGap1, PipelineHeader,
+        PipelineRead, PipelineDequeue, PipelineMetrics, PipelineFrame, PipelinePresent, PipelineGap2,
+        PipelineToMetric, PipelineToPresent, PipelineGap3,
+        PipelineSpans, PipelineFrameTime, PipelineFrameWork, PipelineLineCount
+    };
+
+    constexpr const char* PIPELINE_LABELS[PipelineLineCount] = {
+        "Pipeline Latency (Press ESC to exit)", "", "Per batch, oldest event; P50 / P99 / Max (Batches):",
+        "  Report to Read: ", "  Read to Dequeue: ", "  Dequeue to Metrics: ", "  Metrics to Frame: ",
+        "  Frame to Present: ", "",
+        "  Input to Metric: ", "  Input to Present: ", "",
+        "Spans Collected / Dropped: ", "Frame Time P50/P99/Max: ", "Frame Work P50/P99/Max: "
+    };
+
+    void setLatency(StatsOverlay& overlay, size_t line, const Histogram& histogram) {
+        OverlayValue text;
+        if (histogram.getTotalCount() == 0) {
+            overlay.setValue(line, text.append("-"));
+            return;
+        }
+        const auto summary = histogram.summarize();
+        text.append(summary.p50 / 1000.0, 1).append(" / ").append(summary.p99 / 1000.0, 1).append(" / ")
+            .append(summary.max / 1000.0, 1).append(" us (")
+            .append(static_cast<std::int64_t>(histogram.getTotalCount())).append(")");
+        overlay.setValue(line, text);
+    }
+
+    void setNumber(StatsOverlay& overlay, size_t line, double value, std::string_view unit) {
+        OverlayValue text;
+        text.append(value, 2).append(unit);
+        overlay.setValue(line, text);
+    }
+
+    // Lines of a metric the current test's pipeline doesn't collect
+    void setUncollected(StatsOverlay& overlay, size_t first, size_t last) {
+        OverlayValue text;
+        text.append("-");
+        for (size_t line = first; line <= last; ++line) overlay.setValue(line, text);
+    }
+
+    template<typename Metrics, typename Stage>
+    constexpr bool COLLECTS = std::remove_cvref_t<Metrics>::template HAS_STAGE<Stage>;
+
+    void setSeries(StatsOverlay& overlay, size_t line, std::initializer_list<double> values, std::string_view unit) {
+        OverlayValue text;
+        for (const double value : values) {
+            if (text.size() > 0) text.append(" / ");
+            text.append(value, 2);
+        }
+        overlay.setValue(line, text.append(unit));
+    }
+}
+
+MouseBenchmark::MouseBenchmark(std::unique_ptr<InputSource> source, double targetFrameRate)
+    : MouseBenchmark([&] {
+          DeviceGroup group;
+          group.add("Mouse", std::move(source));
+          return group;
+      }(), targetFrameRate) {}
+
+MouseBenchmark::MouseBenchmark(DeviceGroup group, double targetFrameRate)
+    : currentState(TestState::MENU), vsyncEnabled(false),
+      scheduler(targetFrameRate), targetFrameRate(targetFrameRate),
+      devices(std::move(group)),
+      latencyGraph(sf::Vector2f(Config::GRAPH_WIDTH, Config::GRAPH_HEIGHT), Config::LATENCY_COLOR),
+      pollingGraph(sf::Vector2f(Config::GRAPH_WIDTH, Config::GRAPH_HEIGHT), Config::POLLING_COLOR, 1000.0f),
+      movementGraph(sf::Vector2f(Config::GRAPH_WIDTH, Config::GRAPH_HEIGHT), Config::MOVEMENT_COLOR, 1000.0f),
+      historyGraph(sf::Vector2f(Config::GRAPH_WIDTH, Config::GRAPH_HEIGHT), Config::POLLING_COLOR),
+      historyColumns(Config::DISPLAY_POINTS) {
     initializeWindow();
     initializeUI();
     generateClickTargets();
+    devices.setTrace(&trace);
+    devices.start();
 }
 
 void MouseBenchmark::initializeWindow() {
@@ -21,35 +142,59 @@ void MouseBenchmark::initializeUI() {
         throw std::runtime_error("Failed to load font");
     }
 
-    menuText.setFont(font);
-    menuText.setCharacterSize(Config::MENU_TEXT_SIZE);
-    menuText.setFillColor(Config::TEXT_COLOR);
-    menuText.setPosition(20, 20);
+    // Labels are laid out once; only values are touched afterwards
+    menuOverlay.setStyle(font, Config::MENU_TEXT_SIZE, Config::TEXT_COLOR);
+    for (const char* label : MENU_LABELS) menuOverlay.addLine(label);
+    menuOverlay.setPosition(20, 20);
 
-    statsText.setFont(font);
-    statsText.setCharacterSize(Config::STATS_TEXT_SIZE);
-    statsText.setFillColor(Config::TEXT_COLOR);
-    statsText.setPosition(20, Config::WINDOW_HEIGHT - 150);
+    statsOverlay.setStyle(font, Config::STATS_TEXT_SIZE, Config::TEXT_COLOR);
+    for (const char* label : STATS_LABELS) statsOverlay.addLine(label);
+    for (size_t i = 0; i < devices.size(); ++i) {
+        deviceLines.push_back(statsOverlay.addLine("  " + devices[i].name + ": "));
+    }
+
+    pipelineOverlay.setStyle(font, Config::STATS_TEXT_SIZE, Config::TEXT_COLOR);
+    for (const char* label : PIPELINE_LABELS) pipelineOverlay.addLine(label);
+    pipelineOverlay.setPosition(20, 20);
+
+    trail.reserve(Config::MAX_MEASUREMENTS);
 }
 
 void MouseBenchmark::generateClickTargets() {
     clickTargets.clear();
     for (size_t i = 0; i < Config::NUM_CLICK_TARGETS; ++i) {
-        sf::RectangleShape target(sf::Vector2f(Config::TARGET_SIZE, Config::TARGET_SIZE));
-        target.setFillColor(Config::LATENCY_COLOR);
-        target.setPosition(
-            static_cast<float>(rand() % (Config::WINDOW_WIDTH - static_cast<int>(Config::TARGET_SIZE))),
-            static_cast<float>(rand() % (Config::WINDOW_HEIGHT - static_cast<int>(Config::TARGET_SIZE)))
-        );
+        ClickTarget target;
+        target.shape.setSize(sf::Vector2f(Config::TARGET_SIZE, Config::TARGET_SIZE));
+        target.shape.setFillColor(Config::LATENCY_COLOR);
+        placeTarget(target);
         clickTargets.push_back(target);
     }
 }
 
+void MouseBenchmark::placeTarget(ClickTarget& target) {
+    target.shape.setPosition(
+        static_cast<float>(rand() % (Config::WINDOW_WIDTH - static_cast<int>(Config::TARGET_SIZE))),
+        static_cast<float>(rand() % (Config::WINDOW_HEIGHT - static_cast<int>(Config::TARGET_SIZE)))
+    );
+    target.shownNs = 0;
+}
+
 void MouseBenchmark::run() {
+    frameTrace = &trace.threadBuffer("Consumer");
+    lastFrameNs = scheduler.waitForNextFrame();
     while (window.isOpen()) {
+        const std::int64_t frameStart = scheduler.waitForNextFrame();
+        frameSeconds = static_cast<double>(frameStart - lastFrameNs) * 1e-9;
+        frameTimeHistogram.record((frameStart - lastFrameNs) / 1000);
+        lastFrameNs = frameStart;
+
+        if (textCadence.due(frameStart)) refreshText = true;
+
         handleEvents();
         update();
         render();
+
+        frameWorkHistogram.record((Clock::nowNs() - frameStart) / 1000);
     }
 }
 
@@ -63,12 +208,6 @@ void MouseBenchmark::handleEvents() {
             case sf::Event::KeyPressed:
                 handleKeyPress(event.key);
                 break;
-            case sf::Event::MouseButtonPressed:
-                handleMouseClick(event.mouseButton);
-                break;
-            case sf::Event::MouseMoved:
-                handleMouseMove(event.mouseMove);
-                break;
             default:
                 break;
         }
@@ -76,53 +215,167 @@ void MouseBenchmark::handleEvents() {
 }
 
 void MouseBenchmark::handleKeyPress(const sf::Event::KeyEvent& key) {
+    refreshText = true;
     switch (key.code) {
         case sf::Keyboard::Escape:
             window.close();
             break;
         case sf::Keyboard::Num1:
             currentState = TestState::LATENCY_TEST;
+            // Reaction times start from the frame that shows the targets again
+            for (auto& target : clickTargets) target.shownNs = 0;
+            focusMetrics();
             break;
         case sf::Keyboard::Num2:
             currentState = TestState::POLLING_RATE_TEST;
+            focusMetrics();
             break;
         case sf::Keyboard::Num3:
             currentState = TestState::MOVEMENT_TEST;
+            focusMetrics();
             break;
         case sf::Keyboard::Num4:
             currentState = TestState::COMBINED_TEST;
+            focusMetrics();
+            break;
+        case sf::Keyboard::Num5:
+            currentState = TestState::PIPELINE_VIEW;
+            focusMetrics();
+            break;
+        case sf::Keyboard::Tab:
+            selectNextDevice();
+            break;
+        case sf::Keyboard::R:
+            resetStatistics();
+            break;
+        case sf::Keyboard::Up:
+            if (currentState == TestState::POLLING_RATE_TEST) zoomHistory(0.5);
+            break;
+        case sf::Keyboard::Down:
+            if (currentState == TestState::POLLING_RATE_TEST) zoomHistory(2.0);
+            break;
+        case sf::Keyboard::Left:
+            if (currentState == TestState::POLLING_RATE_TEST) panHistory(-0.25);
+            break;
+        case sf::Keyboard::Right:
+            if (currentState == TestState::POLLING_RATE_TEST) panHistory(0.25);
+            break;
+        case sf::Keyboard::W:
+            if (currentState == TestState::POLLING_RATE_TEST) showWorstInterval();
+            break;
+        case sf::Keyboard::Home:
+            historyFollows = true;
             break;
         case sf::Keyboard::V:
             vsyncEnabled = !vsyncEnabled;
             window.setVerticalSyncEnabled(vsyncEnabled);
+            // Vsync paces the loop itself; the scheduler would only add latency
+            scheduler.setTargetRate(vsyncEnabled ? 0.0 : targetFrameRate);
             break;
         default:
             break;
     }
 }
 
-void MouseBenchmark::handleMouseClick(const sf::Event::MouseButtonEvent& mouse) {
-    double timestamp = timer.getTime();
-    double latency = timer.getDeltaTime() * 1000.0; // Convert to milliseconds
-    metrics.addLatencyMeasurement(timestamp, latency);
+void MouseBenchmark::focusMetrics() {
+    // A single-metric test feeds only its own pipeline, unless a publisher or the
+    // export summary needs every metric
+    MetricFocus focus = MetricFocus::All;
+    if (!publisher && !devices.getExporter()) {
+        if (currentState == TestState::LATENCY_TEST) focus = MetricFocus::Latency;
+        else if (currentState == TestState::POLLING_RATE_TEST) focus = MetricFocus::Polling;
+        else if (currentState == TestState::MOVEMENT_TEST) focus = MetricFocus::Movement;
+    }
+    if (focus == devices.getFocus()) return;
+
+    devices.setFocus(focus);
+    handledPresses = selectedPressCount();
+    historyFollows = true;
+    // Rebind the graphs to the new pipeline's envelopes on the next frame
+    graphCadence = Cadence(Config::GRAPH_UPDATE_RATE);
 }
 
-void MouseBenchmark::handleMouseMove(const sf::Event::MouseMoveEvent& mouse) {
-    double timestamp = timer.getTime();
-    double interval = timer.getDeltaTime() * 1000.0; // Convert to milliseconds
-    sf::Vector2f currentPos(static_cast<float>(mouse.x), static_cast<float>(mouse.y));
-    
-    metrics.addPollingMeasurement(timestamp, interval, currentPos);
-    
-    const auto& movementData = metrics.getMovementData();
-    if (!movementData.empty()) {
-        float velocity = Utils::calculateDistance(movementData.back().position, currentPos) / interval;
-        metrics.addMovementMeasurement(timestamp, currentPos, velocity);
-    }
+const RollupHistory* MouseBenchmark::selectedIntervalHistory() const {
+    return visitSelected([](const auto& metrics) -> const RollupHistory* {
+        if constexpr (COLLECTS<decltype(metrics), IntervalHistogramStage>) return &metrics.getIntervalHistory();
+        else return nullptr;
+    });
+}
+
+std::uint64_t MouseBenchmark::selectedPressCount() const {
+    return visitSelected([](const auto& metrics) -> std::uint64_t {
+        if constexpr (COLLECTS<decltype(metrics), ButtonStage>) return metrics.getPressCount();
+        else return 0;
+    });
 }
 
 void MouseBenchmark::update() {
-    metrics.update();
+    // Mouse events are timestamped on each device's capture thread; here we only consume them
+    devices.drain();
+    hitTestPresses();
+    trace.collect();
+
+    // Window stats and percentiles are only read by the text overlay and the publisher
+    const bool publishing = publisher && publishCadence.due(lastFrameNs);
+    if (refreshText || publishing) devices.update();
+    if (publishing) publisher->publish(devices);
+
+    if (graphCadence.due(lastFrameNs)) {
+        visitSelected([&](const auto& metrics) {
+            using Metrics = decltype(metrics);
+            if constexpr (COLLECTS<Metrics, LatencyStage>) latencyGraph.update(metrics.getLatencyEnvelope());
+            if constexpr (COLLECTS<Metrics, PollingStage>) pollingGraph.update(metrics.getPollingRateEnvelope());
+            if constexpr (COLLECTS<Metrics, MovementStage>) movementGraph.update(metrics.getMovementEnvelope());
+        });
+        if (currentState == TestState::POLLING_RATE_TEST) updateHistoryGraph();
+    }
+}
+
+void MouseBenchmark::updateHistoryGraph() {
+    // Rendering picks the level to draw from, so any zoom costs the same
+    const RollupHistory* history = selectedIntervalHistory();
+    if (!history) return;
+    if (historyFollows) {
+        historyFromNs = history->getStartNs();
+        historyToNs = std::max(history->getEndNs() + 1, historyFromNs + Config::HISTORY_MIN_SPAN_NS);
+    }
+    historyLevel = history->render(historyFromNs, historyToNs, historyColumns);
+    historyGraph.update(historyColumns);
+}
+
+void MouseBenchmark::zoomHistory(double factor) {
+    const RollupHistory* history = selectedIntervalHistory();
+    if (!history) return;
+    const std::int64_t center = historyFromNs + (historyToNs - historyFromNs) / 2;
+    const auto span = std::max(static_cast<std::int64_t>(static_cast<double>(historyToNs - historyFromNs) * factor),
+                               Config::HISTORY_MIN_SPAN_NS);
+    // Zooming out past the session goes back to following it
+    historyFollows = span > history->getEndNs() - history->getStartNs();
+    historyFromNs = center - span / 2;
+    historyToNs = historyFromNs + span;
+    graphCadence = Cadence(Config::GRAPH_UPDATE_RATE);
+}
+
+void MouseBenchmark::panHistory(double fraction) {
+    const auto shift = static_cast<std::int64_t>(static_cast<double>(historyToNs - historyFromNs) * fraction);
+    historyFollows = false;
+    historyFromNs += shift;
+    historyToNs += shift;
+    graphCadence = Cadence(Config::GRAPH_UPDATE_RATE);
+}
+
+void MouseBenchmark::showWorstInterval() {
+    const RollupHistory* history = selectedIntervalHistory();
+    if (!history) return;
+    const RollupSpan worst = history->findWorst();
+    if (worst.bucket.count == 0) return;
+
+    // Centre the bucket (or the raw report) with some of its neighbours around it
+    const std::int64_t span = std::max(4 * (worst.endNs - worst.startNs), Config::HISTORY_WORST_SPAN_NS);
+    historyFollows = false;
+    historyFromNs = worst.startNs + (worst.endNs - worst.startNs) / 2 - span / 2;
+    historyToNs = historyFromNs + span;
+    graphCadence = Cadence(Config::GRAPH_UPDATE_RATE);
 }
 
 void MouseBenchmark::render() {
@@ -144,137 +397,313 @@ void MouseBenchmark::render() {
         case TestState::MOVEMENT_TEST:
             drawMovementTest();
             break;
+        case TestState::PIPELINE_VIEW:
+            drawPipelineView();
+            break;
     }
 
+    // Everything drained this frame is in it; frames without new input aren't traced
+    const TraceBacklog backlog = devices.takeTraceBacklog();
+    const std::int64_t drawnNs = backlog.events > 0 ? Clock::nowNs() : 0;
+
     window.display();
+
+    const bool tracing = frameTrace && backlog.events > 0;
+    if (!tracing && currentState != TestState::LATENCY_TEST) return;
+    const std::int64_t shownNs = Clock::nowNs();
+    if (tracing) {
+        frameTrace->record({backlog.originNs, backlog.ingestedNs, drawnNs, backlog.events,
+                            TraceStage::Frame, TraceSpan::NO_DEVICE});
+        frameTrace->record({backlog.originNs, drawnNs, shownNs, backlog.events,
+                            TraceStage::Present, TraceSpan::NO_DEVICE});
+    }
+    if (currentState == TestState::LATENCY_TEST) {
+        for (auto& target : clickTargets) {
+            if (target.shownNs == 0) target.shownNs = shownNs;
+        }
+    }
 }
 
-void MouseBenchmark::drawMenu() {
-    std::stringstream ss;
-    ss << "Advanced Mouse Benchmark Tool\n\n"
-       << "1: Latency Test\n"
-       << "2: Polling Rate Test\n"
-       << "3: Movement Test\n"
-       << "4: Combined Test (All Metrics)\n"
-       << "V: Toggle VSync (Currently: " << (vsyncEnabled ? "ON" : "OFF") << ")\n"
-       << "ESC: Exit\n\n"
-       << "Current Performance:\n"
-       << "FPS: " << static_cast<int>(1.0f / timer.getDeltaTime());
-    
-    menuText.setString(ss.str());
-    window.draw(menuText);
-}
-
-void MouseBenchmark::drawMetricsGraph(const std::vector<float>& data,
-                                    const sf::Vector2f& position,
-                                    float max,
-                                    const sf::Color& color) {
-    Utils::drawGraph(window, position, 
-                    sf::Vector2f(Config::GRAPH_WIDTH, Config::GRAPH_HEIGHT),
-                    data, 0, max, color);
-}
-
-void MouseBenchmark::updateStatsText(const std::string& title) {
-    std::stringstream ss;
-    ss << std::fixed << std::setprecision(2)
-       << title << " (Press ESC to exit)\n\n"
-       << "Latency:\n"
-       << "  Current: " << metrics.getCurrentLatency() << " ms\n"
-       << "  Average: " << metrics.getAverageLatency() << " ms\n"
-       << "  Min: " << metrics.getMinLatency() << " ms\n"
-       << "  Max: " << metrics.getMaxLatency() << " ms\n\n"
-       << "Polling Rate:\n"
-       << "  Current: " << metrics.getCurrentPollingRate() << " Hz\n"
-       << "  Average: " << metrics.getAveragePollingRate() << " Hz\n\n"
-       << "Movement:\n"
-       << "  Current Speed: " << metrics.getCurrentMovementSpeed() << " px/ms\n"
-       << "  Average Speed: " << metrics.getAverageMovementSpeed() << " px/ms\n"
-       << "\nFPS: " << static_cast<int>(1.0f / timer.getDeltaTime());
-    
-    statsText.setString(ss.str());
+void MouseBenchmark::hitTestPresses() {
+    const PressSamples* presses = visitSelected([](const auto& metrics) -> const PressSamples* {
+        if constexpr (COLLECTS<decltype(metrics), ButtonStage>) return &metrics.getRecentPresses();
+        else return nullptr;
+    });
+    if (!presses) return;
+    const std::uint64_t pressCount = selectedPressCount();
+    const auto fresh = static_cast<size_t>(std::min<std::uint64_t>(pressCount - handledPresses, presses->size()));
+    handledPresses = pressCount;
+    if (currentState != TestState::LATENCY_TEST || fresh == 0) return;
+
+    // Receipt times share the frame clock, unlike evdev's kernel timestamps
+    const auto received = presses->view<PressColumn::Received>().last(fresh);
+    const auto xs = presses->view<PressColumn::X>().last(fresh);
+    const auto ys = presses->view<PressColumn::Y>().last(fresh);
+    for (size_t i = 0; i < fresh; ++i) {
+        for (auto& target : clickTargets) {
+            if (target.shownNs == 0 || received[i] < target.shownNs) continue;
+            if (!target.shape.getGlobalBounds().contains(xs[i], ys[i])) continue;
+
+            const double reaction = static_cast<double>(received[i] - target.shownNs) * 1e-6;
+            target.reaction.add(reaction);
+            reactionHistogram.record(std::llround(reaction * 1000.0));
+            placeTarget(target);
+            refreshText = true;
+            break;
+        }
+    }
 }
 
-void MouseBenchmark::drawCombinedTest() {
-    // Convert measurement data to graph format
-    std::vector<float> latencyData;
-    for (const auto& data : metrics.getLatencyData()) {
-        latencyData.push_back(static_cast<float>(data.latency));
+void MouseBenchmark::drawMenu() {
+    if (refreshText) {
+        refreshText = false;
+
+        OverlayValue vsync;
+        menuOverlay.setValue(MenuVsync, vsync.append(vsyncEnabled ? "ON)" : "OFF)"));
+        OverlayValue device;
+        menuOverlay.setValue(MenuDevice, device.append(devices[selectedDevice].name).append(")"));
+        OverlayValue fps;
+        menuOverlay.setValue(MenuFps, fps.append(static_cast<std::int64_t>(currentFps())));
+        updateFrameStats(menuOverlay, MenuFrameTime, MenuFrameWork);
     }
-    
-    std::vector<float> pollingData;
-    for (const auto& data : metrics.getPollingData()) {
-        pollingData.push_back(static_cast<float>(1000.0 / data.interval));
+    window.draw(menuOverlay);
+}
+
+void MouseBenchmark::selectNextDevice() {
+    selectedDevice = (selectedDevice + 1) % devices.size();
+    handledPresses = selectedPressCount();
+    historyFollows = true;
+    // Rebind the graphs to the new device's envelopes on the next frame
+    graphCadence = Cadence(Config::GRAPH_UPDATE_RATE);
+}
+
+void MouseBenchmark::resetStatistics() {
+    // Every device's collectors, not just the focused ones, so no test resumes with old samples
+    devices.clear();
+    handledPresses = 0;
+    for (auto& target : clickTargets) target.reaction = RunningMoments{};
+    reactionHistogram.clear();
+    historyFollows = true;
+    // Redraw the emptied envelopes on the next frame
+    graphCadence = Cadence(Config::GRAPH_UPDATE_RATE);
+}
+
+int MouseBenchmark::currentFps() const {
+    return frameSeconds > 0.0 ? static_cast<int>(1.0 / frameSeconds) : 0;
+}
+
+void MouseBenchmark::writeFrameStats(std::ostream& out) const {
+    const auto frame = frameTimeHistogram.summarize();
+    const auto work = frameWorkHistogram.summarize();
+    out << std::fixed << std::setprecision(2)
+        << "Frame Time P50/P99/Max: " << frame.p50 / 1000.0 << " / " << frame.p99 / 1000.0 << " / "
+        << frame.max / 1000.0 << " ms\n"
+        << "Frame Work P50/P99/Max: " << work.p50 / 1000.0 << " / " << work.p99 / 1000.0 << " / "
+        << work.max / 1000.0 << " ms\n";
+}
+
+void MouseBenchmark::writeReactionStats(std::ostream& out) const {
+    if (reactionHistogram.getTotalCount() == 0) return;
+    const auto reaction = reactionHistogram.summarize();
+    out << std::fixed << std::setprecision(2)
+        << "Reaction P50/P99/Max: " << reaction.p50 / 1000.0 << " / " << reaction.p99 / 1000.0 << " / "
+        << reaction.max / 1000.0 << " ms over " << reactionHistogram.getTotalCount() << " hits\n";
+    for (size_t i = 0; i < clickTargets.size(); ++i) {
+        const RunningMoments& target = clickTargets[i].reaction;
+        out << "  Target " << i + 1 << ": " << target.count << " hits, average " << target.mean
+            << " ms, std dev " << target.stddev() << " ms\n";
     }
-    
-    std::vector<float> speedData;
-    for (const auto& data : metrics.getMovementData()) {
-        speedData.push_back(data.velocity);
+}
+
+void MouseBenchmark::updateFrameStats(StatsOverlay& overlay, size_t frameTimeLine, size_t frameWorkLine) {
+    const auto frame = frameTimeHistogram.summarize();
+    const auto work = frameWorkHistogram.summarize();
+    setSeries(overlay, frameTimeLine, {frame.p50 / 1000.0, frame.p99 / 1000.0, frame.max / 1000.0}, " ms");
+    setSeries(overlay, frameWorkLine, {work.p50 / 1000.0, work.p99 / 1000.0, work.max / 1000.0}, " ms");
+}
+
+void MouseBenchmark::updateStatsText(const char* title) {
+    // Refreshed at the text cadence, or at once when the view changes; only
+    // values that read differently are re-laid out
+    if (!refreshText) return;
+    refreshText = false;
+
+    OverlayValue heading;
+    heading.append(title);
+    if (devices.size() > 1) heading.append(" - ").append(devices[selectedDevice].name);
+    statsOverlay.setValue(StatsTitle, heading.append(" (Press ESC to exit)"));
+
+    // Sections the current test's pipeline doesn't collect read "-"
+    visitSelected([&](const auto& metrics) {
+        using Metrics = decltype(metrics);
+        if constexpr (COLLECTS<Metrics, LatencyStage>) {
+            const auto& latency = metrics.getLatencyPercentiles();
+            setNumber(statsOverlay, LatencyCurrent, metrics.getCurrentLatency(), " ms");
+            setNumber(statsOverlay, LatencyAverage, metrics.getAverageLatency(), " ms");
+            setNumber(statsOverlay, LatencyMin, metrics.getMinLatency(), " ms");
+            setNumber(statsOverlay, LatencyMax, metrics.getMaxLatency(), " ms");
+            setNumber(statsOverlay, LatencyStdDev, metrics.getLatencyStdDev(), " ms");
+            setSeries(statsOverlay, LatencyPercentiles, {latency.p50 / 1000.0, latency.p90 / 1000.0,
+                      latency.p99 / 1000.0, latency.p999 / 1000.0}, " ms");
+            setNumber(statsOverlay, LatencySessionMax, latency.max / 1000.0, " ms");
+        } else {
+            setUncollected(statsOverlay, LatencyCurrent, LatencySessionMax);
+        }
+
+        if constexpr (COLLECTS<Metrics, ButtonStage>) {
+            const ButtonCounts& buttons = metrics.getButtonCounts();
+            OverlayValue clicks;
+            clicks.append(static_cast<std::int64_t>(buttons.clicks)).append(" (")
+                  .append(static_cast<std::int64_t>(buttons.chatter)).append(" / ")
+                  .append(static_cast<std::int64_t>(buttons.doubleClicks)).append(")");
+            statsOverlay.setValue(ButtonClicks, clicks);
+            const auto& press = metrics.getPressDurationPercentiles();
+            setSeries(statsOverlay, PressDuration, {press.p50 / 1000.0, press.p99 / 1000.0}, " ms");
+        } else {
+            setUncollected(statsOverlay, ButtonClicks, PressDuration);
+        }
+
+        if constexpr (COLLECTS<Metrics, PollingStage>) {
+            setNumber(statsOverlay, PollingCurrent, metrics.getCurrentPollingRate(), " Hz");
+            setNumber(statsOverlay, PollingAverage, metrics.getAveragePollingRate(), " Hz");
+            setNumber(statsOverlay, PollingStdDev, metrics.getPollingRateStdDev(), " Hz");
+        } else {
+            setUncollected(statsOverlay, PollingCurrent, PollingStdDev);
+        }
+
+        if constexpr (COLLECTS<Metrics, IntervalHistogramStage>) {
+            const auto& interval = metrics.getIntervalPercentiles();
+            setSeries(statsOverlay, IntervalPercentiles, {static_cast<double>(interval.p50),
+                      static_cast<double>(interval.p90), static_cast<double>(interval.p99),
+                      static_cast<double>(interval.p999)}, " us");
+            setNumber(statsOverlay, IntervalMax, static_cast<double>(interval.max), " us");
+
+            const PollingEstimate& polling = metrics.getPollingEstimate();
+            OverlayValue nominal;
+            nominal.append(polling.nominalRateHz, 0).append(" Hz (").append(polling.rateHz, 2).append(" Hz)");
+            statsOverlay.setValue(PollingNominal, nominal);
+            setSeries(statsOverlay, PollingMissed, {polling.missedFraction * 100.0, polling.duplicateFraction * 100.0},
+                      " %");
+            setNumber(statsOverlay, PollingJitter, polling.jitterUs, " us");
+
+            const RollupHistory& history = metrics.getIntervalHistory();
+            const RollupSpan worst = history.findWorst();
+            OverlayValue historyText;
+            historyText.append(static_cast<double>(historyToNs - historyFromNs) * 1e-9, 3).append(" s at ");
+            if (historyLevel == 0) historyText.append("raw");
+            else historyText.append(static_cast<double>(history.getLevelWidthNs(historyLevel)) * 1e-6, 0).append(" ms");
+            historyText.append(", worst ").append(worst.bucket.max, 0).append(" us");
+            statsOverlay.setValue(IntervalHistory, historyText);
+        } else {
+            setUncollected(statsOverlay, IntervalPercentiles, IntervalHistory);
+        }
+
+        if constexpr (COLLECTS<Metrics, MovementStage>) {
+            setNumber(statsOverlay, SpeedCurrent, metrics.getCurrentMovementSpeed(), " counts/ms");
+            setNumber(statsOverlay, SpeedAverage, metrics.getAverageMovementSpeed(), " counts/ms");
+
+            const MotionSummary& motion = metrics.getMotionSummary();
+            setSeries(statsOverlay, SpeedFiltered, {motion.speed, motion.acceleration}, " counts/ms, /ms^2");
+            setNumber(statsOverlay, Straightness, motion.straightness, "");
+            OverlayValue snapping;
+            snapping.append(static_cast<std::int64_t>(motion.snappedStrokes)).append(" / ")
+                    .append(static_cast<std::int64_t>(motion.axisStrokes));
+            statsOverlay.setValue(AngleSnapping, snapping);
+            setNumber(statsOverlay, CpiDeviation, motion.cpiDeviation * 100.0, " %");
+            setSeries(statsOverlay, TrackingLimit, {motion.maxTrackedSpeed, motion.malfunctionSpeed}, " counts/ms");
+        } else {
+            setUncollected(statsOverlay, SpeedCurrent, TrackingLimit);
+        }
+    });
+
+    const auto reaction = reactionHistogram.summarize();
+    OverlayValue reactionText;
+    reactionText.append(reaction.p50 / 1000.0, 2).append(" / ").append(reaction.p99 / 1000.0, 2).append(" ms (")
+                .append(static_cast<std::int64_t>(reactionHistogram.getTotalCount())).append(")");
+    statsOverlay.setValue(ReactionTime, reactionText);
+
+    OverlayValue fps;
+    statsOverlay.setValue(StatsFps, fps.append(static_cast<std::int64_t>(currentFps())));
+    updateFrameStats(statsOverlay, StatsFrameTime, StatsFrameWork);
+
+    for (size_t i = 0; i < deviceLines.size(); ++i) {
+        OverlayValue row;
+        visitMetrics(devices[i], devices.getFocus(), [&](const auto& device) {
+            using Metrics = decltype(device);
+            if constexpr (COLLECTS<Metrics, PollingStage>) row.append(device.getAveragePollingRate(), 2);
+            else row.append("-");
+            row.append(" Hz / ");
+            if constexpr (COLLECTS<Metrics, LatencyStage>) row.append(device.getAverageLatency(), 2);
+            else row.append("-");
+            row.append(" ms / ");
+            if constexpr (COLLECTS<Metrics, IntervalHistogramStage>) {
+                row.append(static_cast<std::int64_t>(device.getIntervalHistogram().getTotalCount()));
+            } else {
+                row.append("-");
+            }
+        });
+        if (i == selectedDevice && devices.size() > 1) row.append("  <");
+        statsOverlay.setValue(deviceLines[i], row);
     }
+}
 
-    // Draw graphs
-    drawMetricsGraph(latencyData, 
-                    sf::Vector2f(Config::GRAPH_MARGIN, Config::GRAPH_MARGIN),
-                    static_cast<float>(metrics.getMaxLatency()),
-                    Config::LATENCY_COLOR);
-    
-    drawMetricsGraph(pollingData,
-                    sf::Vector2f(Config::GRAPH_WIDTH + Config::GRAPH_MARGIN * 2, Config::GRAPH_MARGIN),
-                    1000.0f,
-                    Config::POLLING_COLOR);
-    
-    drawMetricsGraph(speedData,
-                    sf::Vector2f(Config::GRAPH_MARGIN, Config::GRAPH_HEIGHT + Config::GRAPH_MARGIN * 2),
-                    1000.0f,
-                    Config::MOVEMENT_COLOR);
+void MouseBenchmark::drawCombinedTest() {
+    // Graphs are rebuilt in update(); drawing only places them
+    latencyGraph.setPosition(Config::GRAPH_MARGIN, Config::GRAPH_MARGIN);
+    window.draw(latencyGraph);
+
+    pollingGraph.setPosition(Config::GRAPH_WIDTH + Config::GRAPH_MARGIN * 2, Config::GRAPH_MARGIN);
+    window.draw(pollingGraph);
+
+    movementGraph.setPosition(Config::GRAPH_MARGIN, Config::GRAPH_HEIGHT + Config::GRAPH_MARGIN * 2);
+    window.draw(movementGraph);
 
     updateStatsText("Combined Test");
-    statsText.setPosition(Config::GRAPH_WIDTH + Config::GRAPH_MARGIN * 2, 
-                         Config::GRAPH_HEIGHT + Config::GRAPH_MARGIN * 2);
-    window.draw(statsText);
+    statsOverlay.setPosition(Config::GRAPH_WIDTH + Config::GRAPH_MARGIN * 2,
+                             Config::GRAPH_HEIGHT + Config::GRAPH_MARGIN * 2);
+    window.draw(statsOverlay);
 }
 
 void MouseBenchmark::drawLatencyTest() {
     for (const auto& target : clickTargets) {
-        window.draw(target);
-    }
-    
-    std::vector<float> data;
-    for (const auto& measurement : metrics.getLatencyData()) {
-        data.push_back(static_cast<float>(measurement.latency));
+        window.draw(target.shape);
     }
     
-    drawMetricsGraph(data,
-                    sf::Vector2f(Config::WINDOW_WIDTH - Config::GRAPH_WIDTH - 20, 50),
-                    static_cast<float>(metrics.getMaxLatency()),
-                    Config::LATENCY_COLOR);
+    latencyGraph.setPosition(Config::WINDOW_WIDTH - Config::GRAPH_WIDTH - 20, 50);
+    window.draw(latencyGraph);
     
     updateStatsText("Click Latency Test");
-    window.draw(statsText);
+    statsOverlay.setPosition(20, 20);
+    window.draw(statsOverlay);
 }
 
 void MouseBenchmark::drawPollingRateTest() {
-    std::vector<float> data;
-    for (const auto& measurement : metrics.getPollingData()) {
-        data.push_back(static_cast<float>(1000.0 / measurement.interval));
-    }
-    
-    drawMetricsGraph(data,
-                    sf::Vector2f(Config::WINDOW_WIDTH - Config::GRAPH_WIDTH - 20, 50),
-                    1000.0f,
-                    Config::POLLING_COLOR);
+    pollingGraph.setPosition(Config::WINDOW_WIDTH - Config::GRAPH_WIDTH - 20, 50);
+    window.draw(pollingGraph);
+
+    historyGraph.setPosition(Config::WINDOW_WIDTH - Config::GRAPH_WIDTH - 20, 50 + Config::GRAPH_HEIGHT + Config::GRAPH_MARGIN);
+    window.draw(historyGraph);
     
     updateStatsText("Polling Rate Test");
-    window.draw(statsText);
+    statsOverlay.setPosition(20, 20);
+    window.draw(statsOverlay);
 }
 
 void MouseBenchmark::drawMovementTest() {
-    const auto& movementData = metrics.getMovementData();
-    if (movementData.size() > 1) {
-        std::vector<sf::Vertex> trail(movementData.size());
-        for (size_t i = 0; i < movementData.size(); ++i) {
-            float alpha = static_cast<float>(i) / movementData.size();
+    const MovementSamples* movement = visitSelected([](const auto& metrics) -> const MovementSamples* {
+        if constexpr (COLLECTS<decltype(metrics), MovementStage>) return &metrics.getMovementSamples();
+        else return nullptr;
+    });
+    if (movement && movement->size() > 1) {
+        const MovementSamples& samples = *movement;
+        auto xs = samples.view<MovementColumn::X>();
+        auto ys = samples.view<MovementColumn::Y>();
+        // Reuses the reserved buffer; the window never exceeds MAX_MEASUREMENTS
+        trail.resize(samples.size());
+        for (size_t i = 0; i < samples.size(); ++i) {
+            float alpha = static_cast<float>(i) / samples.size();
             trail[i] = sf::Vertex(
-                movementData[i].position,
+                sf::Vector2f(xs[i], ys[i]),
                 sf::Color(Config::MOVEMENT_COLOR.r,
                          Config::MOVEMENT_COLOR.g,
                          Config::MOVEMENT_COLOR.b,
@@ -285,5 +714,26 @@ void MouseBenchmark::drawMovementTest() {
     }
     
     updateStatsText("Movement Test");
-    window.draw(statsText);
+    statsOverlay.setPosition(20, 20);
+    window.draw(statsOverlay);
+}
+
+void MouseBenchmark::drawPipelineView() {
+    if (refreshText) {
+        refreshText = false;
+        setLatency(pipelineOverlay, PipelineRead, trace.getStageHistogram(TraceStage::Read));
+        setLatency(pipelineOverlay, PipelineDequeue, trace.getStageHistogram(TraceStage::Dequeue));
+        setLatency(pipelineOverlay, PipelineMetrics, trace.getStageHistogram(TraceStage::Metrics));
+        setLatency(pipelineOverlay, PipelineFrame, trace.getStageHistogram(TraceStage::Frame));
+        setLatency(pipelineOverlay, PipelinePresent, trace.getStageHistogram(TraceStage::Present));
+        setLatency(pipelineOverlay, PipelineToMetric, trace.getInputToMetricHistogram());
+        setLatency(pipelineOverlay, PipelineToPresent, trace.getInputToPresentHistogram());
+
+        OverlayValue spans;
+        spans.append(static_cast<std::int64_t>(trace.getCollectedSpans())).append(" / ")
+             .append(static_cast<std::int64_t>(trace.getDroppedSpans()));
+        pipelineOverlay.setValue(PipelineSpans, spans);
+        updateFrameStats(pipelineOverlay, PipelineFrameTime, PipelineFrameWork);
+    }
+    window.draw(pipelineOverlay);
 }
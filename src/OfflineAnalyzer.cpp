@@ -0,0 +1,216 @@
+#include "OfflineAnalyzer.hpp"
+#include "CaptureFile.hpp"
+#include "SampleDeriver.hpp"
+#include "WorkStealingPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+
+namespace {
+    struct FileJob {
+        std::string path;
+        std::vector<std::unique_ptr<SessionStats>> partials;
+        std::atomic<std::size_t> remaining{0};
+        std::mutex errorMutex;
+        std::string error;
+    };
+
+    AnalysisSummary summarize(const std::string& name, const SessionStats& stats) {
+        AnalysisSummary summary;
+        summary.name = name;
+        summary.eventCount = stats.getEventCount();
+        summary.durationSeconds = stats.getDurationSeconds();
+        summary.pollingRate = stats.getPollingRate();
+        summary.interval = stats.getInterval();
+        summary.speed = stats.getSpeed();
+        summary.pressDuration = stats.getPressDuration();
+        summary.buttons = stats.getButtonCounts();
+        summary.intervalPercentiles = stats.getIntervalHistogram().summarize();
+        summary.pressDurationPercentiles = stats.getPressDurationHistogram().summarize();
+        return summary;
+    }
+
+    // Takes derived samples and drops them, to rebuild deriver state
+    struct DiscardSink {
+        void addLatencyMeasurement(double, double) {}
+        void addPollingMeasurement(double, double, float, float) {}
+        void addMovementMeasurement(double, float, float, float, std::int32_t, std::int32_t) {}
+        void addPressMeasurement(double, std::uint8_t, double) {}
+        void addButtonFault(double, std::uint8_t, ButtonFault) {}
+    };
+
+    void analyzeChunk(const std::string& path, std::size_t begin, std::size_t end, SessionStats& stats) {
+        CaptureReader reader(path);
+        const auto records = reader.getRecords();
+        end = std::min(end, records.size());
+
+        // Recreate the deriver state the preceding records would have left behind
+        SampleDeriver deriver;
+        if (begin > 0) {
+            std::int64_t lastMoveTime = -1;
+            for (std::size_t i = begin; i-- > 0;) {
+                if (records[i].type == static_cast<std::uint8_t>(InputEventType::Move)) {
+                    lastMoveTime = records[i].timestampNs;
+                    break;
+                }
+            }
+            deriver.seed(lastMoveTime);
+
+            // Clicks still open at the boundary started at most a maximal press earlier. A
+            // longer hold is a drag, and the deriver takes one whose press it never saw for
+            // a drag too. Samples of the warm-up belong to the chunk before.
+            const std::int64_t horizon = records[begin].timestampNs -
+                static_cast<std::int64_t>((Config::BUTTON_MAX_PRESS_MS + Config::BUTTON_DEBOUNCE_MS) * 1e6);
+            std::size_t warmup = begin;
+            while (warmup > 0 && records[warmup - 1].timestampNs >= horizon) --warmup;
+
+            DiscardSink discard;
+            for (std::size_t i = warmup; i < begin; ++i) {
+                deriver.process(CaptureFormat::toEvent(records[i]), discard);
+            }
+        }
+
+        for (std::size_t i = begin; i < end; ++i) {
+            const InputEvent event = CaptureFormat::toEvent(records[i]);
+            stats.countEvent(event.timestampNs);
+            deriver.process(event, stats);
+        }
+
+        // Only the file's end closes the clicks still open; a later chunk closes them otherwise
+        if (end == records.size()) deriver.flush(SampleDeriver::END_OF_STREAM, stats);
+    }
+}
+
+OfflineAnalyzer::OfflineAnalyzer(std::size_t threadCount, std::size_t chunkRecords)
+    : threadCount(std::max<std::size_t>(threadCount, 1)),
+      chunkRecords(std::max<std::size_t>(chunkRecords, 1)) {}
+
+std::vector<std::string> OfflineAnalyzer::collectCaptureFiles(const std::vector<std::string>& paths) {
+    std::vector<std::string> files;
+    for (const auto& path : paths) {
+        if (!std::filesystem::is_directory(path)) {
+            files.push_back(path);
+            continue;
+        }
+
+        std::vector<std::string> found;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(path)) {
+            if (entry.is_regular_file() && CaptureFormat::isCaptureFile(entry.path().string())) {
+                found.push_back(entry.path().string());
+            }
+        }
+        std::sort(found.begin(), found.end());
+        files.insert(files.end(), found.begin(), found.end());
+    }
+    return files;
+}
+
+AnalysisResult OfflineAnalyzer::analyze(const std::vector<std::string>& files) const {
+    AnalysisResult result;
+    result.files.resize(files.size());
+
+    std::vector<std::unique_ptr<FileJob>> jobs;
+    for (const auto& path : files) {
+        jobs.push_back(std::make_unique<FileJob>());
+        jobs.back()->path = path;
+    }
+
+    // Histogram merges are integer sums, so completion order doesn't matter
+    SessionStats corpusHistograms;
+    std::mutex corpusMutex;
+
+    WorkStealingPool pool(threadCount);
+
+    auto finishFile = [&](std::size_t fileIndex) {
+        FileJob& job = *jobs[fileIndex];
+        SessionStats merged;
+        for (const auto& partial : job.partials) {
+            if (partial) merged.merge(*partial);
+        }
+        job.partials.clear();
+
+        result.files[fileIndex] = summarize(job.path, merged);
+        result.files[fileIndex].error = job.error;
+
+        std::lock_guard<std::mutex> lock(corpusMutex);
+        corpusHistograms.merge(merged);
+    };
+
+    for (std::size_t fileIndex = 0; fileIndex < jobs.size(); ++fileIndex) {
+        pool.submit([&, fileIndex] {
+            FileJob& job = *jobs[fileIndex];
+            std::size_t recordCount = 0;
+            try {
+                recordCount = CaptureReader(job.path).getRecords().size();
+            } catch (const std::exception& e) {
+                job.error = e.what();
+                result.files[fileIndex].name = job.path;
+                result.files[fileIndex].error = job.error;
+                return;
+            }
+
+            const std::size_t chunkCount = std::max<std::size_t>(1, (recordCount + chunkRecords - 1) / chunkRecords);
+            job.partials.resize(chunkCount);
+            job.remaining.store(chunkCount, std::memory_order_release);
+
+            for (std::size_t chunk = 0; chunk < chunkCount; ++chunk) {
+                pool.submit([&, fileIndex, chunk] {
+                    FileJob& job = *jobs[fileIndex];
+                    try {
+                        auto stats = std::make_unique<SessionStats>();
+                        analyzeChunk(job.path, chunk * chunkRecords, (chunk + 1) * chunkRecords, *stats);
+                        job.partials[chunk] = std::move(stats);
+                    } catch (const std::exception& e) {
+                        std::lock_guard<std::mutex> lock(job.errorMutex);
+                        if (job.error.empty()) job.error = e.what();
+                    }
+
+                    // The last chunk to finish merges the file in chunk order
+                    if (job.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        finishFile(fileIndex);
+                    }
+                });
+            }
+        });
+    }
+    pool.wait();
+
+    // Moments are merged in input order so the aggregate is reproducible
+    AnalysisSummary& aggregate = result.aggregate;
+    aggregate.name = "aggregate";
+    for (const auto& file : result.files) {
+        if (!file.error.empty()) continue;
+        aggregate.eventCount += file.eventCount;
+        aggregate.durationSeconds += file.durationSeconds;
+        aggregate.pollingRate.merge(file.pollingRate);
+        aggregate.interval.merge(file.interval);
+        aggregate.speed.merge(file.speed);
+        aggregate.pressDuration.merge(file.pressDuration);
+        aggregate.buttons.merge(file.buttons);
+    }
+    aggregate.intervalPercentiles = corpusHistograms.getIntervalHistogram().summarize();
+    aggregate.pressDurationPercentiles = corpusHistograms.getPressDurationHistogram().summarize();
+    return result;
+}
+
+SessionStats OfflineAnalyzer::analyzeFile(const std::string& path) const {
+    const std::size_t recordCount = CaptureReader(path).getRecords().size();
+    const std::size_t chunkCount = std::max<std::size_t>(1, (recordCount + chunkRecords - 1) / chunkRecords);
+    std::vector<std::unique_ptr<SessionStats>> partials(chunkCount);
+
+    WorkStealingPool pool(std::min(threadCount, chunkCount));
+    for (std::size_t chunk = 0; chunk < chunkCount; ++chunk) {
+        pool.submit([&, chunk] {
+            auto stats = std::make_unique<SessionStats>();
+            analyzeChunk(path, chunk * chunkRecords, (chunk + 1) * chunkRecords, *stats);
+            partials[chunk] = std::move(stats);
+        });
+    }
+    pool.wait();
+
+    SessionStats merged;
+    for (const auto& partial : partials) merged.merge(*partial);
+    return merged;
+}
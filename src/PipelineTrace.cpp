@@ -0,0 +1,114 @@
+#include "PipelineTrace.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+
+namespace {
+    constexpr const char* STAGE_NAMES[] = {
+        "Report to Read", "Read to Dequeue", "Dequeue to Metrics", "Metrics to Frame", "Frame to Present"
+    };
+    static_assert(std::size(STAGE_NAMES) == static_cast<size_t>(TraceStage::Count));
+
+    Histogram makeHistogram() {
+        return Histogram(1, Config::TRACE_HIGHEST_NS, Config::HISTOGRAM_SIGNIFICANT_DIGITS);
+    }
+
+    void writeStage(std::ostream& out, const char* name, const Histogram& histogram) {
+        if (histogram.getTotalCount() == 0) return;
+        const auto summary = histogram.summarize();
+        out << "  " << name << ": " << summary.p50 / 1000.0 << " / " << summary.p99 / 1000.0 << " / "
+            << summary.max / 1000.0 << " us (" << histogram.getTotalCount() << ")\n";
+    }
+}
+
+const char* traceStageName(TraceStage stage) {
+    return STAGE_NAMES[static_cast<size_t>(stage)];
+}
+
+PipelineTrace::PipelineTrace()
+    : stages{makeHistogram(), makeHistogram(), makeHistogram(), makeHistogram(), makeHistogram()},
+      inputToMetric(makeHistogram()), inputToPresent(makeHistogram()) {}
+
+TraceBuffer& PipelineTrace::threadBuffer(const std::string& name) {
+    const std::lock_guard<std::mutex> lock(buffersMutex);
+    const auto self = std::this_thread::get_id();
+    for (auto& buffer : buffers) {
+        if (buffer->owner == self) return *buffer;
+    }
+    buffers.push_back(std::make_unique<TraceBuffer>(name));
+    return *buffers.back();
+}
+
+void PipelineTrace::retainSpans(size_t maxSpans) {
+    retainLimit = maxSpans;
+    retained.reserve(maxSpans);
+}
+
+void PipelineTrace::collect() {
+    const std::lock_guard<std::mutex> lock(buffersMutex);
+    TraceSpan batch[Config::INPUT_DRAIN_BATCH];
+    for (size_t thread = 0; thread < buffers.size(); ++thread) {
+        size_t count;
+        while ((count = buffers[thread]->spans.popBatch(batch, Config::INPUT_DRAIN_BATCH)) > 0) {
+            for (size_t i = 0; i < count; ++i) {
+                const TraceSpan& span = batch[i];
+                stages[static_cast<size_t>(span.stage)].record(span.endNs - span.startNs);
+                if (span.stage == TraceStage::Metrics) inputToMetric.record(span.endNs - span.originNs);
+                if (span.stage == TraceStage::Present) inputToPresent.record(span.endNs - span.originNs);
+
+                if (retained.size() < retainLimit) retained.push_back({span, static_cast<std::uint32_t>(thread)});
+                else if (retainLimit > 0) ++unretainedSpans;
+            }
+            collectedSpans += count;
+        }
+    }
+}
+
+std::uint64_t PipelineTrace::getDroppedSpans() const {
+    const std::lock_guard<std::mutex> lock(buffersMutex);
+    std::uint64_t dropped = 0;
+    for (const auto& buffer : buffers) dropped += buffer->dropped.load(std::memory_order_relaxed);
+    return dropped;
+}
+
+void PipelineTrace::writeSummary(std::ostream& out) const {
+    // Goes to stderr among other diagnostics, so leave the stream as it was
+    const auto flags = out.flags();
+    const auto precision = out.precision();
+    out << std::fixed << std::setprecision(2) << "Pipeline Latency P50/P99/Max (Spans):\n";
+    for (size_t i = 0; i < stages.size(); ++i) writeStage(out, STAGE_NAMES[i], stages[i]);
+    writeStage(out, "Input to Metric", inputToMetric);
+    writeStage(out, "Input to Present", inputToPresent);
+    out << "  Spans: " << collectedSpans << " collected, " << getDroppedSpans() << " dropped\n";
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void PipelineTrace::writeChromeTrace(std::ostream& out) const {
+    std::int64_t baseNs = std::numeric_limits<std::int64_t>::max();
+    for (const RetainedSpan& retainedSpan : retained) baseNs = std::min(baseNs, retainedSpan.span.startNs);
+
+    out << std::fixed << std::setprecision(3) << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+    const char* separator = "\n";
+    {
+        // Thread names are ours ("Capture 0", "Consumer"), so need no escaping
+        const std::lock_guard<std::mutex> lock(buffersMutex);
+        for (size_t thread = 0; thread < buffers.size(); ++thread) {
+            out << separator << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << thread
+                << ", \"args\": {\"name\": \"" << buffers[thread]->getName() << "\"}}";
+            separator = ",\n";
+        }
+    }
+    for (const RetainedSpan& retainedSpan : retained) {
+        const TraceSpan& span = retainedSpan.span;
+        out << separator << "{\"name\": \"" << traceStageName(span.stage)
+            << "\", \"cat\": \"pipeline\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << retainedSpan.thread
+            << ", \"ts\": " << static_cast<double>(span.startNs - baseNs) * 1e-3
+            << ", \"dur\": " << static_cast<double>(span.endNs - span.startNs) * 1e-3
+            << ", \"args\": {\"events\": " << span.events;
+        if (span.device != TraceSpan::NO_DEVICE) out << ", \"device\": " << static_cast<int>(span.device);
+        out << ", \"since_report_us\": " << static_cast<double>(span.endNs - span.originNs) * 1e-3 << "}}";
+        separator = ",\n";
+    }
+    out << "\n], \"otherData\": {\"unretained_spans\": " << unretainedSpans << "}}\n";
+}
@@ -0,0 +1,366 @@
+#include "PollingAnalyzer.hpp"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define MOUSEBENCH_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define AVX2_TARGET
+#else
+#define AVX2_TARGET __attribute__((target("avx2,fma")))
+#endif
+#endif
+
+namespace {
+    constexpr double MIN_PERIOD_US = 1e6 / 32000.0;    // Fastest rate considered: 32 kHz
+    constexpr double SCAN_STEP = 1.005;                 // Ratio between candidate periods
+    constexpr double PEAK_TOLERANCE = 0.85;             // Longest peak within this share of the best wins
+    constexpr double DUPLICATE_FLOOR_US = 20.0;         // Shorter intervals are never a period
+    constexpr double NOMINAL_TOLERANCE = 0.02;
+    constexpr double NOMINAL_RATES[] = {125.0, 250.0, 500.0, 1000.0, 2000.0, 4000.0, 8000.0};
+    constexpr size_t MIN_INTERVALS = 16;
+    constexpr int HISTOGRAM_FIT_PASSES = 2;                 // Cheap passes over the bins before the exact one
+    constexpr size_t ZERO_SKIP = 16;                    // Bins tested together while compacting
+    constexpr size_t ACCUMULATE_BLOCK = 2048;           // Floats summed per lane before widening to double
+
+    constexpr float TWO_PI = 6.2831853f;
+
+    // cos(2 pi x) in a form both kernels evaluate identically: reduce to
+    // |f| <= 1/2 turn, then cos(2 pi |f|) = -sin(2 pi (|f| - 1/4)) with a
+    // degree-9 sine polynomial (error below 1e-5)
+    inline float cosTurns(float x) {
+        const float f = x - std::nearbyint(x);
+        const float y = (std::fabs(f) - 0.25f) * TWO_PI;
+        const float y2 = y * y;
+        return -y * (1.f + y2 * (-1.f / 6 + y2 * (1.f / 120 + y2 * (-1.f / 5040 + y2 * (1.f / 362880)))));
+    }
+
+    struct SlotSums {
+        double slots{0.0};          // Whole periods spanned by non-duplicate, non-idle intervals
+        double time{0.0};           // Their total length, microseconds
+        double residual2{0.0};      // Squared distance from whole periods
+        double slots2{0.0};         // Sum of squared slot counts and of slots * residual, so
+        double slotResidual{0.0};   // residuals can be moved to a corrected period
+        double onTime{0.0};         // Non-duplicate, non-idle intervals
+        double duplicates{0.0};
+    };
+
+    double scoreScalar(const float* centers, const float* weights, size_t n, float inversePeriod) {
+        double sum = 0.0;
+        for (size_t i = 0; i < n; ++i) sum += weights[i] * cosTurns(centers[i] * inversePeriod);
+        return sum;
+    }
+
+    SlotSums slotsScalar(const float* intervals, size_t n, float period) {
+        const float inversePeriod = 1.f / period;
+        SlotSums sums;
+        for (size_t i = 0; i < n; ++i) {
+            const float slots = std::nearbyint(intervals[i] * inversePeriod);
+            if (slots < 1.f) {
+                sums.duplicates += 1.0;
+            } else if (slots <= Config::POLLING_IDLE_SLOTS) {
+                const float residual = intervals[i] - slots * period;
+                sums.slots += slots;
+                sums.time += intervals[i];
+                sums.residual2 += residual * residual;
+                sums.slots2 += slots * slots;
+                sums.slotResidual += slots * residual;
+                sums.onTime += 1.0;
+            }
+        }
+        return sums;
+    }
+
+    // Same rounding over histogram bins, each weighted by its count
+    SlotSums slotsWeighted(const float* centers, const float* weights, size_t n, float period) {
+        const float inversePeriod = 1.f / period;
+        SlotSums sums;
+        for (size_t i = 0; i < n; ++i) {
+            const float slots = std::nearbyint(centers[i] * inversePeriod);
+            if (slots < 1.f) {
+                sums.duplicates += weights[i];
+            } else if (slots <= Config::POLLING_IDLE_SLOTS) {
+                sums.slots += static_cast<double>(slots) * weights[i];
+                sums.time += static_cast<double>(centers[i]) * weights[i];
+                sums.onTime += weights[i];
+            }
+        }
+        return sums;
+    }
+
+#ifdef MOUSEBENCH_X86
+    AVX2_TARGET double horizontalSum(__m256 v) {
+        const __m128 pairs = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        const __m128 quads = _mm_add_ps(pairs, _mm_movehl_ps(pairs, pairs));
+        return _mm_cvtss_f32(_mm_add_ss(quads, _mm_shuffle_ps(quads, quads, 1)));
+    }
+
+    AVX2_TARGET __m256 cosTurns8(__m256 x) {
+        const __m256 f = _mm256_sub_ps(x, _mm256_round_ps(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+        const __m256 absF = _mm256_andnot_ps(_mm256_set1_ps(-0.f), f);
+        const __m256 y = _mm256_mul_ps(_mm256_sub_ps(absF, _mm256_set1_ps(0.25f)), _mm256_set1_ps(TWO_PI));
+        const __m256 y2 = _mm256_mul_ps(y, y);
+        __m256 poly = _mm256_fmadd_ps(y2, _mm256_set1_ps(1.f / 362880), _mm256_set1_ps(-1.f / 5040));
+        poly = _mm256_fmadd_ps(y2, poly, _mm256_set1_ps(1.f / 120));
+        poly = _mm256_fmadd_ps(y2, poly, _mm256_set1_ps(-1.f / 6));
+        poly = _mm256_fmadd_ps(y2, poly, _mm256_set1_ps(1.f));
+        return _mm256_mul_ps(_mm256_xor_ps(y, _mm256_set1_ps(-0.f)), poly);
+    }
+
+    AVX2_TARGET double scoreAvx2(const float* centers, const float* weights, size_t n, float inversePeriod) {
+        const __m256 scale = _mm256_set1_ps(inversePeriod);
+        __m256 acc = _mm256_setzero_ps();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            const __m256 x = _mm256_mul_ps(_mm256_loadu_ps(centers + i), scale);
+            acc = _mm256_fmadd_ps(_mm256_loadu_ps(weights + i), cosTurns8(x), acc);
+        }
+        return horizontalSum(acc) + scoreScalar(centers + i, weights + i, n - i, inversePeriod);
+    }
+
+    AVX2_TARGET SlotSums slotsAvx2(const float* intervals, size_t n, float period) {
+        const __m256 periods = _mm256_set1_ps(period);
+        const __m256 inversePeriod = _mm256_set1_ps(1.f / period);
+        const __m256 one = _mm256_set1_ps(1.f);
+        const __m256 idle = _mm256_set1_ps(static_cast<float>(Config::POLLING_IDLE_SLOTS));
+
+        SlotSums sums;
+        size_t i = 0;
+        while (i + 8 <= n) {
+            // Lane sums stay in float for a block, then widen to double
+            __m256 slots = _mm256_setzero_ps(), time = _mm256_setzero_ps(), residual2 = _mm256_setzero_ps();
+            __m256 onTime = _mm256_setzero_ps(), duplicates = _mm256_setzero_ps();
+            __m256 slots2 = _mm256_setzero_ps(), slotResidual = _mm256_setzero_ps();
+            const size_t blockEnd = std::min(n, i + ACCUMULATE_BLOCK);
+            for (; i + 8 <= blockEnd; i += 8) {
+                const __m256 interval = _mm256_loadu_ps(intervals + i);
+                const __m256 k = _mm256_round_ps(_mm256_mul_ps(interval, inversePeriod),
+                                                 _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+                const __m256 duplicate = _mm256_cmp_ps(k, one, _CMP_LT_OQ);
+                const __m256 counted = _mm256_and_ps(_mm256_cmp_ps(k, one, _CMP_GE_OQ),
+                                                     _mm256_cmp_ps(k, idle, _CMP_LE_OQ));
+                const __m256 residual = _mm256_fnmadd_ps(k, periods, interval);
+
+                duplicates = _mm256_add_ps(duplicates, _mm256_and_ps(duplicate, one));
+                onTime = _mm256_add_ps(onTime, _mm256_and_ps(counted, one));
+                slots = _mm256_add_ps(slots, _mm256_and_ps(counted, k));
+                time = _mm256_add_ps(time, _mm256_and_ps(counted, interval));
+                residual2 = _mm256_add_ps(residual2, _mm256_and_ps(counted, _mm256_mul_ps(residual, residual)));
+                slots2 = _mm256_add_ps(slots2, _mm256_and_ps(counted, _mm256_mul_ps(k, k)));
+                slotResidual = _mm256_add_ps(slotResidual, _mm256_and_ps(counted, _mm256_mul_ps(k, residual)));
+            }
+            sums.slots += horizontalSum(slots);
+            sums.time += horizontalSum(time);
+            sums.residual2 += horizontalSum(residual2);
+            sums.slots2 += horizontalSum(slots2);
+            sums.slotResidual += horizontalSum(slotResidual);
+            sums.onTime += horizontalSum(onTime);
+            sums.duplicates += horizontalSum(duplicates);
+        }
+
+        const SlotSums tail = slotsScalar(intervals + i, n - i, period);
+        sums.slots += tail.slots;
+        sums.time += tail.time;
+        sums.residual2 += tail.residual2;
+        sums.slots2 += tail.slots2;
+        sums.slotResidual += tail.slotResidual;
+        sums.onTime += tail.onTime;
+        sums.duplicates += tail.duplicates;
+        return sums;
+    }
+
+    bool cpuHasAvx2() {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+        __cpuid(info, 1);
+        const bool fma = (info[2] & (1 << 12)) != 0;
+        const bool osSavesAvx = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6;
+        if (!fma || !osSavesAvx) return false;
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+    }
+#else
+    bool cpuHasAvx2() { return false; }
+#endif
+
+    bool& vectorKernels() {
+        static bool enabled = cpuHasAvx2();
+        return enabled;
+    }
+
+    double score(const float* centers, const float* weights, size_t n, float inversePeriod) {
+#ifdef MOUSEBENCH_X86
+        if (vectorKernels()) return scoreAvx2(centers, weights, n, inversePeriod);
+#endif
+        return scoreScalar(centers, weights, n, inversePeriod);
+    }
+
+    SlotSums countSlots(const float* intervals, size_t n, float period) {
+#ifdef MOUSEBENCH_X86
+        if (vectorKernels()) return slotsAvx2(intervals, n, period);
+#endif
+        return slotsScalar(intervals, n, period);
+    }
+}
+
+PollingAnalyzer::PollingAnalyzer(size_t windowSize)
+    : window(windowSize),
+      bins(static_cast<size_t>(Config::POLLING_MAX_INTERVAL_US / Config::POLLING_BIN_US)) {
+    binCenters.reserve(bins.size());
+    binWeights.reserve(bins.size());
+}
+
+bool PollingAnalyzer::useVectorKernels(bool enable) {
+    vectorKernels() = enable && cpuHasAvx2();
+    return vectorKernels();
+}
+
+const char* PollingAnalyzer::kernelName() {
+    return vectorKernels() ? "avx2" : "scalar";
+}
+
+size_t PollingAnalyzer::binIndex(float intervalUs) const {
+    const auto index = static_cast<size_t>(intervalUs * static_cast<float>(1.0 / Config::POLLING_BIN_US));
+    return std::min(index, bins.size());
+}
+
+void PollingAnalyzer::add(double intervalUs) {
+    if (window.empty()) return;
+
+    const auto value = static_cast<float>(intervalUs);
+    if (count == window.size()) {
+        const size_t old = binIndex(window[head]);
+        if (old < bins.size()) --bins[old];
+    } else {
+        ++count;
+    }
+    window[head] = value;
+    head = (head + 1) % window.size();
+
+    const size_t index = binIndex(value);
+    if (index < bins.size()) ++bins[index];
+}
+
+void PollingAnalyzer::clear() {
+    head = 0;
+    count = 0;
+    std::fill(bins.begin(), bins.end(), 0u);
+    estimate = PollingEstimate{};
+}
+
+const PollingEstimate& PollingAnalyzer::analyze() {
+    if (count < MIN_INTERVALS) {
+        estimate = PollingEstimate{};
+        estimate.intervals = count;
+        return estimate;
+    }
+
+    double periodicity = 0.0;
+    const double period = scanPeriod(periodicity);
+    estimate = PollingEstimate{};
+    estimate.periodicity = periodicity;
+    estimate.intervals = count;
+    fitPeriod(period);
+    return estimate;
+}
+
+double PollingAnalyzer::scanPeriod(double& periodicity) {
+    // Compact the histogram and find the median interval that could be a period
+    binCenters.clear();
+    binWeights.clear();
+    double total = 0.0;
+    double candidates = 0.0;
+    for (size_t i = 0; i < bins.size(); ++i) {
+        // Most of the range is empty; skip it a block at a time
+        if (i % ZERO_SKIP == 0 && i + ZERO_SKIP <= bins.size()) {
+            std::uint32_t any = 0;
+            for (size_t j = 0; j < ZERO_SKIP; ++j) any |= bins[i + j];
+            if (any == 0) {
+                i += ZERO_SKIP - 1;
+                continue;
+            }
+        }
+        if (bins[i] == 0) continue;
+        const double center = (static_cast<double>(i) + 0.5) * Config::POLLING_BIN_US;
+        binCenters.push_back(static_cast<float>(center));
+        binWeights.push_back(static_cast<float>(bins[i]));
+        total += bins[i];
+        if (center >= DUPLICATE_FLOOR_US) candidates += bins[i];
+    }
+    if (candidates == 0.0) return 0.0;
+
+    double median = 0.0;
+    double seen = 0.0;
+    for (size_t i = 0; i < binCenters.size(); ++i) {
+        if (binCenters[i] < DUPLICATE_FLOOR_US) continue;
+        seen += binWeights[i];
+        if (seen >= candidates / 2) {
+            median = binCenters[i];
+            break;
+        }
+    }
+
+    // Any period far beyond the typical interval scores near 1 trivially, so
+    // the scan stops just past the median
+    const double longest = std::min(median * 1.1, Config::POLLING_MAX_INTERVAL_US);
+    scores.clear();
+    for (double p = MIN_PERIOD_US; p <= longest; p *= SCAN_STEP) {
+        scores.push_back(score(binCenters.data(), binWeights.data(), binCenters.size(),
+                               static_cast<float>(1.0 / p)) / total);
+    }
+
+    // Every divisor of the true period scores as well as the period itself,
+    // so of the strong interior peaks take the longest
+    double best = 0.0;
+    for (size_t i = 1; i + 1 < scores.size(); ++i) {
+        if (scores[i] > scores[i - 1] && scores[i] >= scores[i + 1]) best = std::max(best, scores[i]);
+    }
+    if (best <= 0.0) return median;
+
+    for (size_t i = scores.size() - 2; i >= 1; --i) {
+        if (scores[i] > scores[i - 1] && scores[i] >= scores[i + 1] && scores[i] >= best * PEAK_TOLERANCE) {
+            periodicity = scores[i];
+            return MIN_PERIOD_US * std::pow(SCAN_STEP, static_cast<double>(i));
+        }
+    }
+    return median;
+}
+
+void PollingAnalyzer::fitPeriod(double periodUs) {
+    if (periodUs <= 0.0) return;
+
+    // Slot counts from the coarse period, then the period as total time over
+    // total slots. Insensitive to batching and coalescing, which only move
+    // reports between slots. The histogram settles the rounding; one pass over
+    // the raw window then gives the exact period and residuals.
+    double period = periodUs;
+    for (int pass = 0; pass < HISTOGRAM_FIT_PASSES; ++pass) {
+        const SlotSums binned = slotsWeighted(binCenters.data(), binWeights.data(), binCenters.size(),
+                                              static_cast<float>(period));
+        if (binned.slots > 0.0) period = binned.time / binned.slots;
+    }
+
+    const SlotSums sums = countSlots(window.data(), count, static_cast<float>(period));
+    if (sums.slots == 0.0) return;
+    const double shift = sums.time / sums.slots - period;
+    period += shift;
+
+    estimate.periodUs = period;
+    estimate.rateHz = 1e6 / period;
+    estimate.nominalRateHz = estimate.rateHz;
+    for (const double nominal : NOMINAL_RATES) {
+        if (std::abs(estimate.rateHz - nominal) <= nominal * NOMINAL_TOLERANCE) estimate.nominalRateHz = nominal;
+    }
+    estimate.missedFraction = (sums.slots - sums.onTime) / sums.slots;
+    estimate.duplicateFraction = sums.duplicates / static_cast<double>(count);
+    // Residuals were taken against the pre-fit period: r - k * shift
+    const double residual2 = sums.residual2 - 2.0 * shift * sums.slotResidual + shift * shift * sums.slots2;
+    estimate.jitterUs = std::sqrt(std::max(0.0, residual2) / sums.onTime);
+}
@@ -0,0 +1,128 @@
+#include "RawInputSource.hpp"
+
+#ifdef _WIN32
+#include "Clock.hpp"
+#include <iterator>
+
+namespace {
+    constexpr const wchar_t* CAPTURE_CLASS_NAME = L"MouseBenchmarkCapture";
+
+    struct ButtonTransition {
+        USHORT flag;
+        std::uint8_t button;
+        InputEventType type;
+    };
+
+    constexpr ButtonTransition BUTTON_TRANSITIONS[] = {
+        {RI_MOUSE_LEFT_BUTTON_DOWN,   0, InputEventType::ButtonPress},
+        {RI_MOUSE_LEFT_BUTTON_UP,     0, InputEventType::ButtonRelease},
+        {RI_MOUSE_RIGHT_BUTTON_DOWN,  1, InputEventType::ButtonPress},
+        {RI_MOUSE_RIGHT_BUTTON_UP,    1, InputEventType::ButtonRelease},
+        {RI_MOUSE_MIDDLE_BUTTON_DOWN, 2, InputEventType::ButtonPress},
+        {RI_MOUSE_MIDDLE_BUTTON_UP,   2, InputEventType::ButtonRelease},
+        {RI_MOUSE_BUTTON_4_DOWN,      3, InputEventType::ButtonPress},
+        {RI_MOUSE_BUTTON_4_UP,        3, InputEventType::ButtonRelease},
+        {RI_MOUSE_BUTTON_5_DOWN,      4, InputEventType::ButtonPress},
+        {RI_MOUSE_BUTTON_5_UP,        4, InputEventType::ButtonRelease},
+    };
+
+    // One move plus every button transition a single report can carry
+    constexpr std::size_t MAX_EVENTS_PER_REPORT = 1 + std::size(BUTTON_TRANSITIONS);
+}
+
+std::unique_ptr<InputSource> createDefaultInputSource() {
+    return std::make_unique<RawInputSource>();
+}
+
+bool RawInputSource::open() {
+    instance = GetModuleHandleW(nullptr);
+    WNDCLASSEXW windowClass{};
+    windowClass.cbSize = sizeof(windowClass);
+    windowClass.lpfnWndProc = DefWindowProcW;
+    windowClass.hInstance = instance;
+    windowClass.lpszClassName = CAPTURE_CLASS_NAME;
+    RegisterClassExW(&windowClass);
+
+    captureWindow = CreateWindowExW(0, CAPTURE_CLASS_NAME, L"", 0, 0, 0, 0, 0,
+                                    HWND_MESSAGE, nullptr, instance, nullptr);
+
+    RAWINPUTDEVICE device{};
+    device.usUsagePage = 0x01;  // Generic desktop
+    device.usUsage = 0x02;      // Mouse
+    device.dwFlags = RIDEV_INPUTSINK;
+    device.hwndTarget = captureWindow;
+
+    if (!captureWindow || !RegisterRawInputDevices(&device, 1, sizeof(device))) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void RawInputSource::close() {
+    if (captureWindow) {
+        RAWINPUTDEVICE device{};
+        device.usUsagePage = 0x01;
+        device.usUsage = 0x02;
+        device.dwFlags = RIDEV_REMOVE;
+        RegisterRawInputDevices(&device, 1, sizeof(device));
+        DestroyWindow(captureWindow);
+        captureWindow = nullptr;
+    }
+    if (instance) {
+        UnregisterClassW(CAPTURE_CLASS_NAME, instance);
+        instance = nullptr;
+    }
+}
+
+std::size_t RawInputSource::read(InputEvent* out, std::size_t maxCount, int timeoutMs) {
+    MsgWaitForMultipleObjects(0, nullptr, FALSE, static_cast<DWORD>(timeoutMs), QS_RAWINPUT);
+
+    std::size_t count = 0;
+    MSG msg;
+    while (maxCount - count >= MAX_EVENTS_PER_REPORT &&
+           PeekMessageW(&msg, captureWindow, WM_INPUT, WM_INPUT, PM_REMOVE)) {
+        const std::int64_t timestamp = Clock::nowNs();
+        count += decode(msg, timestamp, out + count);
+        DispatchMessageW(&msg);
+    }
+    return count;
+}
+
+std::size_t RawInputSource::decode(const MSG& msg, std::int64_t timestamp, InputEvent* out) {
+    RAWINPUT raw;
+    UINT size = sizeof(raw);
+    const UINT read = GetRawInputData(reinterpret_cast<HRAWINPUT>(msg.lParam), RID_INPUT,
+                                      &raw, &size, sizeof(RAWINPUTHEADER));
+    if (read == static_cast<UINT>(-1) || raw.header.dwType != RIM_TYPEMOUSE) return 0;
+
+    const RAWMOUSE& mouse = raw.data.mouse;
+
+    POINT cursor;
+    GetCursorPos(&cursor);
+
+    InputEvent event{};
+    event.timestampNs = timestamp;
+    event.x = static_cast<float>(cursor.x);
+    event.y = static_cast<float>(cursor.y);
+
+    std::size_t count = 0;
+    if ((mouse.usFlags & MOUSE_MOVE_ABSOLUTE) == 0 && (mouse.lLastX != 0 || mouse.lLastY != 0)) {
+        event.type = InputEventType::Move;
+        event.dx = mouse.lLastX;
+        event.dy = mouse.lLastY;
+        out[count++] = event;
+    }
+
+    event.dx = event.dy = 0;
+    for (const auto& transition : BUTTON_TRANSITIONS) {
+        if (mouse.usButtonFlags & transition.flag) {
+            event.type = transition.type;
+            event.button = transition.button;
+            out[count++] = event;
+        }
+    }
+    return count;
+}
+
+#endif
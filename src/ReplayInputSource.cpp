@@ -0,0 +1,78 @@
+#include "ReplayInputSource.hpp"
+#include "Clock.hpp"
+#include "Config.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+bool parseReplaySpeed(const std::string& text, ReplayPacing& pacing, double& speed) {
+    if (text == "realtime") {
+        pacing = ReplayPacing::RealTime;
+        speed = 1.0;
+        return true;
+    }
+    if (text == "max") {
+        pacing = ReplayPacing::AsFastAsPossible;
+        speed = 1.0;
+        return true;
+    }
+
+    try {
+        size_t parsed = 0;
+        speed = std::stod(text, &parsed);
+        pacing = ReplayPacing::Scaled;
+        return parsed == text.size() && speed > 0.0;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+ReplayInputSource::ReplayInputSource(const std::string& path, ReplayPacing pacing, double speed)
+    : reader(path), pacing(pacing), speed(pacing == ReplayPacing::RealTime ? 1.0 : speed),
+      waiter(Config::SOURCE_MAX_SPIN_NS) {
+    if (pacing == ReplayPacing::Scaled && speed <= 0.0) {
+        throw std::invalid_argument("Replay speed must be positive");
+    }
+}
+
+bool ReplayInputSource::open() {
+    const auto records = reader.getRecords();
+    nextRecord = 0;
+    firstTimestamp = records.empty() ? 0 : records.front().timestampNs;
+    wallStartNs = Clock::nowNs();
+    return true;
+}
+
+std::int64_t ReplayInputSource::dueNs(std::int64_t timestampNs) const {
+    return wallStartNs + std::llround(static_cast<double>(timestampNs - firstTimestamp) / speed);
+}
+
+std::size_t ReplayInputSource::read(InputEvent* out, std::size_t maxCount, int timeoutMs) {
+    const auto records = reader.getRecords();
+    if (nextRecord >= records.size()) return 0;
+
+    std::size_t end = std::min(records.size(), nextRecord + maxCount);
+
+    if (pacing != ReplayPacing::AsFastAsPossible) {
+        const std::int64_t due = dueNs(records[nextRecord].timestampNs);
+        const std::int64_t deadline = Clock::nowNs() + static_cast<std::int64_t>(timeoutMs) * 1'000'000;
+        if (due > deadline) {
+            waiter.waitUntil(deadline);
+            return 0;
+        }
+
+        // Emit everything that has come due, not just the first event
+        const std::int64_t now = waiter.waitUntil(due);
+        std::size_t dueEnd = nextRecord + 1;
+        while (dueEnd < end && dueNs(records[dueEnd].timestampNs) <= now) {
+            ++dueEnd;
+        }
+        end = dueEnd;
+    }
+
+    std::size_t count = 0;
+    for (; nextRecord < end; ++nextRecord) {
+        out[count++] = CaptureFormat::toEvent(records[nextRecord]);
+    }
+    return count;
+}
@@ -0,0 +1,459 @@
+#include "Report.hpp"
+#include <cmath>
+#include <iomanip>
+
+namespace {
+    void writeTextPercentiles(std::ostream& out, const char* label, const PercentileSummary& summary,
+                              double scale, const char* unit) {
+        out << "  " << label << " P50/P90/P99/P99.9/Max: "
+            << summary.p50 * scale << " / " << summary.p90 * scale << " / "
+            << summary.p99 * scale << " / " << summary.p999 * scale << " / "
+            << summary.max * scale << ' ' << unit << '\n';
+    }
+
+    void writeJsonPercentiles(std::ostream& out, const PercentileSummary& summary) {
+        out << "{\"p50\": " << summary.p50 << ", \"p90\": " << summary.p90
+            << ", \"p99\": " << summary.p99 << ", \"p99_9\": " << summary.p999
+            << ", \"max\": " << summary.max << '}';
+    }
+
+    void writeTextMotion(std::ostream& out, const MotionAnalyzer& analyzer) {
+        const MotionSummary& motion = analyzer.getSummary();
+        out << "  Filtered Speed / Acceleration: " << motion.speed << " counts/ms / " << motion.acceleration
+            << " counts/ms^2\n"
+            << "  Peak Speed / Acceleration: " << motion.peakSpeed << " counts/ms / " << motion.peakAcceleration
+            << " counts/ms^2\n"
+            << "  Straightness: " << motion.straightness << " over " << motion.strokes << " strokes\n"
+            << "  Angle Snapping: " << motion.snappedStrokes << " of " << motion.axisStrokes
+            << " near-axis strokes held the axis\n"
+            << "  CPI Deviation Across Speeds: " << motion.cpiDeviation * 100.0 << " %\n"
+            << "  Max Tracked Speed: " << motion.maxTrackedSpeed << " counts/ms";
+        if (motion.malfunctionSpeed > 0.0) out << ", mistracking from " << motion.malfunctionSpeed << " counts/ms";
+        out << '\n';
+    }
+
+    void writeJsonMotion(std::ostream& out, const MotionAnalyzer& analyzer) {
+        const MotionSummary& motion = analyzer.getSummary();
+        out << "{\"speed\": " << motion.speed
+            << ", \"acceleration\": " << motion.acceleration
+            << ", \"peak_speed\": " << motion.peakSpeed
+            << ", \"peak_acceleration\": " << motion.peakAcceleration
+            << ", \"strokes\": " << motion.strokes
+            << ", \"straightness\": " << motion.straightness
+            << ", \"axis_strokes\": " << motion.axisStrokes
+            << ", \"snapped_strokes\": " << motion.snappedStrokes
+            << ", \"cpi_deviation\": " << motion.cpiDeviation
+            << ", \"max_tracked_speed\": " << motion.maxTrackedSpeed
+            << ", \"malfunction_speed\": " << motion.malfunctionSpeed
+            << ",\n    \"speed_bands\": [";
+        // Only bands with data; each is [low, high) counts/ms
+        bool first = true;
+        const auto& bands = analyzer.getBands();
+        for (size_t i = 0; i < bands.size(); ++i) {
+            const SpeedBand& band = bands[i];
+            if (band.samples == 0 && band.strokes == 0) continue;
+            out << (first ? "" : ", ") << "{\"low\": " << static_cast<double>(i) * Config::MOTION_SPEED_BAND
+                << ", \"samples\": " << band.samples << ", \"faults\": " << band.faults
+                << ", \"strokes\": " << band.strokes << ", \"counts_per_stroke\": "
+                << (band.strokes ? band.chordSum / static_cast<double>(band.strokes) : 0.0) << '}';
+            first = false;
+        }
+        out << "]}";
+    }
+
+    void writeTextButtons(std::ostream& out, const ButtonCounts& buttons) {
+        out << "  Clicks: " << buttons.clicks << " (chatter " << buttons.chatter
+            << ", double-click faults " << buttons.doubleClicks << ")\n";
+    }
+
+    void writeJsonButtons(std::ostream& out, const ButtonCounts& buttons) {
+        out << "{\"clicks\": " << buttons.clicks << ", \"chatter\": " << buttons.chatter
+            << ", \"double_click_faults\": " << buttons.doubleClicks << '}';
+    }
+
+    // Where in the session the largest value fell, at the finest level still held
+    void writeTextWorst(std::ostream& out, const char* label, const RollupHistory& history,
+                        double scale, const char* unit) {
+        if (history.empty()) return;
+        const RollupSpan worst = history.findWorst();
+        out << "  " << label << ": " << worst.bucket.max * scale << ' ' << unit << " at "
+            << (worst.startNs - history.getStartNs()) * 1e-9 << " s";
+        if (worst.level > 0) out << " (within a " << (worst.endNs - worst.startNs) * 1e-9 << " s bucket)";
+        out << '\n';
+    }
+
+    void writeJsonHistory(std::ostream& out, const RollupHistory& history) {
+        const RollupSpan worst = history.findWorst();
+        out << "{\"start_ns\": " << history.getStartNs()
+            << ", \"end_ns\": " << history.getEndNs()
+            << ", \"worst\": {\"value\": " << worst.bucket.max
+            << ", \"start_ns\": " << worst.startNs
+            << ", \"end_ns\": " << worst.endNs
+            << ", \"resolution_ns\": " << history.getLevelWidthNs(worst.level) << '}'
+            << ",\n    \"bucket_ns\": " << history.getSessionBucketNs()
+            << ", \"buckets\": [";
+        // [count, min, max, mean] from the session start onwards; empty buckets are gaps
+        const auto buckets = history.getSessionBuckets();
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            const RollupBucket& bucket = buckets[i];
+            out << (i ? ", " : "") << '[' << bucket.count << ", " << bucket.min << ", " << bucket.max
+                << ", " << bucket.mean() << ']';
+        }
+        out << "]}";
+    }
+
+    void writeTextReport(std::ostream& out, const MetricsCollector& metrics, bool includeDistribution) {
+        out << std::fixed << std::setprecision(3)
+            << "Click Latency, receipt to handling (" << metrics.getLatencyHistogram().getTotalCount() << " samples):\n"
+            << "  Current: " << metrics.getCurrentLatency() << " ms\n"
+            << "  Average: " << metrics.getAverageLatency() << " ms\n"
+            << "  Min: " << metrics.getMinLatency() << " ms\n"
+            << "  Max: " << metrics.getMaxLatency() << " ms\n"
+            << "  Std Dev: " << metrics.getLatencyStdDev() << " ms\n";
+        writeTextPercentiles(out, "Session", metrics.getLatencyPercentiles(), 1e-3, "ms");
+        writeTextWorst(out, "Worst Latency", metrics.getLatencyHistory(), 1e-3, "ms");
+        writeTextButtons(out, metrics.getButtonCounts());
+        out << "  Last Press Duration: " << metrics.getCurrentPressDuration() << " ms\n";
+        writeTextPercentiles(out, "Press Duration", metrics.getPressDurationPercentiles(), 1e-3, "ms");
+
+        out << "\nPolling Rate (" << metrics.getIntervalHistogram().getTotalCount() << " intervals):\n"
+            << "  Current: " << metrics.getCurrentPollingRate() << " Hz\n"
+            << "  Average: " << metrics.getAveragePollingRate() << " Hz\n"
+            << "  Std Dev: " << metrics.getPollingRateStdDev() << " Hz\n";
+        writeTextPercentiles(out, "Interval", metrics.getIntervalPercentiles(), 1.0, "us");
+        writeTextWorst(out, "Worst Interval", metrics.getIntervalHistory(), 1.0, "us");
+        const PollingEstimate& polling = metrics.getPollingEstimate();
+        out << "  Nominal: " << polling.nominalRateHz << " Hz (fitted " << polling.rateHz << " Hz, periodicity "
+            << polling.periodicity << ")\n"
+            << "  Missed / Duplicate: " << polling.missedFraction * 100.0 << " / "
+            << polling.duplicateFraction * 100.0 << " %\n"
+            << "  Jitter: " << polling.jitterUs << " us\n";
+
+        out << "\nMovement:\n"
+            << "  Current Speed: " << metrics.getCurrentMovementSpeed() << " counts/ms\n"
+            << "  Average Speed: " << metrics.getAverageMovementSpeed() << " counts/ms\n";
+        writeTextMotion(out, metrics.getMotionAnalyzer());
+
+        if (includeDistribution) {
+            out << "\nLatency distribution (ms):\n";
+            metrics.getLatencyHistogram().writePercentileDistribution(out, 1e-3);
+            out << "\nPress duration distribution (ms):\n";
+            metrics.getPressDurationHistogram().writePercentileDistribution(out, 1e-3);
+            out << "\nInterval distribution (us):\n";
+            metrics.getIntervalHistogram().writePercentileDistribution(out);
+        }
+        out << std::defaultfloat;
+    }
+
+    void writeJsonReport(std::ostream& out, const MetricsCollector& metrics) {
+        out << std::setprecision(6)
+            << "{\n  \"latency_ms\": {"
+            << "\"count\": " << metrics.getLatencyHistogram().getTotalCount()
+            << ", \"current\": " << metrics.getCurrentLatency()
+            << ", \"average\": " << metrics.getAverageLatency()
+            << ", \"min\": " << metrics.getMinLatency()
+            << ", \"max\": " << metrics.getMaxLatency()
+            << ", \"stddev\": " << metrics.getLatencyStdDev() << "},\n"
+            << "  \"latency_percentiles_us\": ";
+        writeJsonPercentiles(out, metrics.getLatencyPercentiles());
+        out << ",\n  \"latency_history_us\": ";
+        writeJsonHistory(out, metrics.getLatencyHistory());
+        out << ",\n  \"buttons\": ";
+        writeJsonButtons(out, metrics.getButtonCounts());
+        out << ",\n  \"press_duration_percentiles_us\": ";
+        writeJsonPercentiles(out, metrics.getPressDurationPercentiles());
+
+        out << ",\n  \"polling_hz\": {"
+            << "\"count\": " << metrics.getIntervalHistogram().getTotalCount()
+            << ", \"current\": " << metrics.getCurrentPollingRate()
+            << ", \"average\": " << metrics.getAveragePollingRate()
+            << ", \"stddev\": " << metrics.getPollingRateStdDev() << "},\n"
+            << "  \"interval_percentiles_us\": ";
+        writeJsonPercentiles(out, metrics.getIntervalPercentiles());
+        out << ",\n  \"interval_history_us\": ";
+        writeJsonHistory(out, metrics.getIntervalHistory());
+
+        const PollingEstimate& polling = metrics.getPollingEstimate();
+        out << ",\n  \"polling_analysis\": {"
+            << "\"intervals\": " << polling.intervals
+            << ", \"nominal_hz\": " << polling.nominalRateHz
+            << ", \"fitted_hz\": " << polling.rateHz
+            << ", \"periodicity\": " << polling.periodicity
+            << ", \"missed_fraction\": " << polling.missedFraction
+            << ", \"duplicate_fraction\": " << polling.duplicateFraction
+            << ", \"jitter_us\": " << polling.jitterUs << '}';
+
+        out << ",\n  \"movement_counts_per_ms\": {"
+            << "\"current\": " << metrics.getCurrentMovementSpeed()
+            << ", \"average\": " << metrics.getAverageMovementSpeed() << "},\n"
+            << "  \"motion_analysis\": ";
+        writeJsonMotion(out, metrics.getMotionAnalyzer());
+        out << "\n}\n";
+    }
+    void writeTextSummary(std::ostream& out, const AnalysisSummary& summary) {
+        out << summary.name << ":\n";
+        if (!summary.error.empty()) {
+            out << "  Error: " << summary.error << "\n";
+            return;
+        }
+        out << "  Events: " << summary.eventCount << " over " << summary.durationSeconds << " s\n";
+        writeTextButtons(out, summary.buttons);
+        out << "  Press Duration: average " << summary.pressDuration.mean << " ms, std dev "
+            << summary.pressDuration.stddev() << " ms\n";
+        writeTextPercentiles(out, "Press Duration", summary.pressDurationPercentiles, 1e-3, "ms");
+        out << "  Polling Rate (" << summary.pollingRate.count << " intervals): average "
+            << summary.pollingRate.mean << " Hz, std dev " << summary.pollingRate.stddev() << " Hz\n";
+        writeTextPercentiles(out, "Interval", summary.intervalPercentiles, 1.0, "us");
+        out << "  Speed: average " << summary.speed.mean << " counts/ms, max " << summary.speed.max
+            << " counts/ms\n";
+    }
+
+    void writeJsonMoments(std::ostream& out, const RunningMoments& moments) {
+        out << "{\"count\": " << moments.count << ", \"average\": " << moments.mean
+            << ", \"min\": " << moments.min << ", \"max\": " << moments.max
+            << ", \"stddev\": " << moments.stddev() << '}';
+    }
+
+    void writeJsonString(std::ostream& out, const std::string& text) {
+        out << '"';
+        for (const char c : text) {
+            if (c == '"' || c == '\\') out << '\\' << c;
+            else if (static_cast<unsigned char>(c) < 0x20) out << ' ';
+            else out << c;
+        }
+        out << '"';
+    }
+
+    void writeJsonSummary(std::ostream& out, const AnalysisSummary& summary) {
+        out << "{\"name\": ";
+        writeJsonString(out, summary.name);
+        if (!summary.error.empty()) {
+            out << ", \"error\": ";
+            writeJsonString(out, summary.error);
+            out << '}';
+            return;
+        }
+        out << ", \"events\": " << summary.eventCount
+            << ", \"duration_s\": " << summary.durationSeconds
+            << ",\n     \"buttons\": ";
+        writeJsonButtons(out, summary.buttons);
+        out << ",\n     \"press_duration_ms\": ";
+        writeJsonMoments(out, summary.pressDuration);
+        out << ",\n     \"press_duration_percentiles_us\": ";
+        writeJsonPercentiles(out, summary.pressDurationPercentiles);
+        out << ",\n     \"polling_hz\": ";
+        writeJsonMoments(out, summary.pollingRate);
+        out << ",\n     \"interval_ms\": ";
+        writeJsonMoments(out, summary.interval);
+        out << ",\n     \"interval_percentiles_us\": ";
+        writeJsonPercentiles(out, summary.intervalPercentiles);
+        out << ",\n     \"speed_counts_per_ms\": ";
+        writeJsonMoments(out, summary.speed);
+        out << '}';
+    }
+    double relativeError(double measured, double truth) {
+        return truth != 0.0 ? (measured - truth) / truth * 100.0 : 0.0;
+    }
+
+    double rateFromInterval(const RunningMoments& interval) {
+        return interval.mean > 0.0 ? 1000.0 / interval.mean : 0.0;
+    }
+
+    void writeTextComparison(std::ostream& out, const char* label, const RunningMoments& truth,
+                             const RunningMoments& measured, const char* unit) {
+        out << "  " << label << ": truth " << truth.mean << " +/- " << truth.stddev() << ' ' << unit
+            << " (" << truth.count << "), measured " << measured.mean << " +/- " << measured.stddev() << ' ' << unit
+            << " (" << measured.count << "), error " << relativeError(measured.mean, truth.mean) << " %\n";
+    }
+
+    void writeJsonComparison(std::ostream& out, const RunningMoments& truth, const RunningMoments& measured) {
+        out << "{\"truth\": " << truth.mean << ", \"truth_stddev\": " << truth.stddev()
+            << ", \"truth_count\": " << truth.count
+            << ", \"measured\": " << measured.mean << ", \"measured_stddev\": " << measured.stddev()
+            << ", \"measured_count\": " << measured.count
+            << ", \"error_percent\": " << relativeError(measured.mean, truth.mean) << '}';
+    }
+
+    // Romano et al.'s thresholds for Cliff's delta
+    const char* effectMagnitude(double cliffsDelta) {
+        const double magnitude = std::abs(cliffsDelta);
+        if (magnitude < 0.147) return "negligible";
+        if (magnitude < 0.33) return "small";
+        if (magnitude < 0.474) return "medium";
+        return "large";
+    }
+
+    void writeTextMetricComparison(std::ostream& out, const MetricComparison& metric, double alpha) {
+        out << metric.name << " (us), " << metric.countA << " vs " << metric.countB << " samples:\n"
+            << "  Mean: " << metric.meanA << " -> " << metric.meanB << '\n';
+        for (const StatisticDelta& statistic : metric.statistics) {
+            out << "  " << statistic.name << ": " << statistic.a << " -> " << statistic.b << ", delta "
+                << statistic.delta() << " [" << statistic.lower << ", " << statistic.upper << ']'
+                << (statistic.significant() ? " *" : "") << '\n';
+        }
+        out << "  Kolmogorov-Smirnov: D = " << metric.ksStatistic << ", p = " << std::setprecision(6)
+            << metric.ksPValue << std::setprecision(3)
+            << (metric.ksPValue < alpha ? " (distributions differ)\n" : " (no detectable difference)\n")
+            << "  Effect Size: Cohen's d " << metric.cohensD << ", Cliff's delta " << metric.cliffsDelta
+            << " (" << effectMagnitude(metric.cliffsDelta) << ")\n";
+    }
+
+    void writeJsonMetricComparison(std::ostream& out, const MetricComparison& metric) {
+        out << "{\"name\": ";
+        writeJsonString(out, metric.name);
+        out << ", \"unit\": \"us\", \"count_a\": " << metric.countA << ", \"count_b\": " << metric.countB
+            << ", \"mean_a\": " << metric.meanA << ", \"mean_b\": " << metric.meanB << ",\n     \"statistics\": [";
+        for (size_t i = 0; i < metric.statistics.size(); ++i) {
+            const StatisticDelta& statistic = metric.statistics[i];
+            out << (i ? ",\n       " : "\n       ") << "{\"name\": \"" << statistic.name << "\", \"a\": " << statistic.a
+                << ", \"b\": " << statistic.b << ", \"delta\": " << statistic.delta()
+                << ", \"lower\": " << statistic.lower << ", \"upper\": " << statistic.upper
+                << ", \"significant\": " << (statistic.significant() ? "true" : "false") << '}';
+        }
+        out << "],\n     \"ks_statistic\": " << metric.ksStatistic << ", \"ks_p_value\": " << metric.ksPValue
+            << ", \"cohens_d\": " << metric.cohensD << ", \"cliffs_delta\": " << metric.cliffsDelta << '}';
+    }
+}
+
+void writeReport(std::ostream& out, const MetricsCollector& metrics, ReportFormat format,
+                 bool includeDistribution) {
+    switch (format) {
+        case ReportFormat::Text:
+            writeTextReport(out, metrics, includeDistribution);
+            break;
+        case ReportFormat::Json:
+            writeJsonReport(out, metrics);
+            break;
+    }
+}
+
+void writeDeviceReport(std::ostream& out, const DeviceGroup& devices, ReportFormat format,
+                       bool includeDistribution) {
+    if (devices.size() == 1) {
+        writeReport(out, devices[0].metrics, format, includeDistribution);
+        return;
+    }
+
+    switch (format) {
+        case ReportFormat::Text:
+            for (size_t i = 0; i < devices.size(); ++i) {
+                const CaptureDevice& device = devices[i];
+                out << (i ? "\n" : "") << "=== " << device.name << " ===\n";
+                if (device.capture.getDroppedEvents() > 0) {
+                    out << device.capture.getDroppedEvents() << " events dropped by the capture ring\n";
+                }
+                writeTextReport(out, device.metrics, includeDistribution);
+            }
+            break;
+        case ReportFormat::Json:
+            out << "{\"devices\": [";
+            for (size_t i = 0; i < devices.size(); ++i) {
+                const CaptureDevice& device = devices[i];
+                out << (i ? ",\n" : "\n") << "{\"name\": ";
+                writeJsonString(out, device.name);
+                out << ", \"ring_drops\": " << device.capture.getDroppedEvents() << ", \"metrics\": ";
+                writeJsonReport(out, device.metrics);
+                out << '}';
+            }
+            out << "\n]}\n";
+            break;
+    }
+}
+
+void writeAnalysisReport(std::ostream& out, const AnalysisResult& result, ReportFormat format) {
+    switch (format) {
+        case ReportFormat::Text:
+            out << std::fixed << std::setprecision(3);
+            for (const auto& file : result.files) {
+                writeTextSummary(out, file);
+                out << '\n';
+            }
+            writeTextSummary(out, result.aggregate);
+            out << std::defaultfloat;
+            break;
+        case ReportFormat::Json:
+            out << std::setprecision(6) << "{\n  \"files\": [";
+            for (size_t i = 0; i < result.files.size(); ++i) {
+                out << (i ? ",\n    " : "\n    ");
+                writeJsonSummary(out, result.files[i]);
+            }
+            out << "\n  ],\n  \"aggregate\": ";
+            writeJsonSummary(out, result.aggregate);
+            out << "\n}\n";
+            break;
+    }
+}
+
+void writeGroundTruthReport(std::ostream& out, const SyntheticGroundTruth& truth, const SessionStats& measured,
+                            std::uint64_t ringDrops, ReportFormat format) {
+    // Rates come from mean intervals; averaging per-report rates would bias them high
+    const double truthRate = rateFromInterval(truth.interval);
+    const double measuredRate = rateFromInterval(measured.getInterval());
+
+    switch (format) {
+        case ReportFormat::Text:
+            out << std::fixed << std::setprecision(3)
+                << "Ground Truth (" << truth.nominalRateHz << " Hz nominal, " << truth.durationSeconds << " s):\n"
+                << "  Reports: " << truth.reports << " emitted, " << truth.droppedReports
+                << " lost by the generator, " << ringDrops << " dropped by the capture ring\n"
+                << "  Polling Rate: truth " << truthRate << " Hz, measured " << measuredRate << " Hz, error "
+                << relativeError(measuredRate, truthRate) << " %\n";
+            writeTextComparison(out, "Interval", truth.interval, measured.getInterval(), "ms");
+            writeTextComparison(out, "Speed", truth.speed, measured.getSpeed(), "counts/ms");
+            writeTextComparison(out, "Press Duration", truth.pressDuration, measured.getPressDuration(), "ms");
+            out << "  Chatter: truth " << truth.bounces << ", measured " << measured.getButtonCounts().chatter << '\n';
+            out << std::defaultfloat;
+            break;
+        case ReportFormat::Json:
+            out << std::setprecision(6)
+                << "{\"nominal_rate_hz\": " << truth.nominalRateHz
+                << ", \"duration_s\": " << truth.durationSeconds
+                << ", \"reports\": " << truth.reports
+                << ", \"generator_drops\": " << truth.droppedReports
+                << ", \"ring_drops\": " << ringDrops
+                << ",\n   \"polling_hz\": {\"truth\": " << truthRate << ", \"measured\": " << measuredRate
+                << ", \"error_percent\": " << relativeError(measuredRate, truthRate) << '}'
+                << ",\n   \"interval_ms\": ";
+            writeJsonComparison(out, truth.interval, measured.getInterval());
+            out << ",\n   \"speed_counts_per_ms\": ";
+            writeJsonComparison(out, truth.speed, measured.getSpeed());
+            out << ",\n   \"press_duration_ms\": ";
+            writeJsonComparison(out, truth.pressDuration, measured.getPressDuration());
+            out << ",\n   \"chatter\": {\"truth\": " << truth.bounces
+                << ", \"measured\": " << measured.getButtonCounts().chatter << '}';
+            out << "}\n";
+            break;
+    }
+}
+
+void writeComparisonReport(std::ostream& out, const ComparisonResult& result, ReportFormat format) {
+    const double alpha = 1.0 - result.confidence;
+    switch (format) {
+        case ReportFormat::Text:
+            out << std::fixed << std::setprecision(3)
+                << "A: " << result.nameA << "\nB: " << result.nameB << '\n'
+                << "Deltas are B - A with " << std::defaultfloat << result.confidence * 100.0 << std::fixed
+                << " % bootstrap intervals ("
+                << result.resamples << " resamples); * marks intervals excluding zero\n";
+            if (result.metrics.empty()) out << "\nNo metric has samples in both sessions\n";
+            for (const auto& metric : result.metrics) {
+                out << '\n';
+                writeTextMetricComparison(out, metric, alpha);
+            }
+            out << std::defaultfloat;
+            break;
+        case ReportFormat::Json:
+            out << std::setprecision(6) << "{\"a\": ";
+            writeJsonString(out, result.nameA);
+            out << ", \"b\": ";
+            writeJsonString(out, result.nameB);
+            out << ", \"resamples\": " << result.resamples << ", \"confidence\": " << result.confidence
+                << ",\n  \"metrics\": [";
+            for (size_t i = 0; i < result.metrics.size(); ++i) {
+                out << (i ? ",\n    " : "\n    ");
+                writeJsonMetricComparison(out, result.metrics[i]);
+            }
+            out << "\n  ]\n}\n";
+            break;
+    }
+}
@@ -0,0 +1,294 @@
+#include "RollupHistory.hpp"
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+void RollupBucket::add(float value) {
+    if (count == 0) {
+        min = max = value;
+    } else {
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+    ++count;
+    sum += value;
+    ++bins[binOf(value)];
+}
+
+void RollupBucket::merge(const RollupBucket& other) {
+    if (other.count == 0) return;
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+    count += other.count;
+    sum += other.sum;
+    for (size_t i = 0; i < BINS; ++i) bins[i] += other.bins[i];
+}
+
+size_t RollupBucket::binOf(float value) {
+    if (!(value >= 1.f)) return 0;
+    const auto whole = static_cast<std::uint32_t>(std::min(value, 1e9f));
+    return std::min<size_t>(std::bit_width(whole), BINS - 1);
+}
+
+std::int64_t RollupHistory::Tier::oldest() const {
+    if (widens) return 0;
+    return std::max<std::int64_t>(0, newest - static_cast<std::int64_t>(capacity()) + 1);
+}
+
+std::uint32_t RollupHistory::Tier::better(std::uint32_t a, std::uint32_t b) const {
+    if (a == NONE) return b;
+    if (b == NONE) return a;
+    const RollupBucket& first = buckets[a];
+    const RollupBucket& second = buckets[b];
+    return second.count > 0 && (first.count == 0 || second.max > first.max) ? b : a;
+}
+
+void RollupHistory::Tier::refresh(size_t index) {
+    for (size_t node = (index + capacity()) / 2; node > 0; node /= 2) {
+        maxTree[node] = better(maxTree[2 * node], maxTree[2 * node + 1]);
+    }
+}
+
+void RollupHistory::Tier::rebuild() {
+    const size_t leaves = capacity();
+    for (size_t i = 0; i < leaves; ++i) maxTree[leaves + i] = static_cast<std::uint32_t>(i);
+    for (size_t node = leaves - 1; node > 0; --node) {
+        maxTree[node] = better(maxTree[2 * node], maxTree[2 * node + 1]);
+    }
+}
+
+std::uint32_t RollupHistory::Tier::largest(std::int64_t first, std::int64_t last) const {
+    if (last - first + 1 >= static_cast<std::int64_t>(capacity())) return maxTree[1];
+
+    // Bottom-up over slots [low, high]; a range that wraps the ring is two queries
+    auto query = [&](size_t low, size_t high) {
+        std::uint32_t best = NONE;
+        for (low += capacity(), high += capacity() + 1; low < high; low /= 2, high /= 2) {
+            if (low & 1) best = better(best, maxTree[low++]);
+            if (high & 1) best = better(best, maxTree[--high]);
+        }
+        return best;
+    };
+    const size_t low = slot(first);
+    const size_t high = slot(last);
+    return low <= high ? query(low, high) : better(query(low, capacity() - 1), query(0, high));
+}
+
+RollupHistory::RollupHistory()
+    : rawTimes(Config::ROLLUP_RAW_SAMPLES),
+      rawValues(Config::ROLLUP_RAW_SAMPLES) {
+    static_assert(std::has_single_bit(Config::ROLLUP_RAW_SAMPLES), "raw ring size must be a power of two");
+    static_assert(std::size(Config::ROLLUP_TIER_BUCKETS) == TIERS, "every tier needs a bucket count");
+    for (size_t i = 0; i < TIERS; ++i) {
+        tiers[i].buckets.resize(Config::ROLLUP_TIER_BUCKETS[i]);
+        tiers[i].maxTree.resize(2 * Config::ROLLUP_TIER_BUCKETS[i]);
+        tiers[i].widens = i + 1 == TIERS;
+    }
+    clear();
+}
+
+void RollupHistory::clear() {
+    rawHead = rawCount = 0;
+    for (size_t i = 0; i < TIERS; ++i) {
+        Tier& tier = tiers[i];
+        std::fill(tier.buckets.begin(), tier.buckets.end(), RollupBucket{});
+        tier.rebuild();
+        tier.widthNs = Config::ROLLUP_TIER_NS[i];
+        tier.newest = -1;
+        tier.newestEndNs = 0;
+    }
+    originNs = lastNs = 0;
+    total = RollupBucket{};
+}
+
+void RollupHistory::add(std::int64_t timeNs, float value) {
+    if (total.count == 0) originNs = timeNs;
+    else timeNs = std::max(timeNs, lastNs);
+    lastNs = timeNs;
+
+    const size_t mask = rawTimes.size() - 1;
+    if (rawCount == rawTimes.size()) rawHead = (rawHead + 1) & mask;
+    else ++rawCount;
+    const size_t newest = (rawHead + rawCount - 1) & mask;
+    rawTimes[newest] = timeNs;
+    rawValues[newest] = value;
+
+    for (Tier& tier : tiers) addToTier(tier, timeNs, value);
+    total.add(value);
+}
+
+void RollupHistory::addToTier(Tier& tier, std::int64_t timeNs, float value) {
+    // Only a sample past the newest bucket pays for the division
+    if (tier.newest < 0 || timeNs >= tier.newestEndNs) {
+        std::int64_t number = (timeNs - originNs) / tier.widthNs;
+        while (tier.widens && number >= static_cast<std::int64_t>(tier.capacity())) {
+            coarsen(tier);
+            number = (timeNs - originNs) / tier.widthNs;
+        }
+        advance(tier, number);
+    }
+
+    const size_t index = tier.slot(tier.newest);
+    RollupBucket& bucket = tier.buckets[index];
+    const bool raised = bucket.count == 0 || value > bucket.max;
+    bucket.add(value);
+    if (raised) tier.refresh(index);
+}
+
+void RollupHistory::advance(Tier& tier, std::int64_t number) {
+    // Buckets skipped by a gap are emptied as the ring reuses them; a widening
+    // tier has never used the buckets past its newest
+    if (!tier.widens && tier.newest >= 0) {
+        if (number - tier.newest >= static_cast<std::int64_t>(tier.capacity())) {
+            std::fill(tier.buckets.begin(), tier.buckets.end(), RollupBucket{});
+            tier.rebuild();
+        } else {
+            for (std::int64_t skipped = tier.newest + 1; skipped <= number; ++skipped) {
+                const size_t index = tier.slot(skipped);
+                tier.buckets[index] = RollupBucket{};
+                tier.refresh(index);
+            }
+        }
+    }
+    tier.newest = number;
+    tier.newestEndNs = originNs + (number + 1) * tier.widthNs;
+}
+
+void RollupHistory::coarsen(Tier& tier) {
+    const size_t half = tier.capacity() / 2;
+    for (size_t i = 0; i < half; ++i) {
+        RollupBucket merged = tier.buckets[2 * i];
+        merged.merge(tier.buckets[2 * i + 1]);
+        tier.buckets[i] = merged;
+    }
+    std::fill(tier.buckets.begin() + static_cast<std::ptrdiff_t>(half), tier.buckets.end(), RollupBucket{});
+    tier.rebuild();
+
+    tier.widthNs *= 2;
+    tier.newest /= 2;
+    tier.newestEndNs = originNs + (tier.newest + 1) * tier.widthNs;
+}
+
+std::int64_t RollupHistory::getLevelWidthNs(size_t level) const {
+    return level == 0 ? 0 : tiers[level - 1].widthNs;
+}
+
+bool RollupHistory::holds(size_t level, std::int64_t fromNs) const {
+    if (level == 0) return rawCount > 0 && rawTime(0) <= fromNs;
+    const Tier& tier = tiers[level - 1];
+    return originNs + tier.oldest() * tier.widthNs <= fromNs;
+}
+
+size_t RollupHistory::rawLowerBound(std::int64_t timeNs) const {
+    size_t low = 0;
+    size_t high = rawCount;
+    while (low < high) {
+        const size_t middle = low + (high - low) / 2;
+        if (rawTime(middle) < timeNs) low = middle + 1;
+        else high = middle;
+    }
+    return low;
+}
+
+size_t RollupHistory::render(std::int64_t fromNs, std::int64_t toNs,
+                             std::span<MinMaxEnvelope::Column> columns) const {
+    constexpr float INF = std::numeric_limits<float>::infinity();
+    std::fill(columns.begin(), columns.end(), MinMaxEnvelope::Column{INF, -INF});
+
+    const std::int64_t startNs = std::max(fromNs, originNs);
+    const std::int64_t endNs = std::min(toNs, lastNs + 1);
+    if (empty() || columns.empty() || startNs >= endNs) return TIERS;
+
+    // The finest level that still holds the range without exceeding the budget
+    const auto count = static_cast<std::int64_t>(columns.size());
+    const auto budget = static_cast<std::int64_t>(columns.size() * Config::ROLLUP_BUCKETS_PER_COLUMN);
+    size_t level = 0;
+    for (; level < TIERS; ++level) {
+        if (!holds(level, startNs)) continue;
+        const std::int64_t entries = level == 0
+            ? static_cast<std::int64_t>(rawLowerBound(endNs) - rawLowerBound(startNs))
+            : (endNs - 1 - originNs) / tiers[level - 1].widthNs - (startNs - originNs) / tiers[level - 1].widthNs + 1;
+        if (entries <= budget) break;
+    }
+
+    // An entry covers every column its time span touches
+    const std::int64_t spanNs = toNs - fromNs;
+    auto place = [&](std::int64_t entryStart, std::int64_t entryEnd, float min, float max) {
+        const std::int64_t first = std::max<std::int64_t>(entryStart - fromNs, 0) * count / spanNs;
+        const std::int64_t last = std::min(((entryEnd - fromNs) * count + spanNs - 1) / spanNs, count);
+        for (std::int64_t i = first; i < std::max(last, first + 1); ++i) {
+            auto& column = columns[static_cast<size_t>(i)];
+            column.min = std::min(column.min, min);
+            column.max = std::max(column.max, max);
+        }
+    };
+
+    if (level == 0) {
+        const size_t end = rawLowerBound(endNs);
+        for (size_t i = rawLowerBound(startNs); i < end; ++i) {
+            place(rawTime(i), rawTime(i) + 1, rawValue(i), rawValue(i));
+        }
+        return level;
+    }
+
+    const Tier& tier = tiers[level - 1];
+    const std::int64_t last = std::min((endNs - 1 - originNs) / tier.widthNs, tier.newest);
+    for (std::int64_t number = (startNs - originNs) / tier.widthNs; number <= last; ++number) {
+        const RollupBucket& bucket = tier.at(number);
+        if (bucket.count == 0) continue;
+        const std::int64_t bucketStart = originNs + number * tier.widthNs;
+        place(bucketStart, bucketStart + tier.widthNs, bucket.min, bucket.max);
+    }
+    return level;
+}
+
+RollupSpan RollupHistory::findWorst() const {
+    RollupSpan worst;
+    if (empty()) return worst;
+
+    // The session tier always holds it; each finer tier narrows it to one of its buckets
+    const Tier& session = tiers.back();
+    std::int64_t number = session.maxTree[1];
+    worst.level = TIERS;
+    worst.bucket = session.at(number);
+    worst.startNs = originNs + number * session.widthNs;
+    worst.endNs = worst.startNs + session.widthNs;
+
+    for (size_t level = TIERS - 1; level > 0; --level) {
+        const Tier& tier = tiers[level - 1];
+        const std::int64_t first = (worst.startNs - originNs) / tier.widthNs;
+        const std::int64_t last = std::min((worst.endNs - 1 - originNs) / tier.widthNs, tier.newest);
+        if (first < tier.oldest()) return worst;
+
+        const std::uint32_t index = tier.largest(first, last);
+        number = first + static_cast<std::int64_t>((index - tier.slot(first)) & (tier.capacity() - 1));
+        worst.level = level;
+        worst.bucket = tier.at(number);
+        worst.startNs = originNs + number * tier.widthNs;
+        worst.endNs = worst.startNs + tier.widthNs;
+    }
+
+    // The finest bucket holds few enough reports to scan
+    if (!holds(0, worst.startNs)) return worst;
+    const size_t end = rawLowerBound(worst.endNs);
+    size_t best = rawLowerBound(worst.startNs);
+    for (size_t i = best + 1; i < end; ++i) {
+        if (rawValue(i) > rawValue(best)) best = i;
+    }
+    if (best < end) {
+        worst.level = 0;
+        worst.startNs = worst.endNs = rawTime(best);
+        worst.bucket = RollupBucket{};
+        worst.bucket.add(rawValue(best));
+    }
+    return worst;
+}
+
+std::span<const RollupBucket> RollupHistory::getSessionBuckets() const {
+    const Tier& session = tiers.back();
+    return {session.buckets.data(), static_cast<size_t>(session.newest + 1)};
+}
@@ -0,0 +1,268 @@
+#include "SampleExporter.hpp"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
+namespace {
+    constexpr size_t MAX_TEXT_ROW = 256;        // Longest CSV or JSON row, with room to spare
+    constexpr size_t COLUMNAR_ROW = 2 * sizeof(std::int64_t) + 4 * sizeof(float) + 2;
+    constexpr auto WRITER_WAIT = std::chrono::milliseconds(50);
+    constexpr auto FULL_BACKOFF = std::chrono::microseconds(50);
+    constexpr std::string_view CSV_HEADER = "device,timestamp_ns,received_ns,type,button,x,y,dx,dy\n";
+
+    std::string_view typeName(InputEventType type) {
+        switch (type) {
+            case InputEventType::Move:          return "move";
+            case InputEventType::ButtonPress:   return "press";
+            case InputEventType::ButtonRelease: return "release";
+        }
+        return "unknown";
+    }
+
+    // Appends into a buffer already sized for the whole row
+    struct RowWriter {
+        char* next;
+
+        template<typename T>
+        void number(T value) { next = std::to_chars(next, next + 32, value).ptr; }
+        void text(std::string_view value) {
+            std::memcpy(next, value.data(), value.size());
+            next += value.size();
+        }
+        void put(char c) { *next++ = c; }
+    };
+
+    template<typename T>
+    char* writeColumn(char* out, const InputEvent* events, size_t count, T InputEvent::*field) {
+        for (size_t i = 0; i < count; ++i) {
+            const T value = events[i].*field;
+            std::memcpy(out + i * sizeof(T), &value, sizeof(T));
+        }
+        return out + count * sizeof(T);
+    }
+}
+
+bool parseExportFormat(const std::string& text, ExportFormat& format) {
+    if (text == "csv") format = ExportFormat::Csv;
+    else if (text == "jsonl") format = ExportFormat::JsonLines;
+    else if (text == "columnar") format = ExportFormat::Columnar;
+    else return false;
+    return true;
+}
+
+SampleExporter::SampleExporter(const std::string& path, ExportFormat format, bool waitWhenFull)
+    : format(format), waitWhenFull(waitWhenFull), out(path, std::ios::binary | std::ios::trunc) {
+    if (!out) throw std::runtime_error("Cannot create export file " + path);
+
+    if (format == ExportFormat::Csv) {
+        out.write(CSV_HEADER.data(), static_cast<std::streamsize>(CSV_HEADER.size()));
+    } else if (format == ExportFormat::Columnar) {
+        ColumnarFormat::FileHeader header{};
+        std::memcpy(header.magic, ColumnarFormat::MAGIC, sizeof(header.magic));
+        header.version = ColumnarFormat::VERSION;
+        header.createdUnixNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+
+    // Every block is allocated here; afterwards they only circulate
+    const size_t blockBytes = format == ExportFormat::Columnar
+        ? sizeof(ColumnarFormat::BlockHeader) + Config::EXPORT_BLOCK_EVENTS * COLUMNAR_ROW + 8
+        : Config::EXPORT_BLOCK_EVENTS * MAX_TEXT_ROW;
+    text.resize(blockBytes);
+    for (size_t i = 0; i < Config::EXPORT_BLOCKS; ++i) {
+        pool.push_back(std::make_unique<Block>());
+        emptied.tryPush(pool.back().get());
+    }
+
+    writer = std::thread(&SampleExporter::writerLoop, this);
+}
+
+SampleExporter::~SampleExporter() {
+    close();
+}
+
+SampleExporter::Block* SampleExporter::takeBlock() {
+    Block* block = nullptr;
+    while (emptied.popBatch(&block, 1) == 0) {
+        if (!waitWhenFull) return nullptr;
+        std::this_thread::sleep_for(FULL_BACKOFF);
+    }
+    block->count = 0;
+    return block;
+}
+
+void SampleExporter::submit(Block* block) {
+    filled.tryPush(block);  // Never full: it holds at most the whole pool
+    const std::uint64_t queued = filled.size();
+    if (queued > queueHighWater.load(std::memory_order_relaxed)) {
+        queueHighWater.store(queued, std::memory_order_relaxed);
+    }
+
+    // Taking the lock orders this wake-up after the writer's last look at the queue
+    { std::lock_guard<std::mutex> lock(wakeMutex); }
+    wake.notify_one();
+}
+
+void SampleExporter::append(size_t device, std::span<const InputEvent> events) {
+    if (closed || events.empty()) return;
+    if (device >= openBlocks.size()) openBlocks.resize(device + 1, nullptr);
+
+    while (!events.empty()) {
+        Block*& block = openBlocks[device];
+        if (!block && !(block = takeBlock())) {
+            eventsDropped.fetch_add(events.size(), std::memory_order_relaxed);
+            return;
+        }
+
+        block->device = device;
+        const size_t taken = std::min(events.size(), Config::EXPORT_BLOCK_EVENTS - block->count);
+        std::copy_n(events.data(), taken, block->events.get() + block->count);
+        block->count += taken;
+        events = events.subspan(taken);
+        eventsExported.fetch_add(taken, std::memory_order_relaxed);
+
+        if (block->count == Config::EXPORT_BLOCK_EVENTS) {
+            submit(block);
+            block = nullptr;
+        }
+    }
+}
+
+void SampleExporter::close() {
+    if (closed) return;
+    closed = true;
+
+    for (Block*& block : openBlocks) {
+        if (block && block->count > 0) submit(block);
+        block = nullptr;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping.store(true, std::memory_order_release);
+    }
+    wake.notify_one();
+    if (writer.joinable()) writer.join();
+
+    out.close();
+    if (!out) failed.store(true, std::memory_order_relaxed);
+}
+
+ExportStats SampleExporter::getStats() const {
+    ExportStats stats;
+    stats.eventsExported = eventsExported.load(std::memory_order_relaxed);
+    stats.eventsWritten = eventsWritten.load(std::memory_order_relaxed);
+    stats.eventsDropped = eventsDropped.load(std::memory_order_relaxed);
+    stats.blocksWritten = blocksWritten.load(std::memory_order_relaxed);
+    stats.bytesWritten = bytesWritten.load(std::memory_order_relaxed);
+    stats.queueHighWater = queueHighWater.load(std::memory_order_relaxed);
+    stats.failed = failed.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void SampleExporter::writerLoop() {
+    Block* block = nullptr;
+    while (true) {
+        if (filled.popBatch(&block, 1) == 1) {
+            write(*block);
+            emptied.tryPush(block);
+            continue;
+        }
+
+        // Stopping is only seen once every block submitted before it is queued
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        if (stopping.load(std::memory_order_acquire) && filled.size() == 0) break;
+        wake.wait_for(lock, WRITER_WAIT, [&] {
+            return filled.size() > 0 || stopping.load(std::memory_order_acquire);
+        });
+    }
+    out.flush();
+}
+
+void SampleExporter::write(const Block& block) {
+    if (failed.load(std::memory_order_relaxed)) {
+        // Out of disk: keep recycling blocks so measuring carries on
+        eventsDropped.fetch_add(block.count, std::memory_order_relaxed);
+        return;
+    }
+
+    size_t size = 0;
+    switch (format) {
+        case ExportFormat::Csv:       size = formatCsv(block); break;
+        case ExportFormat::JsonLines: size = formatJsonLines(block); break;
+        case ExportFormat::Columnar:  size = formatColumnar(block); break;
+    }
+
+    out.write(text.data(), static_cast<std::streamsize>(size));
+    if (!out) {
+        failed.store(true, std::memory_order_relaxed);
+        eventsDropped.fetch_add(block.count, std::memory_order_relaxed);
+        return;
+    }
+    eventsWritten.fetch_add(block.count, std::memory_order_relaxed);
+    blocksWritten.fetch_add(1, std::memory_order_relaxed);
+    bytesWritten.fetch_add(size, std::memory_order_relaxed);
+}
+
+size_t SampleExporter::formatCsv(const Block& block) {
+    RowWriter row{text.data()};
+    for (size_t i = 0; i < block.count; ++i) {
+        const InputEvent& event = block.events[i];
+        row.number(block.device); row.put(',');
+        row.number(event.timestampNs); row.put(',');
+        row.number(event.receivedNs); row.put(',');
+        row.text(typeName(event.type)); row.put(',');
+        row.number(static_cast<unsigned>(event.button)); row.put(',');
+        row.number(event.x); row.put(',');
+        row.number(event.y); row.put(',');
+        row.number(event.dx); row.put(',');
+        row.number(event.dy); row.put('\n');
+    }
+    return static_cast<size_t>(row.next - text.data());
+}
+
+size_t SampleExporter::formatJsonLines(const Block& block) {
+    RowWriter row{text.data()};
+    for (size_t i = 0; i < block.count; ++i) {
+        const InputEvent& event = block.events[i];
+        row.text("{\"device\":"); row.number(block.device);
+        row.text(",\"timestamp_ns\":"); row.number(event.timestampNs);
+        row.text(",\"received_ns\":"); row.number(event.receivedNs);
+        row.text(",\"type\":\""); row.text(typeName(event.type));
+        row.text("\",\"button\":"); row.number(static_cast<unsigned>(event.button));
+        row.text(",\"x\":"); row.number(event.x);
+        row.text(",\"y\":"); row.number(event.y);
+        row.text(",\"dx\":"); row.number(event.dx);
+        row.text(",\"dy\":"); row.number(event.dy);
+        row.text("}\n");
+    }
+    return static_cast<size_t>(row.next - text.data());
+}
+
+size_t SampleExporter::formatColumnar(const Block& block) {
+    ColumnarFormat::BlockHeader header{};
+    std::memcpy(header.magic, ColumnarFormat::BLOCK_MAGIC, sizeof(header.magic));
+    header.eventCount = static_cast<std::uint32_t>(block.count);
+    header.device = static_cast<std::uint32_t>(block.device);
+    std::memcpy(text.data(), &header, sizeof(header));
+
+    const InputEvent* events = block.events.get();
+    char* next = text.data() + sizeof(header);
+    next = writeColumn(next, events, block.count, &InputEvent::timestampNs);
+    next = writeColumn(next, events, block.count, &InputEvent::receivedNs);
+    next = writeColumn(next, events, block.count, &InputEvent::x);
+    next = writeColumn(next, events, block.count, &InputEvent::y);
+    next = writeColumn(next, events, block.count, &InputEvent::dx);
+    next = writeColumn(next, events, block.count, &InputEvent::dy);
+    next = writeColumn(next, events, block.count, &InputEvent::type);
+    next = writeColumn(next, events, block.count, &InputEvent::button);
+
+    size_t size = static_cast<size_t>(next - text.data());
+    const size_t padded = (size + 7) & ~size_t{7};
+    std::fill(text.data() + size, text.data() + padded, '\0');
+    return padded;
+}
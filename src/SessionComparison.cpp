@@ -0,0 +1,246 @@
+#include "SessionComparison.hpp"
+#include "WorkStealingPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+
+namespace {
+    constexpr double PERCENTILES[] = {50.0, 90.0, 99.0, 99.9};
+    constexpr const char* STATISTIC_NAMES[] = {"P50", "P90", "P99", "P99.9", "Std Dev"};
+    constexpr size_t PERCENTILE_COUNT = std::size(PERCENTILES);
+    constexpr size_t STATISTIC_COUNT = std::size(STATISTIC_NAMES);
+
+    struct Distribution {
+        std::vector<std::int64_t> values;
+        std::vector<std::uint64_t> counts;
+        std::uint64_t total{0};
+
+        explicit Distribution(const Histogram& histogram) : total(histogram.getTotalCount()) {
+            histogram.getDistribution(values, counts);
+        }
+    };
+
+    struct MetricJob {
+        Distribution a;
+        Distribution b;
+        std::vector<double> deltas;     // resamples x STATISTIC_COUNT, b - a
+        MetricComparison result;
+    };
+
+    // Percentiles as Histogram reports them, then the standard deviation
+    void computeStatistics(const std::vector<std::int64_t>& values, const std::uint64_t* counts,
+                           std::uint64_t total, double* out) {
+        std::uint64_t targets[PERCENTILE_COUNT];
+        for (size_t p = 0; p < PERCENTILE_COUNT; ++p) {
+            targets[p] = std::max<std::uint64_t>(1,
+                static_cast<std::uint64_t>(PERCENTILES[p] / 100.0 * static_cast<double>(total) + 0.5));
+        }
+
+        size_t next = 0;
+        std::uint64_t cumulative = 0;
+        double sum = 0.0;
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (counts[i] == 0) continue;
+            cumulative += counts[i];
+            sum += static_cast<double>(counts[i]) * static_cast<double>(values[i]);
+            while (next < PERCENTILE_COUNT && cumulative >= targets[next]) {
+                out[next++] = static_cast<double>(values[i]);
+            }
+        }
+        for (; next < PERCENTILE_COUNT; ++next) out[next] = static_cast<double>(values.back());
+
+        // Second pass: the sum of squares would lose the spread to cancellation
+        const double mean = sum / static_cast<double>(total);
+        double squares = 0.0;
+        for (size_t i = 0; i < values.size(); ++i) {
+            const double deviation = static_cast<double>(values[i]) - mean;
+            squares += static_cast<double>(counts[i]) * deviation * deviation;
+        }
+        out[PERCENTILE_COUNT] = total > 1 ? std::sqrt(squares / static_cast<double>(total - 1)) : 0.0;
+    }
+
+    // Bootstrap resample: total draws with replacement, as a multinomial over the
+    // buckets drawn one conditional binomial at a time
+    void resample(const Distribution& distribution, std::mt19937_64& rng, std::vector<std::uint64_t>& out) {
+        std::uint64_t remaining = distribution.total;
+        std::uint64_t remainingWeight = distribution.total;
+        for (size_t i = 0; i < out.size(); ++i) {
+            if (remaining == 0 || i + 1 == out.size()) {
+                out[i] = remaining;
+                remaining = 0;
+                continue;
+            }
+            const double share = static_cast<double>(distribution.counts[i]) / static_cast<double>(remainingWeight);
+            std::binomial_distribution<std::uint64_t> draw(remaining, std::min(share, 1.0));
+            out[i] = draw(rng);
+            remaining -= out[i];
+            remainingWeight -= distribution.counts[i];
+        }
+    }
+
+    std::uint64_t splitMix64(std::uint64_t value) {
+        value += 0x9E3779B97F4A7C15ULL;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        return value ^ (value >> 31);
+    }
+
+    // Kolmogorov-Smirnov statistic and Cliff's delta in one merged pass over both distributions
+    void compareDistributions(const Distribution& a, const Distribution& b, MetricComparison& result) {
+        size_t i = 0;
+        size_t j = 0;
+        std::uint64_t belowA = 0;
+        std::uint64_t belowB = 0;
+        double dominance = 0.0;
+        while (i < a.values.size() || j < b.values.size()) {
+            const std::int64_t value = j == b.values.size() || (i < a.values.size() && a.values[i] < b.values[j])
+                ? a.values[i] : b.values[j];
+            const std::uint64_t atA = i < a.values.size() && a.values[i] == value ? a.counts[i++] : 0;
+            const std::uint64_t atB = j < b.values.size() && b.values[j] == value ? b.counts[j++] : 0;
+
+            // B's samples here beat every A sample below and lose to every one above
+            const std::uint64_t aboveA = a.total - belowA - atA;
+            dominance += static_cast<double>(atB) * (static_cast<double>(belowA) - static_cast<double>(aboveA));
+            belowA += atA;
+            belowB += atB;
+            const double gap = static_cast<double>(belowA) / static_cast<double>(a.total) -
+                               static_cast<double>(belowB) / static_cast<double>(b.total);
+            result.ksStatistic = std::max(result.ksStatistic, std::abs(gap));
+        }
+        result.cliffsDelta = dominance / (static_cast<double>(a.total) * static_cast<double>(b.total));
+    }
+
+    // Asymptotic distribution of the two-sample statistic (Numerical Recipes' probks)
+    double kolmogorovPValue(double statistic, std::uint64_t countA, std::uint64_t countB) {
+        const double effective = static_cast<double>(countA) * static_cast<double>(countB) /
+                                 static_cast<double>(countA + countB);
+        const double root = std::sqrt(effective);
+        const double lambda = (root + 0.12 + 0.11 / root) * statistic;
+
+        double sum = 0.0;
+        double sign = 2.0;
+        double previous = 0.0;
+        for (int j = 1; j <= 100; ++j) {
+            const double term = sign * std::exp(-2.0 * j * j * lambda * lambda);
+            sum += term;
+            if (std::abs(term) <= 1e-3 * previous || std::abs(term) <= 1e-8 * sum) return std::clamp(sum, 0.0, 1.0);
+            sign = -sign;
+            previous = std::abs(term);
+        }
+        return 1.0;     // Only fails to converge for distributions too close to tell apart
+    }
+
+    double mean(const Distribution& distribution) {
+        double sum = 0.0;
+        for (size_t i = 0; i < distribution.values.size(); ++i) {
+            sum += static_cast<double>(distribution.counts[i]) * static_cast<double>(distribution.values[i]);
+        }
+        return sum / static_cast<double>(distribution.total);
+    }
+
+    // Interval bounds from the sorted bootstrap deltas (percentile method)
+    void confidenceInterval(std::vector<double>& column, double confidence, double& lower, double& upper) {
+        const double tail = (1.0 - confidence) / 2.0;
+        const double last = static_cast<double>(column.size() - 1);
+        const auto lowerIndex = static_cast<size_t>(std::floor(tail * last));
+        const auto upperIndex = static_cast<size_t>(std::ceil((1.0 - tail) * last));
+        std::nth_element(column.begin(), column.begin() + lowerIndex, column.end());
+        lower = column[lowerIndex];
+        std::nth_element(column.begin(), column.begin() + upperIndex, column.end());
+        upper = column[upperIndex];
+    }
+}
+
+SessionComparator::SessionComparator(std::size_t threadCount, std::size_t resamples, double confidence,
+                                     std::uint64_t seed)
+    : threadCount(std::max<std::size_t>(threadCount, 1)), resamples(std::max<std::size_t>(resamples, 1)),
+      confidence(confidence), seed(seed) {}
+
+ComparisonResult SessionComparator::compare(const ComparedSession& a, const ComparedSession& b) const {
+    ComparisonResult result;
+    result.nameA = a.name;
+    result.nameB = b.name;
+    result.resamples = resamples;
+    result.confidence = confidence;
+
+    const struct {
+        const char* name;
+        const Histogram& a;
+        const Histogram& b;
+    } metrics[] = {
+        {"Click Latency", a.latency, b.latency},
+        {"Report Interval", a.interval, b.interval},
+        {"Press Duration", a.pressDuration, b.pressDuration},
+    };
+
+    std::vector<std::unique_ptr<MetricJob>> jobs;
+    for (const auto& metric : metrics) {
+        if (metric.a.getTotalCount() == 0 || metric.b.getTotalCount() == 0) continue;
+        jobs.push_back(std::make_unique<MetricJob>(MetricJob{Distribution(metric.a), Distribution(metric.b),
+                                                             {}, {}}));
+        jobs.back()->result.name = metric.name;
+        jobs.back()->deltas.resize(resamples * STATISTIC_COUNT);
+    }
+
+    // Every chunk of every metric is an independent task
+    const size_t chunkCount = (resamples + Config::COMPARE_CHUNK_RESAMPLES - 1) / Config::COMPARE_CHUNK_RESAMPLES;
+    WorkStealingPool pool(std::min(threadCount, jobs.size() * chunkCount + 1));
+    for (size_t m = 0; m < jobs.size(); ++m) {
+        for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+            pool.submit([&, m, chunk] {
+                MetricJob& job = *jobs[m];
+                std::mt19937_64 rng(splitMix64(seed ^ (static_cast<std::uint64_t>(m) << 32) ^ chunk));
+                std::vector<std::uint64_t> countsA(job.a.counts.size());
+                std::vector<std::uint64_t> countsB(job.b.counts.size());
+                double statisticsA[STATISTIC_COUNT];
+                double statisticsB[STATISTIC_COUNT];
+
+                const size_t end = std::min(resamples, (chunk + 1) * Config::COMPARE_CHUNK_RESAMPLES);
+                for (size_t r = chunk * Config::COMPARE_CHUNK_RESAMPLES; r < end; ++r) {
+                    resample(job.a, rng, countsA);
+                    resample(job.b, rng, countsB);
+                    computeStatistics(job.a.values, countsA.data(), job.a.total, statisticsA);
+                    computeStatistics(job.b.values, countsB.data(), job.b.total, statisticsB);
+                    for (size_t s = 0; s < STATISTIC_COUNT; ++s) {
+                        job.deltas[r * STATISTIC_COUNT + s] = statisticsB[s] - statisticsA[s];
+                    }
+                }
+            });
+        }
+    }
+    pool.wait();
+
+    std::vector<double> column(resamples);
+    for (auto& job : jobs) {
+        MetricComparison& metric = job->result;
+        metric.countA = job->a.total;
+        metric.countB = job->b.total;
+        metric.meanA = mean(job->a);
+        metric.meanB = mean(job->b);
+
+        double observedA[STATISTIC_COUNT];
+        double observedB[STATISTIC_COUNT];
+        computeStatistics(job->a.values, job->a.counts.data(), job->a.total, observedA);
+        computeStatistics(job->b.values, job->b.counts.data(), job->b.total, observedB);
+        for (size_t s = 0; s < STATISTIC_COUNT; ++s) {
+            StatisticDelta statistic{STATISTIC_NAMES[s], observedA[s], observedB[s]};
+            for (size_t r = 0; r < resamples; ++r) column[r] = job->deltas[r * STATISTIC_COUNT + s];
+            confidenceInterval(column, confidence, statistic.lower, statistic.upper);
+            metric.statistics.push_back(statistic);
+        }
+
+        compareDistributions(job->a, job->b, metric);
+        metric.ksPValue = kolmogorovPValue(metric.ksStatistic, metric.countA, metric.countB);
+
+        const double sdA = observedA[PERCENTILE_COUNT];
+        const double sdB = observedB[PERCENTILE_COUNT];
+        const double pooledVariance = (static_cast<double>(metric.countA - 1) * sdA * sdA +
+                                       static_cast<double>(metric.countB - 1) * sdB * sdB) /
+                                      static_cast<double>(metric.countA + metric.countB - 2);
+        metric.cohensD = pooledVariance > 0.0 ? (metric.meanB - metric.meanA) / std::sqrt(pooledVariance) : 0.0;
+
+        result.metrics.push_back(std::move(metric));
+    }
+    return result;
+}
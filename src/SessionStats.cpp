@@ -0,0 +1,104 @@
+#include "SessionStats.hpp"
+#include "Config.hpp"
+#include <algorithm>
+#include <cmath>
+
+void RunningMoments::add(double value) {
+    if (count == 0) {
+        min = max = value;
+    } else {
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+
+    ++count;
+    double delta = value - mean;
+    mean += delta / static_cast<double>(count);
+    m2 += delta * (value - mean);
+}
+
+void RunningMoments::merge(const RunningMoments& other) {
+    if (other.count == 0) return;
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+
+    const double total = static_cast<double>(count + other.count);
+    const double delta = other.mean - mean;
+    mean += delta * static_cast<double>(other.count) / total;
+    m2 += other.m2 + delta * delta * static_cast<double>(count) * static_cast<double>(other.count) / total;
+    count += other.count;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+}
+
+double RunningMoments::stddev() const {
+    return std::sqrt(variance());
+}
+
+SessionStats::SessionStats()
+    : latencyHistogram(Config::HISTOGRAM_LOWEST_US, Config::HISTOGRAM_HIGHEST_US, Config::HISTOGRAM_SIGNIFICANT_DIGITS),
+      intervalHistogram(Config::HISTOGRAM_LOWEST_US, Config::HISTOGRAM_HIGHEST_US, Config::HISTOGRAM_SIGNIFICANT_DIGITS),
+      pressDurationHistogram(Config::HISTOGRAM_LOWEST_US, Config::HISTOGRAM_HIGHEST_US, Config::HISTOGRAM_SIGNIFICANT_DIGITS) {}
+
+void SessionStats::addLatencyMeasurement(double, double value) {
+    if (!SampleFilter::validLatency(value)) return;
+    latency.add(value);
+    latencyHistogram.record(std::llround(value * 1000.0));
+}
+
+void SessionStats::addPollingMeasurement(double, double value, float, float) {
+    if (!SampleFilter::validInterval(value)) return;
+    interval.add(value);
+    pollingRate.add(1000.0 / value);
+    intervalHistogram.record(std::llround(value * 1000.0));
+}
+
+void SessionStats::addMovementMeasurement(double, float, float, float velocity, std::int32_t, std::int32_t) {
+    speed.add(velocity);
+}
+
+void SessionStats::addPressMeasurement(double, std::uint8_t, double duration) {
+    ++buttonCounts.clicks;
+    if (!SampleFilter::validPressDuration(duration)) return;
+    pressDuration.add(duration);
+    pressDurationHistogram.record(std::llround(duration * 1000.0));
+}
+
+void SessionStats::addButtonFault(double, std::uint8_t, ButtonFault fault) {
+    buttonCounts.add(fault);
+}
+
+void SessionStats::countEvent(std::int64_t timestampNs) {
+    if (eventCount == 0) firstTimestamp = timestampNs;
+    lastTimestamp = timestampNs;
+    ++eventCount;
+}
+
+void SessionStats::merge(const SessionStats& other) {
+    if (other.eventCount == 0) return;
+
+    if (eventCount == 0) {
+        firstTimestamp = other.firstTimestamp;
+        lastTimestamp = other.lastTimestamp;
+    } else {
+        firstTimestamp = std::min(firstTimestamp, other.firstTimestamp);
+        lastTimestamp = std::max(lastTimestamp, other.lastTimestamp);
+    }
+    eventCount += other.eventCount;
+
+    latency.merge(other.latency);
+    pollingRate.merge(other.pollingRate);
+    interval.merge(other.interval);
+    speed.merge(other.speed);
+    pressDuration.merge(other.pressDuration);
+    buttonCounts.merge(other.buttonCounts);
+    latencyHistogram.add(other.latencyHistogram);
+    intervalHistogram.add(other.intervalHistogram);
+    pressDurationHistogram.add(other.pressDurationHistogram);
+}
+
+double SessionStats::getDurationSeconds() const {
+    return eventCount > 1 ? (lastTimestamp - firstTimestamp) * 1e-9 : 0.0;
+}
@@ -0,0 +1,39 @@
+#include "StatsOverlay.hpp"
+#include <string>
+
+void StatsOverlay::setStyle(const sf::Font& font, unsigned int characterSize, const sf::Color& color) {
+    this->font = &font;
+    this->characterSize = characterSize;
+    this->color = color;
+}
+
+size_t StatsOverlay::addLine(std::string_view label) {
+    const float y = static_cast<float>(lines.size()) * font->getLineSpacing(characterSize);
+
+    Line& line = lines.emplace_back();
+    for (sf::Text* text : {&line.label, &line.value}) {
+        text->setFont(*font);
+        text->setCharacterSize(characterSize);
+        text->setFillColor(color);
+    }
+    line.label.setString(std::string(label));
+    line.label.setPosition(0.f, y);
+    line.value.setPosition(line.label.findCharacterPos(label.size()).x, y);
+    return lines.size() - 1;
+}
+
+void StatsOverlay::setValue(size_t index, const Value& value) {
+    Line& line = lines[index];
+    if (line.shown == value) return;
+
+    line.shown = value;
+    line.value.setString(line.shown.c_str());
+}
+
+void StatsOverlay::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    states.transform *= getTransform();
+    for (const auto& line : lines) {
+        target.draw(line.label, states);
+        if (line.shown.size() > 0) target.draw(line.value, states);
+    }
+}
@@ -0,0 +1,319 @@
+#include "SyntheticInputSource.hpp"
+#include "Clock.hpp"
+#include "Config.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <sstream>
+#include <vector>
+
+namespace {
+    constexpr double MAX_RATE_HZ = 32000.0;
+    constexpr std::int64_t BURST_SPACING_NS = 2'000;
+    constexpr double MOTION_ANGLE = 0.5;    // Radians; keeps both axes moving
+    constexpr std::int64_t BOUNCE_NS = 1'000'000;   // Open and re-close times of a bounce, inside the debounce window
+
+    std::vector<std::string> split(const std::string& text, char separator) {
+        std::vector<std::string> parts;
+        std::stringstream stream(text);
+        std::string part;
+        while (std::getline(stream, part, separator)) parts.push_back(part);
+        return parts;
+    }
+
+    bool parseNumber(const std::string& text, double& value) {
+        try {
+            size_t parsed = 0;
+            value = std::stod(text, &parsed);
+            return parsed == text.size();
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+
+    // "name:a:b..." with exactly `count` numeric parameters
+    bool parseParameters(const std::vector<std::string>& parts, std::initializer_list<double*> values) {
+        if (parts.size() != values.size() + 1) return false;
+        size_t i = 1;
+        for (double* value : values) {
+            if (!parseNumber(parts[i++], *value)) return false;
+        }
+        return true;
+    }
+}
+
+bool parseSyntheticSpec(const std::string& text, SyntheticConfig& config) {
+    for (const auto& setting : split(text, ',')) {
+        const size_t equals = setting.find('=');
+        if (equals == std::string::npos) return false;
+        const std::string key = setting.substr(0, equals);
+        const std::string value = setting.substr(equals + 1);
+        const auto parts = split(value, ':');
+        if (parts.empty()) return false;
+
+        bool ok = true;
+        if (key == "rate") {
+            ok = parseNumber(value, config.rateHz) && config.rateHz > 0.0 && config.rateHz <= MAX_RATE_HZ;
+        } else if (key == "jitter") {
+            if (parts[0] == "none") {
+                config.jitter = SyntheticJitter::None;
+                ok = parts.size() == 1;
+            } else if (parts[0] == "gauss") {
+                config.jitter = SyntheticJitter::Gaussian;
+                ok = parseParameters(parts, {&config.jitterAmount}) && config.jitterAmount >= 0.0;
+            } else if (parts[0] == "burst") {
+                config.jitter = SyntheticJitter::Bursty;
+                ok = parseParameters(parts, {&config.jitterAmount}) && config.jitterAmount >= 1.0;
+            } else {
+                ok = false;
+            }
+        } else if (key == "drop") {
+            ok = parseNumber(value, config.dropProbability) && config.dropProbability >= 0.0 &&
+                 config.dropProbability < 1.0;
+        } else if (key == "motion") {
+            if (parts[0] == "constant") {
+                config.motion = SyntheticMotion::Constant;
+                ok = parseParameters(parts, {&config.speed});
+            } else if (parts[0] == "circle") {
+                config.motion = SyntheticMotion::Circle;
+                ok = parseParameters(parts, {&config.radius, &config.periodMs}) && config.periodMs > 0.0;
+            } else if (parts[0] == "flick") {
+                config.motion = SyntheticMotion::Flick;
+                ok = parseParameters(parts, {&config.speed, &config.flickMs, &config.periodMs}) &&
+                     config.flickMs > 0.0 && config.periodMs >= config.flickMs;
+            } else {
+                ok = false;
+            }
+        } else if (key == "clicks") {
+            if (parts[0] == "none") {
+                config.clicks = SyntheticClicks::None;
+                ok = parts.size() == 1;
+            } else if (parts[0] == "periodic" || parts[0] == "random") {
+                config.clicks = parts[0] == "periodic" ? SyntheticClicks::Periodic : SyntheticClicks::Random;
+                ok = parseParameters(parts, {&config.clickPeriodMs}) && config.clickPeriodMs > 0.0;
+            } else {
+                ok = false;
+            }
+        } else if (key == "hold") {
+            ok = parseNumber(value, config.holdMs) && config.holdMs >= 0.0;
+        } else if (key == "bounce") {
+            ok = parseNumber(value, config.bounceProbability) && config.bounceProbability >= 0.0 &&
+                 config.bounceProbability <= 1.0;
+        } else if (key == "duration") {
+            ok = parseNumber(value, config.durationSeconds) && config.durationSeconds > 0.0;
+        } else if (key == "pace") {
+            ok = value == "realtime" || value == "max";
+            config.realTime = value == "realtime";
+        } else if (key == "seed") {
+            double seed;
+            ok = parseNumber(value, seed) && seed >= 0.0;
+            config.seed = static_cast<std::uint64_t>(seed);
+        } else {
+            ok = false;
+        }
+        if (!ok) return false;
+    }
+
+    // Clicks must finish before the next one starts, and outlast their bounce
+    if (config.bounceProbability > 0.0 && config.holdMs * 1e6 <= 2.0 * BOUNCE_NS) return false;
+    return config.clicks == SyntheticClicks::None || config.holdMs < config.clickPeriodMs;
+}
+
+SyntheticInputSource::SyntheticInputSource(const SyntheticConfig& config)
+    : config(config), waiter(Config::SOURCE_MAX_SPIN_NS) {}
+
+bool SyntheticInputSource::open() {
+    rng.seed(config.seed);
+    truth = SyntheticGroundTruth{};
+    truth.nominalRateHz = config.rateHz;
+    truth.durationSeconds = config.durationSeconds;
+
+    // Live-paced timestamps share the capture clock; unpaced ones start at zero
+    originNs = config.realTime ? Clock::nowNs() : 0;
+    endNs = static_cast<std::int64_t>(config.durationSeconds * 1e9);
+
+    reportSlot = 0;
+    nextReportNs = 0;
+    lastScheduledNs = -1;
+    lastReportNs = -1;
+    positionAt(0.0, lastPathX, lastPathY);
+    countsX = std::llround(lastPathX);
+    countsY = std::llround(lastPathY);
+    cursorX = Config::WINDOW_WIDTH / 2.f;
+    cursorY = Config::WINDOW_HEIGHT / 2.f;
+
+    scheduleNextReport();
+    nextPressNs = nextReleaseNs = pressStartNs = -1;
+    bouncing = false;
+    if (config.clicks != SyntheticClicks::None) scheduleNextPress(0);
+    updateNextEvent();
+    return true;
+}
+
+void SyntheticInputSource::scheduleNextReport() {
+    const double periodNs = 1e9 / config.rateHz;
+    std::bernoulli_distribution dropped(config.dropProbability);
+
+    while (true) {
+        const std::uint64_t slot = reportSlot++;
+        double timeNs = static_cast<double>(slot) * periodNs;
+
+        switch (config.jitter) {
+            case SyntheticJitter::None:
+                break;
+            case SyntheticJitter::Gaussian: {
+                std::normal_distribution<double> jitter(0.0, config.jitterAmount * periodNs);
+                timeNs += jitter(rng);
+                break;
+            }
+            case SyntheticJitter::Bursty: {
+                // The burst is sent together at the start of its group's window
+                const auto burst = static_cast<std::uint64_t>(config.jitterAmount);
+                const double spacing = std::min(static_cast<double>(BURST_SPACING_NS), periodNs / config.jitterAmount);
+                timeNs = static_cast<double>(slot / burst * burst) * periodNs + static_cast<double>(slot % burst) * spacing;
+                break;
+            }
+        }
+
+        // Reports never reorder, however large the jitter. The clamp is against the last
+        // scheduled slot: the current report is only emitted after this call, and dropped
+        // or still reports never become the last emitted one.
+        nextReportNs = std::max(static_cast<std::int64_t>(timeNs), lastScheduledNs + 1);
+        lastScheduledNs = nextReportNs;
+        if (!dropped(rng)) return;
+        ++truth.droppedReports;
+    }
+}
+
+void SyntheticInputSource::scheduleNextPress(std::int64_t afterNs) {
+    double gapMs = config.clickPeriodMs;
+    if (config.clicks == SyntheticClicks::Random) {
+        // Exponential gaps after the button comes back up
+        std::exponential_distribution<double> gap(1.0 / config.clickPeriodMs);
+        gapMs = config.holdMs + gap(rng);
+    }
+    nextPressNs = afterNs + static_cast<std::int64_t>(gapMs * 1e6);
+}
+
+void SyntheticInputSource::updateNextEvent() {
+    nextEventNs = nextReportNs;
+    if (nextPressNs >= 0) nextEventNs = std::min(nextEventNs, nextPressNs);
+    if (nextReleaseNs >= 0) nextEventNs = std::min(nextEventNs, nextReleaseNs);
+}
+
+void SyntheticInputSource::positionAt(double timeMs, double& x, double& y) const {
+    switch (config.motion) {
+        case SyntheticMotion::Constant: {
+            const double distance = config.speed * timeMs;
+            x = distance * std::cos(MOTION_ANGLE);
+            y = distance * std::sin(MOTION_ANGLE);
+            break;
+        }
+        case SyntheticMotion::Circle: {
+            const double phase = 2.0 * std::numbers::pi * timeMs / config.periodMs;
+            x = config.radius * std::cos(phase);
+            y = config.radius * std::sin(phase);
+            break;
+        }
+        case SyntheticMotion::Flick: {
+            // Alternating left/right flicks with a raised-cosine speed profile,
+            // still in between
+            const auto flick = static_cast<std::int64_t>(timeMs / config.periodMs);
+            const double tau = std::min(timeMs - static_cast<double>(flick) * config.periodMs, config.flickMs);
+            const double angle = 2.0 * std::numbers::pi * tau / config.flickMs;
+            const double travelled = config.speed / 2.0 * (tau - config.flickMs / (2.0 * std::numbers::pi) * std::sin(angle));
+            const double flickDistance = config.speed * config.flickMs / 2.0;
+
+            const bool leftward = flick % 2 == 1;
+            x = leftward ? flickDistance - travelled : travelled;
+            y = 0.0;
+            break;
+        }
+    }
+}
+
+bool SyntheticInputSource::emitNext(InputEvent& out) {
+    const std::int64_t timeNs = nextEventNs;
+    out = InputEvent{};
+    out.timestampNs = originNs + timeNs;
+
+    if (timeNs == nextReportNs) {
+        scheduleNextReport();
+        updateNextEvent();
+
+        double pathX, pathY;
+        positionAt(static_cast<double>(timeNs) * 1e-6, pathX, pathY);
+        const std::int64_t newCountsX = std::llround(pathX);
+        const std::int64_t newCountsY = std::llround(pathY);
+        // A still sensor sends nothing
+        if (newCountsX == countsX && newCountsY == countsY) return false;
+
+        if (lastReportNs >= 0) {
+            const double intervalMs = static_cast<double>(timeNs - lastReportNs) * 1e-6;
+            truth.interval.add(intervalMs);
+            truth.speed.add(std::hypot(pathX - lastPathX, pathY - lastPathY) / intervalMs);
+        }
+
+        out.type = InputEventType::Move;
+        out.dx = static_cast<std::int32_t>(newCountsX - countsX);
+        out.dy = static_cast<std::int32_t>(newCountsY - countsY);
+        cursorX = std::clamp(cursorX + static_cast<float>(out.dx), 0.f, static_cast<float>(Config::WINDOW_WIDTH - 1));
+        cursorY = std::clamp(cursorY + static_cast<float>(out.dy), 0.f, static_cast<float>(Config::WINDOW_HEIGHT - 1));
+
+        countsX = newCountsX;
+        countsY = newCountsY;
+        lastPathX = pathX;
+        lastPathY = pathY;
+        lastReportNs = timeNs;
+        ++truth.reports;
+    } else if (timeNs == nextPressNs) {
+        out.type = InputEventType::ButtonPress;
+        nextPressNs = -1;
+        const std::int64_t holdNs = static_cast<std::int64_t>(config.holdMs * 1e6);
+        if (bouncing) {
+            // The contact closes again; the click still ends a hold after its first press
+            bouncing = false;
+            nextReleaseNs = pressStartNs + holdNs;
+        } else {
+            ++truth.presses;
+            truth.pressDuration.add(static_cast<double>(holdNs) * 1e-6);
+            pressStartNs = timeNs;
+            // Drawn only when asked for, so existing seeds keep their report schedules
+            bouncing = config.bounceProbability > 0.0 &&
+                       std::bernoulli_distribution(config.bounceProbability)(rng);
+            if (bouncing) ++truth.bounces;
+            nextReleaseNs = timeNs + (bouncing ? BOUNCE_NS : holdNs);
+        }
+        updateNextEvent();
+    } else {
+        out.type = InputEventType::ButtonRelease;
+        if (bouncing) nextPressNs = timeNs + BOUNCE_NS;
+        else scheduleNextPress(timeNs);
+        nextReleaseNs = -1;
+        updateNextEvent();
+    }
+
+    out.x = cursorX;
+    out.y = cursorY;
+    return true;
+}
+
+std::size_t SyntheticInputSource::read(InputEvent* out, std::size_t maxCount, int timeoutMs) {
+    if (exhausted()) return 0;
+
+    std::int64_t dueLimit = endNs;
+    if (config.realTime) {
+        const std::int64_t limit = Clock::nowNs() + static_cast<std::int64_t>(timeoutMs) * 1'000'000;
+        if (originNs + nextEventNs > limit) {
+            waiter.waitUntil(limit);
+            return 0;
+        }
+        dueLimit = std::min(dueLimit, waiter.waitUntil(originNs + nextEventNs) - originNs);
+    }
+
+    std::size_t count = 0;
+    while (count < maxCount && nextEventNs <= dueLimit) {
+        if (emitNext(out[count])) ++count;
+    }
+    return count;
+}
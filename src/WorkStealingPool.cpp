@@ -0,0 +1,114 @@
+#include "WorkStealingPool.hpp"
+
+namespace {
+    thread_local const WorkStealingPool* currentPool = nullptr;
+    thread_local std::size_t currentWorker = 0;
+}
+
+WorkStealingPool::WorkStealingPool(std::size_t threadCount) {
+    if (threadCount == 0) threadCount = 1;
+
+    for (std::size_t i = 0; i < threadCount; ++i) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (std::size_t i = 0; i < threadCount; ++i) {
+        workers.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void WorkStealingPool::submit(Task task) {
+    const std::size_t index = currentPool == this
+        ? currentWorker
+        : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+
+    pending.fetch_add(1, std::memory_order_acq_rel);
+    {
+        // Counting under the state mutex means a worker about to sleep cannot miss it.
+        // The count goes up before the push so it never underflows when a thief is quick.
+        std::lock_guard<std::mutex> lock(stateMutex);
+        queued.fetch_add(1, std::memory_order_release);
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    workAvailable.notify_one();
+}
+
+void WorkStealingPool::wait() {
+    std::unique_lock<std::mutex> lock(stateMutex);
+    allDone.wait(lock, [this] { return pending.load(std::memory_order_acquire) == 0; });
+
+    if (firstError) {
+        std::exception_ptr error = firstError;
+        firstError = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+bool WorkStealingPool::popLocal(std::size_t index, Task& task) {
+    auto& queue = *queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) return false;
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(std::size_t thief, Task& task) {
+    for (std::size_t offset = 1; offset < queues.size(); ++offset) {
+        auto& queue = *queues[(thief + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::finishTask() {
+    if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        allDone.notify_all();
+    }
+}
+
+void WorkStealingPool::workerLoop(std::size_t index) {
+    currentPool = this;
+    currentWorker = index;
+
+    Task task;
+    while (true) {
+        if (popLocal(index, task) || steal(index, task)) {
+            queued.fetch_sub(1, std::memory_order_acq_rel);
+            try {
+                task();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                if (!firstError) firstError = std::current_exception();
+            }
+            task = nullptr;
+            finishTask();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(stateMutex);
+        workAvailable.wait(lock, [this] {
+            return stopping || queued.load(std::memory_order_acquire) > 0;
+        });
+        if (stopping && queued.load(std::memory_order_acquire) == 0) return;
+    }
+}
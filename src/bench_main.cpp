@@ -0,0 +1,574 @@
+#include "Clock.hpp"
+#include "Config.hpp"
+#include "DeviceGroup.hpp"
+#include "InputEvent.hpp"
+#include "LiveMetrics.hpp"
+#include "Metrics.hpp"
+#include "MetricsPublisher.hpp"
+#include "MinMaxEnvelope.hpp"
+#include "PipelineTrace.hpp"
+#include "PollingAnalyzer.hpp"
+#include "RollupHistory.hpp"
+#include "SampleExporter.hpp"
+#include "SessionComparison.hpp"
+#include "SessionStats.hpp"
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+// Every allocation in the process goes through these, so a benchmark can report
+// allocations per operation alongside its time. Plain, array and over-aligned
+// forms are all replaced (the standard nothrow forms forward to them), and all
+// allocate and free through the same pair so any new matches any delete.
+namespace {
+    std::atomic<std::uint64_t> allocationCount{0};
+
+    void* allocate(std::size_t size, std::size_t alignment) {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        if (size == 0) size = 1;
+#ifdef _WIN32
+        void* p = _aligned_malloc(size, alignment);
+#else
+        // aligned_alloc takes whole multiples of the alignment
+        void* p = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+        if (!p) throw std::bad_alloc();
+        return p;
+    }
+
+    void release(void* p) noexcept {
+#ifdef _WIN32
+        _aligned_free(p);
+#else
+        std::free(p);
+#endif
+    }
+
+    constexpr std::size_t DEFAULT_ALIGNMENT = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+}
+
+void* operator new(std::size_t size) { return allocate(size, DEFAULT_ALIGNMENT); }
+void* operator new[](std::size_t size) { return allocate(size, DEFAULT_ALIGNMENT); }
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* p) noexcept { release(p); }
+void operator delete[](void* p) noexcept { release(p); }
+void operator delete(void* p, std::size_t) noexcept { release(p); }
+void operator delete[](void* p, std::size_t) noexcept { release(p); }
+void operator delete(void* p, std::align_val_t) noexcept { release(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { release(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { release(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { release(p); }
+
+namespace {
+    constexpr std::int64_t MIN_RUN_NS = 200'000'000;
+    constexpr int REPETITIONS = 5;
+
+    // Keeps the optimiser from discarding a result
+    template<typename T>
+    void keep(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile T sink;
+        sink = value;
+#endif
+    }
+
+    struct Result {
+        std::string name;
+        std::uint64_t operations;
+        double nsPerOp;
+        double allocationsPerOp;
+        double budgetPercent{-1.0};     // Share of one core at the named event rate
+    };
+
+    // Runs body(batch) until MIN_RUN_NS has passed, REPETITIONS times, and keeps
+    // the fastest repetition. body performs `batch` operations per call.
+    template<typename Body>
+    Result measure(const std::string& name, std::uint64_t batch, Body&& body) {
+        body(batch); // Warm-up: first-touch allocations and cold caches
+
+        Result best{name, 0, 1e300, 0.0};
+        for (int rep = 0; rep < REPETITIONS; ++rep) {
+            std::uint64_t operations = 0;
+            const std::uint64_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+            const std::int64_t start = Clock::nowNs();
+            std::int64_t elapsed = 0;
+            while (elapsed < MIN_RUN_NS) {
+                body(batch);
+                operations += batch;
+                elapsed = Clock::nowNs() - start;
+            }
+            const std::uint64_t allocations = allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+
+            const double nsPerOp = static_cast<double>(elapsed) / static_cast<double>(operations);
+            if (nsPerOp < best.nsPerOp) {
+                best = {name, operations, nsPerOp, static_cast<double>(allocations) / static_cast<double>(operations)};
+            }
+        }
+        return best;
+    }
+
+    // Deterministic mouse reports at a nominal rate with +/-5% interval jitter
+    class SyntheticStream {
+    public:
+        explicit SyntheticStream(double rateHz) : periodNs(1e9 / rateHz) {}
+
+        InputEvent next() {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            const double jitter = (static_cast<double>(state >> 40) / static_cast<double>(1ULL << 24) - 0.5) * 0.1;
+            timeNs += periodNs * (1.0 + jitter);
+
+            InputEvent event{};
+            event.timestampNs = static_cast<std::int64_t>(timeNs);
+            event.dx = static_cast<std::int32_t>((state >> 20) % 7) - 3;
+            event.dy = static_cast<std::int32_t>((state >> 28) % 7) - 3;
+            event.x = static_cast<float>((state >> 8) % Config::WINDOW_WIDTH);
+            event.y = static_cast<float>((state >> 16) % Config::WINDOW_HEIGHT);
+            // Roughly one click per thousand reports
+            event.type = (state >> 50) % 1000 == 0 ? InputEventType::ButtonPress : InputEventType::Move;
+            return event;
+        }
+
+    private:
+        double periodNs;
+        double timeNs{0.0};
+        std::uint64_t state{0x9E3779B97F4A7C15ULL};
+    };
+
+    struct Vertex {
+        float x, y;
+        std::uint32_t color;
+    };
+
+    void benchMeasurements(std::vector<Result>& results) {
+        auto metrics = std::make_unique<MetricsCollector>();
+        double t = 0.0;
+
+        results.push_back(measure("add_latency_measurement", 1024, [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; ++i) {
+                t += 1e-3;
+                metrics->addLatencyMeasurement(t, 1.0 + static_cast<double>(i % 17) * 0.1);
+            }
+        }));
+        results.push_back(measure("add_polling_measurement", 1024, [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; ++i) {
+                t += 1e-3;
+                metrics->addPollingMeasurement(t, 0.125 + static_cast<double>(i % 5) * 0.001, 100.f, 200.f);
+            }
+        }));
+        results.push_back(measure("add_movement_measurement", 1024, [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; ++i) {
+                t += 1e-3;
+                metrics->addMovementMeasurement(t, 100.f, 200.f, static_cast<float>(i % 31),
+                                                static_cast<std::int32_t>(i % 7) + 3, 2);
+            }
+        }));
+
+        // update() as the overlay calls it: after a frame's worth of new samples
+        results.push_back(measure("metrics_update", 64, [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; ++i) {
+                t += 1e-3;
+                metrics->addLatencyMeasurement(t, 1.0 + static_cast<double>(i % 17) * 0.1);
+                metrics->addPollingMeasurement(t, 0.125, 100.f, 200.f);
+                metrics->update();
+            }
+        }));
+    }
+
+    void benchGraphs(std::vector<Result>& results) {
+        for (const size_t window : {1'000ul, 65'536ul, 1'048'576ul}) {
+            // Decimated envelope: vertex work is bounded by the column count
+            MinMaxEnvelope envelope(Config::DISPLAY_POINTS, window);
+            for (size_t i = 0; i < window; ++i) envelope.push(static_cast<float>(i % 997));
+
+            std::vector<Vertex> vertices(envelope.capacity() * 4);
+            results.push_back(measure("graph_envelope_vertices/window=" + std::to_string(window), 1,
+                                      [&](std::uint64_t) {
+                const float xStep = Config::GRAPH_WIDTH / static_cast<float>(envelope.capacity());
+                for (size_t i = 0; i < envelope.size(); ++i) {
+                    const auto& column = envelope[i];
+                    const float x = static_cast<float>(i) * xStep;
+                    vertices[i * 4 + 0] = {x, Config::GRAPH_HEIGHT, 0x80u};
+                    vertices[i * 4 + 1] = {x, column.min, 0x80u};
+                    vertices[i * 4 + 2] = {x, column.min, 0xFFu};
+                    vertices[i * 4 + 3] = {x, column.max, 0xFFu};
+                }
+                keep(vertices.data());
+            }));
+
+            // Two vertices per sample into a fresh vector each frame, as the
+            // immediate-mode graphs did
+            std::vector<float> samples(window);
+            for (size_t i = 0; i < window; ++i) samples[i] = static_cast<float>(i % 997);
+            results.push_back(measure("graph_per_sample_vertices/window=" + std::to_string(window), 1,
+                                      [&](std::uint64_t) {
+                std::vector<Vertex> perSample(samples.size() * 2);
+                const float xStep = Config::GRAPH_WIDTH / static_cast<float>(samples.size() - 1);
+                for (size_t i = 0; i < samples.size(); ++i) {
+                    const float x = static_cast<float>(i) * xStep;
+                    perSample[i * 2] = {x, samples[i], 0xFFu};
+                    perSample[i * 2 + 1] = {x, Config::GRAPH_HEIGHT, 0xFFu};
+                }
+                keep(perSample.data());
+            }));
+        }
+    }
+
+    // An hour of 8 kHz intervals, then zooms from the whole session down to raw reports
+    void benchRollups(std::vector<Result>& results) {
+        auto history = std::make_unique<RollupHistory>();
+        std::int64_t timeNs = 0;
+        results.push_back(measure("rollup_add", 1024, [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; ++i) {
+                timeNs += 125'000;
+                history->add(timeNs, 125.f + static_cast<float>(i % 13));
+            }
+        }));
+
+        history->clear();
+        SyntheticStream stream(8000.0);
+        std::int64_t last = stream.next().timestampNs;
+        const std::int64_t hourNs = last + 3'600'000'000'000;
+        while (last < hourNs) {
+            const std::int64_t now = stream.next().timestampNs;
+            history->add(now, static_cast<float>(now - last) * 1e-3f);
+            last = now;
+        }
+
+        std::vector<MinMaxEnvelope::Column> columns(Config::DISPLAY_POINTS);
+        for (const std::int64_t spanNs : {3'600'000'000'000ll, 60'000'000'000ll, 1'000'000'000ll, 10'000'000ll}) {
+            results.push_back(measure("rollup_render/span_ms=" + std::to_string(spanNs / 1'000'000), 1,
+                                      [&](std::uint64_t) {
+                keep(history->render(last - spanNs, last, columns));
+                keep(columns.data());
+            }));
+        }
+        results.push_back(measure("rollup_find_worst", 64, [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; ++i) keep(history->findWorst().startNs);
+        }));
+    }
+
+    // A full window re-analysed, as each text refresh does, with both kernel sets
+    void benchPollingAnalysis(std::vector<Result>& results) {
+        auto analyzer = std::make_unique<PollingAnalyzer>();
+        SyntheticStream stream(8000.0);
+        std::int64_t last = stream.next().timestampNs;
+        for (size_t i = 0; i < Config::POLLING_ANALYSIS_WINDOW; ++i) {
+            const std::int64_t now = stream.next().timestampNs;
+            analyzer->add(static_cast<double>(now - last) * 1e-3);
+            last = now;
+        }
+
+        for (const bool vector : {true, false}) {
+            if (PollingAnalyzer::useVectorKernels(vector) != vector) continue;
+            results.push_back(measure(std::string("polling_analyze/") + PollingAnalyzer::kernelName() + "/window=" +
+                                      std::to_string(Config::POLLING_ANALYSIS_WINDOW), 1, [&](std::uint64_t) {
+                keep(analyzer->analyze().periodUs);
+            }));
+        }
+        PollingAnalyzer::useVectorKernels(true);
+    }
+
+    void benchDistance(std::vector<Result>& results) {
+        std::vector<float> xs(1024), ys(1024);
+        for (size_t i = 0; i < xs.size(); ++i) {
+            xs[i] = static_cast<float>(i % 61) - 30.f;
+            ys[i] = static_cast<float>(i % 43) - 21.f;
+        }
+
+        results.push_back(measure("distance_pow", xs.size(), [&](std::uint64_t n) {
+            float sum = 0.f;
+            for (std::uint64_t i = 0; i < n; ++i) {
+                sum += static_cast<float>(std::sqrt(std::pow(xs[i], 2) + std::pow(ys[i], 2)));
+            }
+            keep(sum);
+        }));
+        results.push_back(measure("distance_hypot", xs.size(), [&](std::uint64_t n) {
+            float sum = 0.f;
+            for (std::uint64_t i = 0; i < n; ++i) sum += std::hypot(xs[i], ys[i]);
+            keep(sum);
+        }));
+        results.push_back(measure("distance_sqrt", xs.size(), [&](std::uint64_t n) {
+            float sum = 0.f;
+            for (std::uint64_t i = 0; i < n; ++i) sum += std::sqrt(xs[i] * xs[i] + ys[i] * ys[i]);
+            keep(sum);
+        }));
+    }
+
+    // Capture ring to collector, drained once per 240 Hz frame as the frontend does
+    void benchIngestion(std::vector<Result>& results) {
+        for (const double rate : {1000.0, 4000.0, 8000.0, 16000.0}) {
+            auto ring = std::make_unique<InputRing>();
+            auto metrics = std::make_unique<MetricsCollector>();
+            SyntheticStream stream(rate);
+            const std::uint64_t perFrame = static_cast<std::uint64_t>(rate / Config::TARGET_FRAME_RATE) + 1;
+
+            Result result = measure("ingest_end_to_end/" + std::to_string(static_cast<int>(rate / 1000)) + "kHz",
+                                    perFrame, [&](std::uint64_t n) {
+                for (std::uint64_t i = 0; i < n; ++i) ring->tryPush(stream.next());
+                metrics->drain(*ring);
+            });
+            result.budgetPercent = result.nsPerOp * rate / 1e7;
+            results.push_back(result);
+        }
+
+        // Several 8 kHz mice, each into its own ring and collector; per-event cost
+        // should stay flat as devices are added
+        constexpr double DEVICE_RATE = 8000.0;
+        for (const size_t count : {1ul, 2ul, 4ul, 8ul}) {
+            DeviceGroup devices;
+            std::vector<SyntheticStream> streams;
+            for (size_t d = 0; d < count; ++d) {
+                devices.add("bench." + std::to_string(d), nullptr);
+                streams.emplace_back(DEVICE_RATE);
+            }
+            const std::uint64_t perFrame = static_cast<std::uint64_t>(DEVICE_RATE / Config::TARGET_FRAME_RATE) + 1;
+
+            Result result = measure("ingest_devices/" + std::to_string(count), perFrame * count,
+                                    [&](std::uint64_t) {
+                for (size_t d = 0; d < count; ++d) {
+                    for (std::uint64_t i = 0; i < perFrame; ++i) devices[d].capture.getRing().tryPush(streams[d].next());
+                }
+                devices.drain();
+            });
+            result.budgetPercent = result.nsPerOp * DEVICE_RATE * static_cast<double>(count) / 1e7;
+            results.push_back(result);
+        }
+    }
+
+    // Per-event cost of each test's pipeline against the full collector at 8 kHz
+    template<typename Pipeline>
+    void benchPipeline(std::vector<Result>& results, const std::string& name) {
+        constexpr double RATE = 8000.0;
+        auto ring = std::make_unique<InputRing>();
+        auto metrics = std::make_unique<Pipeline>();
+        SyntheticStream stream(RATE);
+        const std::uint64_t perFrame = static_cast<std::uint64_t>(RATE / Config::TARGET_FRAME_RATE) + 1;
+
+        Result result = measure("ingest_pipeline/" + name, perFrame, [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; ++i) ring->tryPush(stream.next());
+            metrics->drain(*ring);
+        });
+        result.budgetPercent = result.nsPerOp * RATE / 1e7;
+        results.push_back(result);
+    }
+
+    void benchPipelines(std::vector<Result>& results) {
+        benchPipeline<MetricsCollector>(results, "all");
+        benchPipeline<LatencyTestPipeline>(results, "latency_test");
+        benchPipeline<PollingTestPipeline>(results, "polling_test");
+        benchPipeline<MovementTestPipeline>(results, "movement_test");
+        benchPipeline<MetricPipeline<PollingStage>>(results, "polling_window");
+    }
+
+    // A/B comparison of two multi-million-report sessions, bootstrap included
+    void benchComparison(std::vector<Result>& results) {
+        constexpr size_t REPORTS = 4'000'000;
+        SessionStats a;
+        SessionStats b;
+        SyntheticStream streamA(8000.0);
+        SyntheticStream streamB(7900.0);
+        double previousA = 0.0;
+        double previousB = 0.0;
+        for (size_t i = 0; i < REPORTS; ++i) {
+            const double timeA = static_cast<double>(streamA.next().timestampNs) * 1e-9;
+            const double timeB = static_cast<double>(streamB.next().timestampNs) * 1e-9;
+            a.addPollingMeasurement(timeA, (timeA - previousA) * 1000.0, 0.f, 0.f);
+            b.addPollingMeasurement(timeB, (timeB - previousB) * 1000.0, 0.f, 0.f);
+            previousA = timeA;
+            previousB = timeB;
+        }
+
+        const SessionComparator comparator;
+        results.push_back(measure("compare_sessions/reports=4M", 1, [&](std::uint64_t) {
+            keep(comparator.compare(comparedSession("a", a), comparedSession("b", b)).metrics.size());
+        }));
+    }
+
+    // The tracepoints' own cost: one span recorded and collected, and the
+    // traced drain to set against ingest_devices
+    void benchTrace(std::vector<Result>& results) {
+        PipelineTrace trace;
+        TraceBuffer& buffer = trace.threadBuffer("bench");
+        const TraceSpan span{0, 1'000, 5'000, 32, TraceStage::Metrics, 0};
+        results.push_back(measure("trace_record_collect", 1024, [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; ++i) buffer.record(span);
+            trace.collect();
+        }));
+
+        constexpr size_t DEVICES = 8;
+        DeviceGroup devices;
+        std::vector<SyntheticStream> streams;
+        for (size_t d = 0; d < DEVICES; ++d) {
+            devices.add("bench." + std::to_string(d), nullptr);
+            streams.emplace_back(8000.0);
+        }
+        devices.setTrace(&trace);
+        const std::uint64_t perFrame = static_cast<std::uint64_t>(8000.0 / Config::TARGET_FRAME_RATE) + 1;
+
+        Result result = measure("ingest_devices_traced/" + std::to_string(DEVICES), perFrame * DEVICES,
+                                [&](std::uint64_t) {
+            for (size_t d = 0; d < DEVICES; ++d) {
+                for (std::uint64_t i = 0; i < perFrame; ++i) devices[d].capture.getRing().tryPush(streams[d].next());
+            }
+            devices.drain();
+            devices.takeTraceBacklog();
+            trace.collect();
+        });
+        result.budgetPercent = result.nsPerOp * 8000.0 * static_cast<double>(DEVICES) / 1e7;
+        results.push_back(result);
+    }
+
+    // One publish of every device behind the seqlock, and one reader poll
+    void benchLiveMetrics(std::vector<Result>& results) {
+        for (const size_t deviceCount : {1ul, 8ul}) {
+            DeviceGroup devices;
+            SyntheticStream stream(8000.0);
+            for (size_t d = 0; d < deviceCount; ++d) {
+                MetricsCollector& metrics = devices.add("bench." + std::to_string(d), nullptr).metrics;
+                for (size_t i = 0; i < 65'536; ++i) metrics.ingest(stream.next());
+                metrics.update();
+            }
+
+            MetricsPublisher publisher("mousebench_bench");
+            results.push_back(measure("live_publish/devices=" + std::to_string(deviceCount), 1,
+                                      [&](std::uint64_t) { publisher.publish(devices); }));
+
+            MetricsReader reader("mousebench_bench");
+            LiveMetricsFormat::Snapshot snapshot;
+            results.push_back(measure("live_read/devices=" + std::to_string(deviceCount), 1,
+                                      [&](std::uint64_t) { keep(reader.read(snapshot)); }));
+        }
+    }
+
+    // Writer throughput per format, and what the hand-off costs the consumer thread.
+    // Budgets are against eight 8 kHz mice.
+    void benchExport(std::vector<Result>& results) {
+#ifdef _WIN32
+        const std::string nullPath = "NUL";
+#else
+        const std::string nullPath = "/dev/null";
+#endif
+        constexpr double EXPORT_RATE = 8 * 8000.0;
+        SyntheticStream stream(8000.0);
+        std::vector<InputEvent> events(Config::INPUT_DRAIN_BATCH);
+        for (auto& event : events) event = stream.next();
+
+        const std::pair<const char*, ExportFormat> formats[] = {
+            {"csv", ExportFormat::Csv}, {"jsonl", ExportFormat::JsonLines}, {"columnar", ExportFormat::Columnar}};
+        for (const auto& [name, format] : formats) {
+            // Waiting for free blocks makes the writer the bottleneck being timed
+            SampleExporter exporter(nullPath, format, true);
+            Result result = measure(std::string("export_writer/") + name, events.size(), [&](std::uint64_t) {
+                exporter.append(0, events);
+            });
+            result.budgetPercent = result.nsPerOp * EXPORT_RATE / 1e7;
+            results.push_back(result);
+        }
+
+
+        // The consumer side: eight 8 kHz mice drained per frame while exporting. With a
+        // single core the writer's time lands here too, so the cheapest format is used
+        constexpr size_t DEVICES = 8;
+        SampleExporter exporter(nullPath, ExportFormat::Columnar);
+        DeviceGroup devices;
+        std::vector<SyntheticStream> streams;
+        for (size_t d = 0; d < DEVICES; ++d) {
+            devices.add("bench." + std::to_string(d), nullptr);
+            streams.emplace_back(8000.0);
+        }
+        devices.setExporter(&exporter);
+        const std::uint64_t perFrame = static_cast<std::uint64_t>(8000.0 / Config::TARGET_FRAME_RATE) + 1;
+
+        Result result = measure("ingest_devices_export/" + std::to_string(DEVICES), perFrame * DEVICES,
+                                [&](std::uint64_t) {
+            for (size_t d = 0; d < DEVICES; ++d) {
+                for (std::uint64_t i = 0; i < perFrame; ++i) devices[d].capture.getRing().tryPush(streams[d].next());
+            }
+            devices.drain();
+        });
+        result.budgetPercent = result.nsPerOp * EXPORT_RATE / 1e7;
+        results.push_back(result);
+        exporter.close();
+        if (exporter.getStats().eventsDropped > 0) {
+            std::cerr << "Note: the export writer fell behind the benchmark loop ("
+                      << exporter.getStats().eventsDropped << " events dropped)\n";
+        }
+    }
+
+    void writeJson(std::ostream& out, const std::vector<Result>& results) {
+        out << "{\n  \"clock\": \"" << Clock::backendName() << "\",\n  \"benchmarks\": [";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            out << (i ? ",\n    " : "\n    ")
+                << "{\"name\": \"" << r.name << "\", \"operations\": " << r.operations
+                << ", \"ns_per_op\": " << r.nsPerOp << ", \"allocations_per_op\": " << r.allocationsPerOp;
+            if (r.budgetPercent >= 0.0) out << ", \"core_percent\": " << r.budgetPercent;
+            out << '}';
+        }
+        out << "\n  ]\n}\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    // mousebench_bench [--output FILE]
+    std::string outputPath;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--output" && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--output FILE]\n\n"
+                      << "Measures the cost of the measurement pipeline and writes JSON results.\n";
+            return 1;
+        }
+    }
+
+    std::vector<Result> results;
+    benchMeasurements(results);
+    benchGraphs(results);
+    benchRollups(results);
+    benchPollingAnalysis(results);
+    benchComparison(results);
+    benchDistance(results);
+    benchIngestion(results);
+    benchPipelines(results);
+    benchTrace(results);
+    benchExport(results);
+    benchLiveMetrics(results);
+
+    for (const auto& r : results) {
+        std::cerr << r.name << ": " << r.nsPerOp << " ns/op, " << r.allocationsPerOp << " allocs/op\n";
+    }
+
+    if (outputPath.empty()) {
+        writeJson(std::cout, results);
+    } else {
+        std::ofstream out(outputPath);
+        if (!out) {
+            std::cerr << "Error: cannot write " << outputPath << std::endl;
+            return 1;
+        }
+        writeJson(out, results);
+    }
+    return 0;
+}
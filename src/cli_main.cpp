@@ -0,0 +1,626 @@
+#include "CaptureFile.hpp"
+#include "Clock.hpp"
+#include "DeviceGroup.hpp"
+#include "InputCapture.hpp"
+#include "Metrics.hpp"
+#include "MetricsEndpoint.hpp"
+#include "MetricsPublisher.hpp"
+#include "OfflineAnalyzer.hpp"
+#include "PipelineTrace.hpp"
+#include "Report.hpp"
+#include "ReplayInputSource.hpp"
+#include "SampleExporter.hpp"
+#include "SampleDeriver.hpp"
+#include "SessionStats.hpp"
+#include "SyntheticInputSource.hpp"
+#ifdef __linux__
+#include "EvdevInputSource.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    constexpr auto DRAIN_INTERVAL = std::chrono::milliseconds(20);
+
+    volatile std::sig_atomic_t stopRequested = 0;
+
+    void handleSignal(int) {
+        stopRequested = 1;
+    }
+
+    struct Options {
+        std::vector<std::string> devices;
+        std::string input;
+        std::string record;
+        std::string exportPath;
+        ExportFormat exportFormat{ExportFormat::Csv};
+        std::string publish;
+        int metricsPort{0};
+        std::string trace;
+        std::string replay;
+        std::vector<std::string> synthetic;
+        double duration{0.0};
+        bool analyze{false};
+        std::vector<std::string> analyzePaths;
+        bool compare{false};
+        std::vector<std::string> comparePaths;
+        size_t resamples{Config::COMPARE_RESAMPLES};
+        size_t threads{0};
+        ReportFormat format{ReportFormat::Text};
+        bool distribution{false};
+    };
+
+    void printUsage(const char* program) {
+        std::cerr << "Usage: " << program << " [options]\n\n"
+                  << "Collects mouse statistics without a display and prints a report.\n\n"
+                  << "  --device PATH     Capture live from an evdev node (default: first mouse found);\n"
+                  << "                    repeat for several mice, or 'all' for every mouse, each on its\n"
+                  << "                    own capture thread and reported separately\n"
+                  << "  --input FILE      Analyse a capture file, or raw struct input_event data ('-' for stdin)\n"
+                  << "  --record FILE     Save every event to a capture file (live or converted from evdev);\n"
+                  << "                    with several devices, one file per device (FILE.0, FILE.1, ...)\n"
+                  << "  --export FILE     Stream every event to FILE from a background writer, and the\n"
+                  << "                    JSON report to FILE.summary.json at the end\n"
+                  << "  --export-format F csv, jsonl or columnar (default: csv)\n"
+                  << "  --publish NAME    Publish live statistics to shared memory for mousebench_monitor\n"
+                  << "                    and other readers (live, replay and synthetic capture)\n"
+                  << "  --metrics-port P  Also serve them as Prometheus text on http://127.0.0.1:P/metrics\n"
+                  << "                    (publishes as '" << LiveMetricsFormat::DEFAULT_NAME << "' without --publish)\n"
+                  << "  --trace FILE      Time the tool's own pipeline (capture read, dequeue, collector) and\n"
+                  << "                    write the spans as a Chrome trace-event file (live, replay and\n"
+                  << "                    synthetic capture)\n"
+                  << "  --replay SPEED    Replay the --input capture through the live pipeline at\n"
+                  << "                    'realtime', a factor such as '4', or 'max' (reports throughput)\n"
+                  << "  --synthetic SPEC  Capture from a generated mouse and compare against its ground truth,\n"
+                  << "                    e.g. 'rate=8000,jitter=gauss:0.05,drop=0.001,motion=circle:200:500,\n"
+                  << "                    clicks=periodic:250,bounce=0.1,duration=10,pace=realtime|max'; repeat for\n"
+                  << "                    several concurrent devices\n"
+                  << "  --duration SECS   Stop live capture after SECS seconds (default: until Ctrl+C)\n"
+                  << "  --format FORMAT   text or json (default: text)\n"
+                  << "  --distribution    Include full histogram tables in the text report\n\n"
+                  << "  --analyze PATH... Summarise capture files (directories are searched recursively)\n"
+                  << "                    in parallel, per file and in aggregate\n"
+                  << "  --compare [A B]   Compare two capture files, or without files the two devices of a\n"
+                  << "                    live or synthetic capture: percentile and spread deltas of B - A\n"
+                  << "                    with bootstrap confidence intervals, a Kolmogorov-Smirnov test\n"
+                  << "                    and effect sizes\n"
+                  << "  --resamples N     Bootstrap resamples for --compare (default: " << Config::COMPARE_RESAMPLES << ")\n"
+                  << "  --threads N       Worker threads for --analyze and --compare (default: one per core)\n";
+    }
+
+    bool parseOptions(int argc, char* argv[], Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            const bool hasValue = i + 1 < argc;
+
+            if (arg == "--device" && hasValue) {
+                options.devices.push_back(argv[++i]);
+            } else if (arg == "--input" && hasValue) {
+                options.input = argv[++i];
+            } else if (arg == "--record" && hasValue) {
+                options.record = argv[++i];
+            } else if (arg == "--export" && hasValue) {
+                options.exportPath = argv[++i];
+            } else if (arg == "--export-format" && hasValue) {
+                if (!parseExportFormat(argv[++i], options.exportFormat)) return false;
+            } else if (arg == "--publish" && hasValue) {
+                options.publish = argv[++i];
+            } else if (arg == "--metrics-port" && hasValue) {
+                options.metricsPort = std::stoi(argv[++i]);
+                if (options.metricsPort <= 0 || options.metricsPort > 65535) return false;
+                if (options.publish.empty()) options.publish = LiveMetricsFormat::DEFAULT_NAME;
+            } else if (arg == "--trace" && hasValue) {
+                options.trace = argv[++i];
+            } else if (arg == "--replay" && hasValue) {
+                options.replay = argv[++i];
+            } else if (arg == "--synthetic" && hasValue) {
+                options.synthetic.push_back(argv[++i]);
+            } else if (arg == "--duration" && hasValue) {
+                options.duration = std::stod(argv[++i]);
+            } else if (arg == "--format" && hasValue) {
+                const std::string format = argv[++i];
+                if (format == "text") options.format = ReportFormat::Text;
+                else if (format == "json") options.format = ReportFormat::Json;
+                else return false;
+            } else if (arg == "--distribution") {
+                options.distribution = true;
+            } else if (arg == "--analyze") {
+                options.analyze = true;
+            } else if (arg == "--compare") {
+                options.compare = true;
+            } else if (arg == "--resamples" && hasValue) {
+                options.resamples = std::stoul(argv[++i]);
+                if (options.resamples == 0) return false;
+            } else if (arg == "--threads" && hasValue) {
+                options.threads = std::stoul(argv[++i]);
+            } else if (options.analyze && arg.rfind("--", 0) != 0) {
+                options.analyzePaths.push_back(arg);
+            } else if (options.compare && arg.rfind("--", 0) != 0) {
+                options.comparePaths.push_back(arg);
+            } else {
+                return false;
+            }
+        }
+        if (options.compare) {
+            if (options.analyze) return false;
+            if (!options.comparePaths.empty()) {
+                return options.comparePaths.size() == 2 && options.input.empty() && options.devices.empty() &&
+                       options.synthetic.empty() && options.exportPath.empty() && options.publish.empty() &&
+                       options.trace.empty();
+            }
+            // Otherwise two live or generated devices, checked once they are added
+            if (!options.input.empty()) return false;
+        }
+        if (options.analyze) {
+            return !options.analyzePaths.empty() && options.input.empty() && options.devices.empty() &&
+                   options.exportPath.empty() && options.publish.empty() && options.trace.empty();
+        }
+        if (!options.synthetic.empty()) return options.input.empty() && options.devices.empty();
+        if (!options.replay.empty() && options.input.empty()) return false;
+        // Offline input never passes through the capture pipeline
+        if (!options.trace.empty() && !options.input.empty() && options.replay.empty()) return false;
+        return options.input.empty() || options.devices.empty();
+    }
+
+    size_t workerThreads(const Options& options) {
+        return options.threads > 0 ? options.threads : std::thread::hardware_concurrency();
+    }
+
+    // B is the second device or file, A the baseline
+    void writeComparison(const ComparedSession& a, const ComparedSession& b, const Options& options) {
+        const auto start = std::chrono::steady_clock::now();
+        const ComparisonResult result = SessionComparator(workerThreads(options), options.resamples).compare(a, b);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        writeComparisonReport(std::cout, result, options.format);
+        std::cerr << "Compared " << a.interval.getTotalCount() + b.interval.getTotalCount() << " intervals with "
+                  << result.resamples << " resamples per metric in " << seconds << " s\n";
+    }
+
+    void compareCaptures(const Options& options) {
+        const OfflineAnalyzer analyzer(workerThreads(options));
+        const SessionStats a = analyzer.analyzeFile(options.comparePaths[0]);
+        const SessionStats b = analyzer.analyzeFile(options.comparePaths[1]);
+        writeComparison(comparedSession(options.comparePaths[0], a), comparedSession(options.comparePaths[1], b),
+                        options);
+    }
+
+    // Recorded input is consumed synchronously so nothing can be dropped
+    bool analyseRecording(InputSource& source, CaptureWriter* writer, SampleExporter* exporter,
+                          MetricsCollector& metrics) {
+        if (!source.open()) return false;
+
+        InputEvent batch[Config::INPUT_DRAIN_BATCH];
+        while (!source.exhausted() && !stopRequested) {
+            const size_t count = source.read(batch, Config::INPUT_DRAIN_BATCH, 100);
+            for (size_t i = 0; i < count; ++i) {
+                metrics.ingest(batch[i]);
+                if (writer) writer->append(batch[i]);
+            }
+            if (exporter) exporter->append(0, std::span<const InputEvent>(batch, count));
+        }
+        metrics.flush(SampleDeriver::END_OF_STREAM);
+        source.close();
+        return true;
+    }
+
+    void analyseCapture(const std::string& path, SampleExporter* exporter, MetricsCollector& metrics) {
+        CaptureReader reader(path);
+        InputEvent batch[Config::INPUT_DRAIN_BATCH];
+        size_t count = 0;
+        for (const auto& record : reader.getRecords()) {
+            if (stopRequested) break;
+            batch[count++] = CaptureFormat::toEvent(record);
+            if (count == Config::INPUT_DRAIN_BATCH) {
+                metrics.ingest(std::span<const InputEvent>(batch, count));
+                if (exporter) exporter->append(0, std::span<const InputEvent>(batch, count));
+                count = 0;
+            }
+        }
+        metrics.ingest(std::span<const InputEvent>(batch, count));
+        if (exporter) exporter->append(0, std::span<const InputEvent>(batch, count));
+        metrics.flush(SampleDeriver::END_OF_STREAM);
+    }
+
+    // Offline and flat-out inputs wait for the writer; live capture drops rather than stall
+    std::unique_ptr<SampleExporter> createExporter(const Options& options, bool waitWhenFull) {
+        if (options.exportPath.empty()) return nullptr;
+        return std::make_unique<SampleExporter>(options.exportPath, options.exportFormat, waitWhenFull);
+    }
+
+    void finishExport(SampleExporter* exporter, DeviceGroup& devices, const Options& options) {
+        if (!exporter) return;
+        devices.setExporter(nullptr);
+        exporter->close();
+
+        const ExportStats stats = exporter->getStats();
+        std::cerr << "Exported " << stats.eventsWritten << " events (" << stats.bytesWritten << " bytes, "
+                  << stats.blocksWritten << " blocks, queue high water " << stats.queueHighWater << " of "
+                  << Config::EXPORT_BLOCKS << ") to " << options.exportPath << '\n';
+        if (stats.eventsDropped > 0) {
+            std::cerr << "Warning: " << stats.eventsDropped << " events not exported; the writer fell behind\n";
+        }
+        if (stats.failed) std::cerr << "Warning: writing " << options.exportPath << " failed\n";
+
+        std::ofstream summary(options.exportPath + ".summary.json");
+        writeDeviceReport(summary, devices, ReportFormat::Json);
+    }
+
+    // Live statistics for external readers, refreshed after every drain
+    struct LivePublication {
+        std::unique_ptr<MetricsPublisher> publisher;
+        std::unique_ptr<MetricsEndpoint> endpoint;
+
+        void publish(DeviceGroup& devices) {
+            if (!publisher) return;
+            devices.update();
+            publisher->publish(devices);
+        }
+    };
+
+    LivePublication createPublication(const Options& options) {
+        LivePublication publication;
+        if (options.publish.empty()) return publication;
+        publication.publisher = std::make_unique<MetricsPublisher>(options.publish);
+        if (options.metricsPort > 0) {
+            publication.endpoint = std::make_unique<MetricsEndpoint>(options.publish,
+                                                                     static_cast<std::uint16_t>(options.metricsPort));
+            std::cerr << "Serving http://127.0.0.1:" << options.metricsPort << "/metrics\n";
+        }
+        return publication;
+    }
+
+    // Self-instrumentation of the capture path, kept for the trace file
+    std::unique_ptr<PipelineTrace> createTrace(const Options& options) {
+        if (options.trace.empty()) return nullptr;
+        auto trace = std::make_unique<PipelineTrace>();
+        trace->retainSpans(Config::TRACE_RETAINED_SPANS);
+        return trace;
+    }
+
+    void finishTrace(PipelineTrace* trace, DeviceGroup& devices, const Options& options) {
+        if (!trace) return;
+        devices.setTrace(nullptr);
+        trace->collect();
+        trace->writeSummary(std::cerr);
+
+        std::ofstream file(options.trace);
+        trace->writeChromeTrace(file);
+        if (!file) std::cerr << "Warning: writing " << options.trace << " failed\n";
+    }
+
+    // Each device records to its own file, so capture threads never share a writer
+    std::string recordPath(const std::string& path, size_t index, size_t deviceCount) {
+        return deviceCount == 1 ? path : path + '.' + std::to_string(index);
+    }
+
+    void setRecorders(DeviceGroup& devices, const Options& options) {
+        if (options.record.empty()) return;
+        for (size_t i = 0; i < devices.size(); ++i) {
+            devices[i].capture.setRecorder(
+                std::make_unique<CaptureWriter>(recordPath(options.record, i, devices.size())));
+        }
+    }
+
+    void warnAboutCapture(const DeviceGroup& devices, const Options& options) {
+        for (size_t i = 0; i < devices.size(); ++i) {
+            const InputCapture& capture = devices[i].capture;
+            if (capture.getDroppedEvents() > 0) {
+                std::cerr << "Warning: " << capture.getDroppedEvents() << " events dropped by the capture ring ("
+                          << devices[i].name << ")\n";
+            }
+            if (capture.recordingFailed()) {
+                std::cerr << "Warning: recording to " << recordPath(options.record, i, devices.size())
+                          << " stopped early\n";
+            }
+        }
+    }
+
+    void captureLive(DeviceGroup& devices, const Options& options) {
+        setRecorders(devices, options);
+        LivePublication publication = createPublication(options);
+        const auto trace = createTrace(options);
+        devices.setTrace(trace.get());
+        devices.start();
+
+        const double duration = options.duration;
+        // Lossless sources wait for the consumer, so sleeping between drains would
+        // throttle them to a ring per interval: drain continuously, yielding when idle
+        const bool continuous = devices.allLossless();
+
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(duration);
+        auto nextPublish = std::chrono::steady_clock::now() + DRAIN_INTERVAL;
+        while (devices.anyRunning() && !stopRequested &&
+               (duration <= 0.0 || std::chrono::steady_clock::now() < deadline)) {
+            if (!continuous) std::this_thread::sleep_for(DRAIN_INTERVAL);
+            if (devices.drain() == 0 && continuous) std::this_thread::yield();
+
+            const auto now = std::chrono::steady_clock::now();
+            if (continuous && now < nextPublish) continue;
+            nextPublish = now + DRAIN_INTERVAL;
+            publication.publish(devices);
+            if (trace) trace->collect();
+        }
+
+        devices.stop();
+        devices.drain();
+        devices.flush();
+        publication.publish(devices);
+        finishTrace(trace.get(), devices, options);
+        warnAboutCapture(devices, options);
+    }
+
+    // Runs generated mice through the live capture path, collecting whole-session
+    // statistics next to each collector so they can be set against the ground truth
+    void captureSynthetic(const std::vector<SyntheticConfig>& configs, const Options& options) {
+        DeviceGroup devices;
+        std::vector<const SyntheticInputSource*> generators;
+        for (size_t i = 0; i < configs.size(); ++i) {
+            auto source = std::make_unique<SyntheticInputSource>(configs[i]);
+            generators.push_back(source.get());
+            devices.add(configs.size() == 1 ? "synthetic" : "synthetic." + std::to_string(i), std::move(source));
+        }
+        setRecorders(devices, options);
+        const bool paced = std::any_of(configs.begin(), configs.end(), [](const SyntheticConfig& config) {
+            return config.realTime;
+        });
+        const auto exporter = createExporter(options, !paced);
+        LivePublication publication = createPublication(options);
+        const auto trace = createTrace(options);
+        devices.setTrace(trace.get());
+
+        std::vector<SessionStats> sessions(devices.size());
+        std::vector<SampleDeriver> derivers(devices.size());
+        InputEvent batch[Config::INPUT_DRAIN_BATCH];
+        auto drain = [&] {
+            size_t drained = 0;
+            for (size_t d = 0; d < devices.size(); ++d) {
+                CaptureDevice& device = devices[d];
+                MetricsCollector& metrics = device.metrics;
+                size_t count;
+                while ((count = device.capture.getRing().popBatch(batch, Config::INPUT_DRAIN_BATCH)) > 0) {
+                    const std::int64_t handledNs = Clock::nowNs();
+                    for (size_t i = 0; i < count; ++i) {
+                        metrics.ingest(batch[i], handledNs);
+                        sessions[d].countEvent(batch[i].timestampNs);
+                        derivers[d].process(batch[i], sessions[d], handledNs);
+                    }
+                    devices.traceIngested(d, std::span<const InputEvent>(batch, count), handledNs);
+                    if (exporter) exporter->append(d, std::span<const InputEvent>(batch, count));
+                    drained += count;
+                }
+            }
+            return drained;
+        };
+        auto publish = [&] {
+            publication.publish(devices);
+            if (trace) trace->collect();
+        };
+
+        // Unpaced generators are lossless and drained continuously, as in captureLive
+        devices.start();
+        auto nextPublish = std::chrono::steady_clock::now() + DRAIN_INTERVAL;
+        while (devices.anyRunning() && !stopRequested) {
+            if (paced) std::this_thread::sleep_for(DRAIN_INTERVAL);
+            if (drain() == 0 && !paced) std::this_thread::yield();
+
+            const auto now = std::chrono::steady_clock::now();
+            if (!paced && now < nextPublish) continue;
+            nextPublish = now + DRAIN_INTERVAL;
+            publish();
+        }
+        devices.stop();
+        drain();
+        devices.flush();
+        for (size_t d = 0; d < devices.size(); ++d) derivers[d].flush(SampleDeriver::END_OF_STREAM, sessions[d]);
+        publish();
+        devices.update();
+        finishExport(exporter.get(), devices, options);
+        finishTrace(trace.get(), devices, options);
+
+        if (options.compare) {
+            writeComparison(comparedSession(devices[0].name, devices[0].metrics),
+                            comparedSession(devices[1].name, devices[1].metrics), options);
+            return;
+        }
+
+        const bool json = options.format == ReportFormat::Json;
+        if (json && devices.size() > 1) std::cout << "{\"devices\": [\n";
+        for (size_t d = 0; d < devices.size(); ++d) {
+            const CaptureDevice& device = devices[d];
+            const std::uint64_t ringDrops = device.capture.getDroppedEvents();
+            if (json) {
+                if (devices.size() > 1) std::cout << (d ? ",\n" : "") << "{\"name\": \"" << device.name << "\", ";
+                else std::cout << '{';
+                std::cout << "\"metrics\": ";
+                writeReport(std::cout, device.metrics, options.format);
+                std::cout << ",\n\"ground_truth\": ";
+                writeGroundTruthReport(std::cout, generators[d]->getGroundTruth(), sessions[d], ringDrops,
+                                       options.format);
+                std::cout << '}';
+            } else {
+                if (devices.size() > 1) std::cout << (d ? "\n" : "") << "=== " << device.name << " ===\n";
+                writeReport(std::cout, device.metrics, options.format, options.distribution);
+                std::cout << '\n';
+                writeGroundTruthReport(std::cout, generators[d]->getGroundTruth(), sessions[d], ringDrops,
+                                       options.format);
+            }
+        }
+        if (json) std::cout << (devices.size() > 1 ? "\n]}\n" : "\n");
+    }
+
+    void replayCapture(const Options& options, ReplayPacing pacing, double speed, DeviceGroup& devices) {
+        auto source = std::make_unique<ReplayInputSource>(options.input, pacing, speed);
+        const size_t recordCount = source->getRecordCount();
+        devices.add(options.input, std::move(source));
+
+        const auto start = std::chrono::steady_clock::now();
+        captureLive(devices, options);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cerr << "Replayed " << recordCount << " events in " << seconds << " s ("
+                  << (seconds > 0.0 ? recordCount / seconds / 1e6 : 0.0) << " M events/s)\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        if (!parseOptions(argc, argv, options)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+    } catch (const std::exception&) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
+
+    if (options.analyze) {
+        try {
+            const auto files = OfflineAnalyzer::collectCaptureFiles(options.analyzePaths);
+            const size_t threads = workerThreads(options);
+
+            const auto start = std::chrono::steady_clock::now();
+            const AnalysisResult result = OfflineAnalyzer(threads).analyze(files);
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            writeAnalysisReport(std::cout, result, options.format);
+            std::cerr << "Analysed " << files.size() << " files (" << result.aggregate.eventCount << " events) in "
+                      << seconds << " s\n";
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (options.compare && !options.comparePaths.empty()) {
+        try {
+            compareCaptures(options);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    DeviceGroup devices;
+    try {
+        if (!options.synthetic.empty()) {
+            if (options.compare && options.synthetic.size() != 2) {
+                std::cerr << "Error: --compare needs exactly two devices" << std::endl;
+                return 1;
+            }
+            std::vector<SyntheticConfig> configs(options.synthetic.size());
+            for (size_t i = 0; i < configs.size(); ++i) {
+                if (!parseSyntheticSpec(options.synthetic[i], configs[i])) {
+                    printUsage(argv[0]);
+                    return 1;
+                }
+            }
+            captureSynthetic(configs, options);
+            return 0;
+        }
+
+        if (!options.replay.empty()) {
+            ReplayPacing pacing;
+            double speed;
+            if (!parseReplaySpeed(options.replay, pacing, speed)) {
+                printUsage(argv[0]);
+                return 1;
+            }
+            const auto exporter = createExporter(options, true);
+            devices.setExporter(exporter.get());
+            replayCapture(options, pacing, speed, devices);
+            devices.update();
+            finishExport(exporter.get(), devices, options);
+        } else if (!options.input.empty() && options.input != "-" && CaptureFormat::isCaptureFile(options.input)) {
+            // Offline input is ingested directly; the device has no capture thread
+            const auto exporter = createExporter(options, true);
+            analyseCapture(options.input, exporter.get(), devices.add(options.input, nullptr).metrics);
+            devices.update();
+            finishExport(exporter.get(), devices, options);
+        } else if (!options.input.empty()) {
+#ifdef __linux__
+            const int fd = options.input == "-" ? STDIN_FILENO : ::open(options.input.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                std::cerr << "Error: cannot open " << options.input << ": " << std::strerror(errno) << std::endl;
+                return 1;
+            }
+            std::unique_ptr<CaptureWriter> writer;
+            if (!options.record.empty()) writer = std::make_unique<CaptureWriter>(options.record);
+
+            const auto exporter = createExporter(options, true);
+
+            EvdevInputSource source(fd);
+            const bool analysed = analyseRecording(source, writer.get(), exporter.get(),
+                                                   devices.add(options.input, nullptr).metrics);
+            if (fd != STDIN_FILENO) ::close(fd);
+            if (!analysed) {
+                std::cerr << "Error: cannot read " << options.input << std::endl;
+                return 1;
+            }
+            devices.update();
+            finishExport(exporter.get(), devices, options);
+#else
+            std::cerr << "Error: raw evdev --input is only supported on Linux" << std::endl;
+            return 1;
+#endif
+        } else {
+            for (const auto& device : options.devices) {
+                if (device == "all") {
+                    devices.addLiveDevices();
+                    continue;
+                }
+#ifdef __linux__
+                const auto deviceId = static_cast<std::uint16_t>(devices.size());
+                devices.add(device, std::make_unique<EvdevInputSource>(device, deviceId));
+#else
+                std::cerr << "Error: --device is only supported on Linux" << std::endl;
+                return 1;
+#endif
+            }
+            if (options.devices.empty()) {
+                if (auto source = createDefaultInputSource()) devices.add("Mouse", std::move(source));
+            }
+            if (devices.empty()) {
+                std::cerr << "Error: no mouse input device available" << std::endl;
+                return 1;
+            }
+            if (options.compare && devices.size() != 2) {
+                std::cerr << "Error: --compare needs exactly two devices, found " << devices.size() << std::endl;
+                return 1;
+            }
+            const auto exporter = createExporter(options, false);
+            devices.setExporter(exporter.get());
+            captureLive(devices, options);
+            devices.update();
+            finishExport(exporter.get(), devices, options);
+        }
+
+        devices.update();
+        if (options.compare) {
+            writeComparison(comparedSession(devices[0].name, devices[0].metrics),
+                            comparedSession(devices[1].name, devices[1].metrics), options);
+        } else {
+            writeDeviceReport(std::cout, devices, options.format, options.distribution);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
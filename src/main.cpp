@@ -1,17 +1,160 @@
 #include "MouseBenchmark.hpp"
+#ifdef __linux__
+#include "EvdevInputSource.hpp"
+#endif
+#include "Report.hpp"
+#include "MetricsEndpoint.hpp"
+#include "MetricsPublisher.hpp"
+#include "ReplayInputSource.hpp"
+#include "SampleExporter.hpp"
+#include "SyntheticInputSource.hpp"
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <string>
+#include <vector>
+#ifdef _WIN32
 #include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
 
-int main() {
+int main(int argc, char* argv[]) {
+    // MouseBenchmark [--replay FILE [--speed realtime|max|FACTOR] | --synthetic SPEC | --device PATH|all ...]
+    //                [--fps RATE] [--export FILE [--export-format csv|jsonl|columnar]]
+    //                [--publish NAME] [--metrics-port PORT] [--trace FILE]
+    std::vector<std::string> devicePaths;
+    std::string replayPath;
+    std::string syntheticSpec;
+    std::string replaySpeed = "realtime";
+    std::string exportPath;
+    std::string exportFormatName = "csv";
+    std::string publishName;
+    int metricsPort = 0;
+    std::string tracePath;
+    double frameRate = Config::TARGET_FRAME_RATE;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string arg = argv[i];
+        if (arg == "--replay") replayPath = argv[i + 1];
+        else if (arg == "--speed") replaySpeed = argv[i + 1];
+        else if (arg == "--synthetic") syntheticSpec = argv[i + 1];
+        else if (arg == "--device") devicePaths.push_back(argv[i + 1]);
+        else if (arg == "--fps") frameRate = std::atof(argv[i + 1]);
+        else if (arg == "--export") exportPath = argv[i + 1];
+        else if (arg == "--export-format") exportFormatName = argv[i + 1];
+        else if (arg == "--publish") publishName = argv[i + 1];
+        else if (arg == "--metrics-port") metricsPort = std::atoi(argv[i + 1]);
+        else if (arg == "--trace") tracePath = argv[i + 1];
+    }
+
+    ExportFormat exportFormat;
+    if (!parseExportFormat(exportFormatName, exportFormat)) {
+        std::cerr << "Error: invalid export format " << exportFormatName << std::endl;
+        return 1;
+    }
+
+#ifdef _WIN32
     // Set high priority for more accurate measurements
     SetPriorityClass(GetCurrentProcess(), HIGH_PRIORITY_CLASS);
     
     // Disable Windows DPI scaling
     SetProcessDPIAware();
+#else
+    // Best effort; raising priority needs CAP_SYS_NICE
+    setpriority(PRIO_PROCESS, 0, -10);
+#endif
     
-    try {
-        MouseBenchmark benchmark;
+    // Streams the session from a background writer; flushed once the window closes
+    std::unique_ptr<SampleExporter> exporter;
+    // Live statistics for external monitors, optionally also over HTTP
+    std::unique_ptr<MetricsPublisher> publisher;
+    std::unique_ptr<MetricsEndpoint> endpoint;
+    auto runBenchmark = [&](MouseBenchmark& benchmark) {
+        benchmark.setExporter(exporter.get());
+        benchmark.setPublisher(publisher.get());
+        if (!tracePath.empty()) benchmark.getTrace().retainSpans(Config::TRACE_RETAINED_SPANS);
         benchmark.run();
+        benchmark.setPublisher(nullptr);
+
+        // Evidence that rendering stayed out of the way of the measurements
+        benchmark.writeFrameStats(std::cout);
+        benchmark.writeReactionStats(std::cout);
+        benchmark.getTrace().collect();
+        benchmark.getTrace().writeSummary(std::cout);
+        if (!tracePath.empty()) {
+            std::ofstream traceFile(tracePath);
+            benchmark.getTrace().writeChromeTrace(traceFile);
+            std::cout << "Wrote pipeline trace to " << tracePath << '\n';
+        }
+
+        if (!exporter) return;
+        benchmark.setExporter(nullptr);
+        exporter->close();
+        const ExportStats stats = exporter->getStats();
+        std::cout << "Exported " << stats.eventsWritten << " events to " << exportPath << " ("
+                  << stats.eventsDropped << " dropped, queue high water " << stats.queueHighWater << ")\n";
+        std::ofstream summary(exportPath + ".summary.json");
+        writeDeviceReport(summary, benchmark.getDevices(), ReportFormat::Json);
+    };
+
+    try {
+        if (!exportPath.empty()) exporter = std::make_unique<SampleExporter>(exportPath, exportFormat);
+        if (metricsPort > 0 && publishName.empty()) publishName = LiveMetricsFormat::DEFAULT_NAME;
+        if (!publishName.empty()) publisher = std::make_unique<MetricsPublisher>(publishName);
+        if (metricsPort > 0) {
+            if (metricsPort > 65535) {
+                std::cerr << "Error: invalid metrics port " << metricsPort << std::endl;
+                return 1;
+            }
+            endpoint = std::make_unique<MetricsEndpoint>(publishName, static_cast<std::uint16_t>(metricsPort));
+        }
+
+        if (!devicePaths.empty()) {
+            DeviceGroup devices;
+            for (const auto& path : devicePaths) {
+                if (path == "all") {
+                    devices.addLiveDevices();
+                    continue;
+                }
+#ifdef __linux__
+                devices.add(path, std::make_unique<EvdevInputSource>(path, static_cast<std::uint16_t>(devices.size())));
+#else
+                std::cerr << "Error: --device is only supported on Linux" << std::endl;
+                return 1;
+#endif
+            }
+            if (devices.empty()) {
+                std::cerr << "Error: no mouse input device available" << std::endl;
+                return 1;
+            }
+
+            MouseBenchmark benchmark(std::move(devices), frameRate);
+            runBenchmark(benchmark);
+            return 0;
+        }
+
+        std::unique_ptr<InputSource> source;
+        if (!replayPath.empty()) {
+            ReplayPacing pacing;
+            double speed;
+            if (!parseReplaySpeed(replaySpeed, pacing, speed)) {
+                std::cerr << "Error: invalid replay speed " << replaySpeed << std::endl;
+                return 1;
+            }
+            source = std::make_unique<ReplayInputSource>(replayPath, pacing, speed);
+        } else if (!syntheticSpec.empty()) {
+            SyntheticConfig config;
+            if (!parseSyntheticSpec(syntheticSpec, config)) {
+                std::cerr << "Error: invalid synthetic source " << syntheticSpec << std::endl;
+                return 1;
+            }
+            source = std::make_unique<SyntheticInputSource>(config);
+        } else {
+            source = createDefaultInputSource();
+        }
+
+        MouseBenchmark benchmark(std::move(source), frameRate);
+        runBenchmark(benchmark);
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
         return 1;
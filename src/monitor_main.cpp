@@ -0,0 +1,186 @@
+#include "LiveMetrics.hpp"
+#include "MetricsEndpoint.hpp"
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+
+namespace {
+    volatile std::sig_atomic_t stopRequested = 0;
+
+    void handleSignal(int) {
+        stopRequested = 1;
+    }
+
+    enum class OutputFormat {
+        Text,
+        Json,
+        Prometheus
+    };
+
+    struct Options {
+        std::string name{LiveMetricsFormat::DEFAULT_NAME};
+        double rate{1000.0};
+        std::uint64_t count{0};
+        double duration{0.0};
+        std::optional<OutputFormat> format;
+        int port{0};
+    };
+
+    void printUsage(const char* program) {
+        std::cerr << "Usage: " << program << " [options]\n\n"
+                  << "Reads the live metrics a running MouseBenchmark or mousebench_cli publishes\n"
+                  << "with --publish, printing each new snapshot.\n\n"
+                  << "  --name NAME       Shared-memory segment (default: " << LiveMetricsFormat::DEFAULT_NAME << ")\n"
+                  << "  --rate HZ         Polls per second (default: 1000; 0 polls flat out)\n"
+                  << "  --count N         Stop after N snapshots\n"
+                  << "  --duration SECS   Stop after SECS seconds (default: until Ctrl+C)\n"
+                  << "  --format FORMAT   text, json (one object per line) or prometheus (default: text)\n"
+                  << "  --serve PORT      Serve Prometheus text on http://127.0.0.1:PORT/metrics; prints\n"
+                  << "                    nothing unless --format is also given\n";
+    }
+
+    bool parseOptions(int argc, char* argv[], Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            const bool hasValue = i + 1 < argc;
+
+            if (arg == "--name" && hasValue) {
+                options.name = argv[++i];
+            } else if (arg == "--rate" && hasValue) {
+                options.rate = std::stod(argv[++i]);
+            } else if (arg == "--count" && hasValue) {
+                options.count = std::stoull(argv[++i]);
+            } else if (arg == "--duration" && hasValue) {
+                options.duration = std::stod(argv[++i]);
+            } else if (arg == "--format" && hasValue) {
+                const std::string format = argv[++i];
+                if (format == "text") options.format = OutputFormat::Text;
+                else if (format == "json") options.format = OutputFormat::Json;
+                else if (format == "prometheus") options.format = OutputFormat::Prometheus;
+                else return false;
+            } else if (arg == "--serve" && hasValue) {
+                options.port = std::stoi(argv[++i]);
+                if (options.port <= 0 || options.port > 65535) return false;
+            } else {
+                return false;
+            }
+        }
+        return options.rate >= 0.0;
+    }
+
+    void writeText(std::ostream& out, const LiveMetricsFormat::Snapshot& snapshot) {
+        out << '#' << snapshot.publishCount;
+        for (size_t i = 0; i < snapshot.deviceCount; ++i) {
+            const LiveMetricsFormat::Device& device = snapshot.devices[i];
+            out << "  " << device.name << ": " << device.pollingAverageHz << " Hz (nominal " << device.nominalHz
+                << "), interval P99 " << device.intervalUs.p99 << " us, worst " << device.worstIntervalUs
+                << " us, missed " << device.missedFraction * 100.0 << " %, latency " << device.latencyAverageMs
+                << " ms, clicks " << device.clicks;
+        }
+        out << '\n';
+    }
+
+    void writeJson(std::ostream& out, const LiveMetricsFormat::Snapshot& snapshot) {
+        out << "{\"published_unix_ns\": " << snapshot.publishedUnixNs
+            << ", \"publish_count\": " << snapshot.publishCount << ", \"devices\": [";
+        for (size_t i = 0; i < snapshot.deviceCount; ++i) {
+            const LiveMetricsFormat::Device& device = snapshot.devices[i];
+            // Names come from device paths and labels, so no escaping is needed
+            out << (i ? ", " : "") << "{\"name\": \"" << device.name << '"'
+                << ", \"intervals\": " << device.intervals
+                << ", \"polling_hz\": " << device.pollingAverageHz
+                << ", \"nominal_hz\": " << device.nominalHz
+                << ", \"fitted_hz\": " << device.fittedHz
+                << ", \"missed_fraction\": " << device.missedFraction
+                << ", \"duplicate_fraction\": " << device.duplicateFraction
+                << ", \"jitter_us\": " << device.jitterUs
+                << ", \"interval_p99_us\": " << device.intervalUs.p99
+                << ", \"worst_interval_us\": " << device.worstIntervalUs
+                << ", \"latency_ms\": " << device.latencyAverageMs
+                << ", \"latency_p99_us\": " << device.latencyUs.p99
+                << ", \"clicks\": " << device.clicks
+                << ", \"chatter\": " << device.chatter
+                << ", \"double_click_faults\": " << device.doubleClicks
+                << ", \"dropped_events\": " << device.droppedEvents << '}';
+        }
+        out << "]}\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        if (!parseOptions(argc, argv, options)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+    } catch (const std::exception&) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
+
+    try {
+        MetricsReader reader(options.name);
+        std::unique_ptr<MetricsEndpoint> endpoint;
+        if (options.port > 0) {
+            endpoint = std::make_unique<MetricsEndpoint>(options.name, static_cast<std::uint16_t>(options.port));
+            std::cerr << "Serving http://127.0.0.1:" << options.port << "/metrics\n";
+        }
+        const bool print = options.format.has_value() || !endpoint;
+        const OutputFormat format = options.format.value_or(OutputFormat::Text);
+
+        using SteadyClock = std::chrono::steady_clock;
+        const auto start = SteadyClock::now();
+        const auto period = std::chrono::duration_cast<SteadyClock::duration>(
+            std::chrono::duration<double>(options.rate > 0.0 ? 1.0 / options.rate : 0.0));
+        auto next = start;
+
+        LiveMetricsFormat::Snapshot snapshot;
+        std::uint64_t lastPublish = 0;
+        std::uint64_t snapshots = 0;
+        std::uint64_t busy = 0;
+        while (!stopRequested && (options.count == 0 || snapshots < options.count)) {
+            if (options.duration > 0.0 &&
+                std::chrono::duration<double>(SteadyClock::now() - start).count() >= options.duration) {
+                break;
+            }
+
+            if (!reader.read(snapshot)) {
+                ++busy;
+            } else if (snapshot.publishCount != lastPublish) {
+                lastPublish = snapshot.publishCount;
+                ++snapshots;
+                if (print) {
+                    switch (format) {
+                        case OutputFormat::Text:       writeText(std::cout, snapshot); break;
+                        case OutputFormat::Json:       writeJson(std::cout, snapshot); break;
+                        case OutputFormat::Prometheus: std::cout << formatPrometheus(snapshot) << '\n'; break;
+                    }
+                    std::cout.flush();
+                }
+            }
+
+            if (options.rate > 0.0) {
+                next += period;
+                std::this_thread::sleep_until(next);
+            }
+        }
+
+        const double seconds = std::chrono::duration<double>(SteadyClock::now() - start).count();
+        std::cerr << "Polled " << reader.getReads() << " times in " << seconds << " s ("
+                  << (seconds > 0.0 ? reader.getReads() / seconds : 0.0) << " Hz): " << snapshots
+                  << " new snapshots, " << reader.getRetries() << " retries, " << busy << " busy\n";
+        if (endpoint) std::cerr << "Served " << endpoint->getRequests() << " requests\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}